@@ -0,0 +1,142 @@
+/**
+ * arena.c - 区域内存分配器实现
+ *
+ * 分配只移动当前块的使用位置；当前块放不下时申请新块，超过默认块大小的
+ * 请求单独占用一块。释放时沿链表释放所有块。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+/* 数据区起始偏移：块首部大小向上对齐 */
+#define ARENA_HEADER_SIZE \
+    ((sizeof(ArenaBlock) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+/**
+ * 初始化区域分配器（不预先申请内存）
+ * @param arena 区域分配器指针
+ */
+void arena_init(Arena *arena) {
+    arena->head = NULL;
+    arena->total = 0;
+}
+
+/**
+ * 申请一个新内存块并作为当前块
+ * @param arena 区域分配器指针
+ * @param min_size 数据区最小大小
+ */
+static void arena_add_block(Arena *arena, size_t min_size) {
+    size_t size = min_size > ARENA_BLOCK_SIZE ? min_size : ARENA_BLOCK_SIZE;
+    ArenaBlock *block = (ArenaBlock *)malloc(ARENA_HEADER_SIZE + size);
+    if (!block) {
+        fprintf(stderr, "内存分配失败: arena_alloc\n");
+        exit(1);
+    }
+    
+    block->next = arena->head;
+    block->size = size;
+    block->used = 0;
+    arena->head = block;
+}
+
+/**
+ * 从区域中分配内存，返回的地址按ARENA_ALIGNMENT对齐
+ * @param arena 区域分配器指针
+ * @param size 字节数
+ * @return 内存地址（随区域一起释放，不能单独释放）
+ */
+void *arena_alloc(Arena *arena, size_t size) {
+    size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    
+    ArenaBlock *block = arena->head;
+    if (!block || block->size - block->used < size) {
+        arena_add_block(arena, size);
+        block = arena->head;
+    }
+    
+    void *result = (char *)block + ARENA_HEADER_SIZE + block->used;
+    block->used += size;
+    arena->total += size;
+    return result;
+}
+
+/**
+ * 在区域中复制字符串
+ * @param arena 区域分配器指针
+ * @param str 字符串（无需以'\0'结尾）
+ * @param length 复制的长度
+ * @return 以'\0'结尾的副本
+ */
+char *arena_strndup(Arena *arena, const char *str, size_t length) {
+    char *copy = (char *)arena_alloc(arena, length + 1);
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+/**
+ * 释放区域中的所有对象，但保留最早的一个默认大小内存块供后续复用
+ * @param arena 区域分配器指针
+ */
+void arena_reset(Arena *arena) {
+    ArenaBlock *keep = NULL;
+    ArenaBlock *block = arena->head;
+    while (block) {
+        ArenaBlock *next = block->next;
+        if (!next && block->size == ARENA_BLOCK_SIZE) {
+            keep = block;
+        } else {
+            free(block);
+        }
+        block = next;
+    }
+    
+    if (keep) {
+        keep->used = 0;
+        keep->next = NULL;
+    }
+    arena->head = keep;
+    arena->total = 0;
+}
+
+/**
+ * 释放区域的全部内存块
+ * @param arena 区域分配器指针
+ */
+void arena_free(Arena *arena) {
+    ArenaBlock *block = arena->head;
+    while (block) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->head = NULL;
+    arena->total = 0;
+}
+
+/**
+ * 把一个区域中的全部内存块移交给另一个区域，之后两者一起释放
+ * 移入的块接在目标区域最早的块之后，目标区域继续从原来的当前块分配
+ * @param dst 目标区域
+ * @param src 被合并的区域（合并后为空）
+ */
+void arena_merge(Arena *dst, Arena *src) {
+    if (!src->head) {
+        return;
+    }
+    if (!dst->head) {
+        dst->head = src->head;
+    } else {
+        ArenaBlock *tail = dst->head;
+        while (tail->next) {
+            tail = tail->next;
+        }
+        tail->next = src->head;
+    }
+    dst->total += src->total;
+    src->head = NULL;
+    src->total = 0;
+}
@@ -0,0 +1,37 @@
+/**
+ * arena.h - 区域内存分配器头文件
+ *
+ * 从大块内存中顺序切分小对象，不支持单独释放，所有对象随区域一次性释放。
+ * 用于词法分析器的Token和错误信息等生命周期相同的数据。
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_BLOCK_SIZE (64 * 1024)    // 默认内存块大小
+#define ARENA_ALIGNMENT 16              // 分配对齐字节数
+
+/* 内存块：块首部之后紧跟可分配的数据区 */
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;    // 上一个（更早分配的）内存块
+    size_t size;                // 数据区大小
+    size_t used;                // 已使用的字节数
+} ArenaBlock;
+
+/* 区域分配器 */
+typedef struct {
+    ArenaBlock *head;           // 当前内存块（链表头）
+    size_t total;               // 已分配出去的字节数（仅供统计）
+} Arena;
+
+/* 区域分配器函数 */
+void arena_init(Arena *arena);
+void *arena_alloc(Arena *arena, size_t size);
+char *arena_strndup(Arena *arena, const char *str, size_t length);
+void arena_reset(Arena *arena);
+void arena_free(Arena *arena);
+void arena_merge(Arena *dst, Arena *src);
+
+#endif /* ARENA_H */
@@ -0,0 +1,423 @@
+/**
+ * ast.c - 抽象语法树实现
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ast.h"
+
+/**
+ * 初始化空的语法树
+ * @param ast 语法树
+ * @param tokens 语法树引用的Token流
+ * @param expected_nodes 预计的节点数量（各数组的初始容量）
+ */
+void ast_init(Ast *ast, TokenStream *tokens, int expected_nodes) {
+    memset(ast, 0, sizeof(Ast));
+    ast->tokens = tokens;
+    ast->root = AST_NONE;
+    ast->capacity = expected_nodes > 16 ? expected_nodes : 16;
+    ast->kinds = (uint8_t *)malloc(ast->capacity * sizeof(uint8_t));
+    ast->main_tokens = (int32_t *)malloc(ast->capacity * sizeof(int32_t));
+    ast->lhs = (int32_t *)malloc(ast->capacity * sizeof(int32_t));
+    ast->rhs = (int32_t *)malloc(ast->capacity * sizeof(int32_t));
+    ast->extra_capacity = ast->capacity / 2;
+    ast->extra = (int32_t *)malloc(ast->extra_capacity * sizeof(int32_t));
+    if (!ast->kinds || !ast->main_tokens || !ast->lhs || !ast->rhs || !ast->extra) {
+        fprintf(stderr, "内存分配失败: ast_init\n");
+        exit(1);
+    }
+    arena_init(&ast->arena);
+}
+
+/**
+ * 添加一个节点
+ * @param ast 语法树
+ * @param kind 节点类型
+ * @param token 主Token的下标
+ * @param lhs 数据域
+ * @param rhs 数据域
+ * @return 节点下标
+ */
+int ast_add_node(Ast *ast, AstKind kind, int token, int lhs, int rhs) {
+    if (ast->count == ast->capacity) {
+        ast->capacity *= 2;
+        ast->kinds = (uint8_t *)realloc(ast->kinds, ast->capacity * sizeof(uint8_t));
+        ast->main_tokens = (int32_t *)realloc(ast->main_tokens, ast->capacity * sizeof(int32_t));
+        ast->lhs = (int32_t *)realloc(ast->lhs, ast->capacity * sizeof(int32_t));
+        ast->rhs = (int32_t *)realloc(ast->rhs, ast->capacity * sizeof(int32_t));
+        if (!ast->kinds || !ast->main_tokens || !ast->lhs || !ast->rhs) {
+            fprintf(stderr, "内存分配失败: ast_add_node\n");
+            exit(1);
+        }
+    }
+    
+    int node = ast->count++;
+    ast->kinds[node] = (uint8_t)kind;
+    ast->main_tokens[node] = token;
+    ast->lhs[node] = lhs;
+    ast->rhs[node] = rhs;
+    return node;
+}
+
+/**
+ * 向extra追加若干项
+ * @param ast 语法树
+ * @param items 各项
+ * @param count 项数
+ * @return 第一项在extra中的下标
+ */
+int ast_add_extra(Ast *ast, const int32_t *items, int count) {
+    if (ast->num_extra + count > ast->extra_capacity) {
+        while (ast->num_extra + count > ast->extra_capacity) {
+            ast->extra_capacity *= 2;
+        }
+        ast->extra = (int32_t *)realloc(ast->extra, ast->extra_capacity * sizeof(int32_t));
+        if (!ast->extra) {
+            fprintf(stderr, "内存分配失败: ast_add_extra\n");
+            exit(1);
+        }
+    }
+    
+    int first = ast->num_extra;
+    if (count > 0) {
+        memcpy(ast->extra + first, items, count * sizeof(int32_t));
+    }
+    ast->num_extra += count;
+    return first;
+}
+
+/**
+ * 向extra追加一个子节点列表（个数在前）
+ * @param ast 语法树
+ * @param items 各子节点下标
+ * @param count 子节点个数
+ * @return 列表下标
+ */
+int ast_add_list(Ast *ast, const int32_t *items, int count) {
+    int32_t header = count;
+    int list = ast_add_extra(ast, &header, 1);
+    ast_add_extra(ast, items, count);
+    return list;
+}
+
+/**
+ * 取列表中的子节点个数
+ * @param ast 语法树
+ * @param list 列表下标
+ * @return 子节点个数
+ */
+int ast_list_count(const Ast *ast, int list) {
+    return ast->extra[list];
+}
+
+/**
+ * 取列表中的各子节点
+ * @param ast 语法树
+ * @param list 列表下标
+ * @return 子节点下标数组（共ast_list_count项）
+ */
+const int32_t *ast_list_items(const Ast *ast, int list) {
+    return ast->extra + list + 1;
+}
+
+/**
+ * 记录一个语法错误
+ * @param ast 语法树
+ * @param token 出错处的Token下标
+ * @param message 错误信息（复制到语法树的区域分配器中）
+ */
+void ast_add_error(Ast *ast, int token, const char *message) {
+    if (ast->num_errors == ast->error_capacity) {
+        ast->error_capacity = ast->error_capacity ? ast->error_capacity * 2 : 16;
+        ast->errors = (AstError *)realloc(ast->errors, ast->error_capacity * sizeof(AstError));
+        if (!ast->errors) {
+            fprintf(stderr, "内存分配失败: ast_add_error\n");
+            exit(1);
+        }
+    }
+    AstError *error = &ast->errors[ast->num_errors++];
+    error->token = token;
+    error->message = arena_strndup(&ast->arena, message, strlen(message));
+}
+
+/**
+ * 将节点类型转换为字符串
+ * @param kind 节点类型
+ * @return 节点类型名称
+ */
+const char *ast_kind_to_string(AstKind kind) {
+    switch (kind) {
+        case AST_PROGRAM:        return "PROGRAM";
+        case AST_STRUCT:         return "STRUCT";
+        case AST_FUNCTION:       return "FUNCTION";
+        case AST_PARAM:          return "PARAM";
+        case AST_VAR_DECL:       return "VAR_DECL";
+        case AST_DECL_LIST:      return "DECL_LIST";
+        case AST_TYPE:           return "TYPE";
+        case AST_BLOCK:          return "BLOCK";
+        case AST_IF:             return "IF";
+        case AST_WHILE:          return "WHILE";
+        case AST_FOR:            return "FOR";
+        case AST_RETURN:         return "RETURN";
+        case AST_BREAK:          return "BREAK";
+        case AST_CONTINUE:       return "CONTINUE";
+        case AST_EXPR_STMT:      return "EXPR_STMT";
+        case AST_EMPTY:          return "EMPTY";
+        case AST_ASSIGN:         return "ASSIGN";
+        case AST_BINARY:         return "BINARY";
+        case AST_UNARY:          return "UNARY";
+        case AST_CALL:           return "CALL";
+        case AST_INDEX:          return "INDEX";
+        case AST_INIT_LIST:      return "INIT_LIST";
+        case AST_IDENTIFIER:     return "IDENTIFIER";
+        case AST_INT_LITERAL:    return "INT_LITERAL";
+        case AST_DOUBLE_LITERAL: return "DOUBLE_LITERAL";
+        case AST_CHAR_LITERAL:   return "CHAR_LITERAL";
+        case AST_STRING_LITERAL: return "STRING_LITERAL";
+        case AST_ERROR:          return "ERROR";
+        default:                 return "UNKNOWN";
+    }
+}
+
+/**
+ * 输出Token的词素
+ * @param out 输出流
+ * @param ast 语法树
+ * @param token Token下标
+ */
+static void print_lexeme(FILE *out, const Ast *ast, int token) {
+    const TokenStream *tokens = ast->tokens;
+    fprintf(out, "%.*s", (int)tokens->lengths[token], tokens->source + tokens->offsets[token]);
+}
+
+/* 输出时缩进的最大层数：更深的节点不再加缩进，改为注明层数，输出长度与节点数成正比 */
+#define AST_PRINT_MAX_INDENT 64
+
+/* 待输出的节点 */
+typedef struct {
+    int node;               // 节点下标（AST_NONE时输出占位）
+    int depth;              // 层数
+} PrintItem;
+
+/* 输出语法树用的显式栈：左结合的长表达式（a+a+…）不经递归下降就能形成很深的树 */
+typedef struct {
+    PrintItem *items;
+    int count;
+    int capacity;
+} PrintStack;
+
+/**
+ * 将待输出的节点压栈
+ * @param stack 栈
+ * @param node 节点下标
+ * @param depth 层数
+ */
+static void print_stack_push(PrintStack *stack, int node, int depth) {
+    if (stack->count == stack->capacity) {
+        stack->capacity = stack->capacity ? stack->capacity * 2 : 64;
+        stack->items = (PrintItem *)realloc(stack->items, stack->capacity * sizeof(PrintItem));
+        if (!stack->items) {
+            fprintf(stderr, "内存分配失败: print_stack_push\n");
+            exit(1);
+        }
+    }
+    stack->items[stack->count].node = node;
+    stack->items[stack->count].depth = depth;
+    stack->count++;
+}
+
+/**
+ * 输出一个节点本身（每层缩进两格，超过AST_PRINT_MAX_INDENT层时注明层数）
+ * @param out 输出流
+ * @param ast 语法树
+ * @param node 节点下标（AST_NONE时输出占位）
+ * @param depth 层数
+ */
+static void print_node(FILE *out, Ast *ast, int node, int depth) {
+    if (depth > AST_PRINT_MAX_INDENT) {
+        fprintf(out, "%*s[%d] ", AST_PRINT_MAX_INDENT * 2, "", depth);
+    } else {
+        fprintf(out, "%*s", depth * 2, "");
+    }
+    if (node == AST_NONE) {
+        fprintf(out, "(无)\n");
+        return;
+    }
+    
+    AstKind kind = (AstKind)ast->kinds[node];
+    int token = ast->main_tokens[node];
+    int lhs = ast->lhs[node];
+    int rhs = ast->rhs[node];
+    fprintf(out, "%s", ast_kind_to_string(kind));
+    
+    switch (kind) {
+        case AST_TYPE:
+            fprintf(out, " %s%s", rhs ? "const " : "",
+                    ast->tokens->types[token] == TOKEN_IDENTIFIER ? "struct " : "");
+            print_lexeme(out, ast, token);
+            if (lhs > 0) {
+                fprintf(out, " ");
+            }
+            for (int i = 0; i < lhs; i++) {
+                fputc('*', out);
+            }
+            break;
+        case AST_PARAM:
+            fprintf(out, " ");
+            print_lexeme(out, ast, token);
+            fprintf(out, "%s", rhs ? "[]" : "");
+            break;
+        case AST_STRUCT:
+        case AST_FUNCTION:
+        case AST_VAR_DECL:
+        case AST_ASSIGN:
+        case AST_BINARY:
+        case AST_UNARY:
+        case AST_IDENTIFIER:
+        case AST_INT_LITERAL:
+        case AST_DOUBLE_LITERAL:
+        case AST_CHAR_LITERAL:
+        case AST_STRING_LITERAL:
+        case AST_ERROR:
+            fprintf(out, " ");
+            print_lexeme(out, ast, token);
+            break;
+        default:
+            break;
+    }
+    
+    int line, column;
+    line_index_position(&ast->tokens->lines, ast->tokens->offsets[token], &line, &column);
+    fprintf(out, " (行: %d, 列: %d)\n", line, column);
+}
+
+/**
+ * 将节点的各子节点逆序压栈，使其按原顺序出栈输出
+ * @param stack 栈
+ * @param ast 语法树
+ * @param node 节点下标（AST_NONE时没有子节点）
+ * @param depth 子节点的层数
+ */
+static void push_children(PrintStack *stack, Ast *ast, int node, int depth) {
+    if (node == AST_NONE) {
+        return;
+    }
+    
+    int lhs = ast->lhs[node];
+    int rhs = ast->rhs[node];
+    switch ((AstKind)ast->kinds[node]) {
+        case AST_PROGRAM:
+        case AST_BLOCK:
+        case AST_DECL_LIST:
+        case AST_STRUCT:
+        case AST_INIT_LIST:
+            for (int i = ast_list_count(ast, lhs) - 1; i >= 0; i--) {
+                print_stack_push(stack, ast_list_items(ast, lhs)[i], depth);
+            }
+            break;
+        case AST_FUNCTION:
+            if (ast->extra[rhs] != AST_NONE) {
+                print_stack_push(stack, ast->extra[rhs], depth);
+            }
+            for (int i = ast_list_count(ast, ast->extra[rhs + 1]) - 1; i >= 0; i--) {
+                print_stack_push(stack, ast_list_items(ast, ast->extra[rhs + 1])[i], depth);
+            }
+            print_stack_push(stack, lhs, depth);
+            break;
+        case AST_PARAM:
+        case AST_RETURN:
+        case AST_EXPR_STMT:
+        case AST_UNARY:
+            if (lhs != AST_NONE) {
+                print_stack_push(stack, lhs, depth);
+            }
+            break;
+        case AST_VAR_DECL:
+            for (int i = 1; i >= 0; i--) {
+                if (ast->extra[rhs + i] != AST_NONE) {
+                    print_stack_push(stack, ast->extra[rhs + i], depth);
+                }
+            }
+            print_stack_push(stack, lhs, depth);
+            break;
+        case AST_IF:
+            if (ast->extra[rhs + 1] != AST_NONE) {
+                print_stack_push(stack, ast->extra[rhs + 1], depth);
+            }
+            print_stack_push(stack, ast->extra[rhs], depth);
+            print_stack_push(stack, lhs, depth);
+            break;
+        case AST_WHILE:
+        case AST_ASSIGN:
+        case AST_BINARY:
+        case AST_INDEX:
+            print_stack_push(stack, rhs, depth);
+            print_stack_push(stack, lhs, depth);
+            break;
+        case AST_FOR:
+            for (int i = 3; i >= 0; i--) {
+                print_stack_push(stack, ast->extra[rhs + i], depth);
+            }
+            break;
+        case AST_CALL:
+            for (int i = ast_list_count(ast, rhs) - 1; i >= 0; i--) {
+                print_stack_push(stack, ast_list_items(ast, rhs)[i], depth);
+            }
+            print_stack_push(stack, lhs, depth);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * 以缩进形式输出整棵语法树
+ * @param out 输出流
+ * @param ast 语法树
+ */
+void ast_print(FILE *out, Ast *ast) {
+    if (ast->root == AST_NONE) {
+        return;
+    }
+    
+    // 深度优先、先序输出；用显式栈代替递归，树再深也不会耗尽调用栈
+    PrintStack stack = { NULL, 0, 0 };
+    print_stack_push(&stack, ast->root, 0);
+    while (stack.count > 0) {
+        PrintItem item = stack.items[--stack.count];
+        print_node(out, ast, item.node, item.depth);
+        push_children(&stack, ast, item.node, item.depth + 1);
+    }
+    free(stack.items);
+}
+
+/**
+ * 输出全部语法错误（附行列号）
+ * @param out 输出流
+ * @param ast 语法树
+ */
+void ast_print_errors(FILE *out, Ast *ast) {
+    for (int i = 0; i < ast->num_errors; i++) {
+        int line, column;
+        line_index_position(&ast->tokens->lines, ast->tokens->offsets[ast->errors[i].token],
+                            &line, &column);
+        fprintf(out, "语法错误: %s (行: %d, 列: %d)\n", ast->errors[i].message, line, column);
+    }
+}
+
+/**
+ * 释放语法树（不释放Token流）
+ * @param ast 语法树
+ */
+void ast_free(Ast *ast) {
+    free(ast->kinds);
+    free(ast->main_tokens);
+    free(ast->lhs);
+    free(ast->rhs);
+    free(ast->extra);
+    free(ast->errors);
+    arena_free(&ast->arena);
+    memset(ast, 0, sizeof(Ast));
+}
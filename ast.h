@@ -0,0 +1,119 @@
+/**
+ * ast.h - 抽象语法树头文件
+ *
+ * 语法树与Token流一样按列存放（struct-of-arrays）：节点是连续数组中的下标，
+ * 每个节点只有类型、主Token和两个32位数据域lhs、rhs，子节点以下标引用，
+ * 不为单个节点分配内存。子节点个数可变的节点（语句块、参数表、实参表等）
+ * 把子节点列表放在extra数组中：extra[list]为个数，其后依次为各子节点的下标。
+ * 名字和常量值不复制，由主Token经Token流取得（Token流必须比语法树存活更久）。
+ *
+ * 各类节点的字段（"列表"指extra中的列表下标，-1表示没有该子节点）：
+ *   PROGRAM     lhs = 顶层声明列表
+ *   STRUCT      token = 结构名，lhs = 成员列表（VAR_DECL或DECL_LIST）
+ *   FUNCTION    token = 函数名，lhs = 返回类型，rhs = extra下标i：
+ *               extra[i]为函数体（原型为-1），extra[i + 1]为参数列表（PARAM）
+ *   PARAM       token = 参数名，lhs = 类型，rhs = 是否为数组参数（1或0）
+ *   VAR_DECL    token = 变量名，lhs = 类型，rhs = extra下标i：
+ *               extra[i]为数组长度表达式，extra[i + 1]为初值（表达式或INIT_LIST）
+ *   DECL_LIST   token = 类型的首个Token，lhs = VAR_DECL列表（一条声明语句声明多个变量时使用）
+ *   TYPE        token = 类型关键字（struct类型为结构名），lhs = 指针层数，rhs = 是否有const
+ *   BLOCK       lhs = 语句列表
+ *   IF          lhs = 条件，rhs = extra下标i：extra[i]为then分支，extra[i + 1]为else分支
+ *   WHILE       lhs = 条件，rhs = 循环体
+ *   FOR         rhs = extra下标i：extra[i]到extra[i + 3]依次为初始化、条件、步进和循环体
+ *   RETURN      lhs = 返回值
+ *   EXPR_STMT   lhs = 表达式
+ *   BREAK、CONTINUE、EMPTY  只有主Token
+ *   ASSIGN      token = '='，lhs = 左值，rhs = 右值
+ *   BINARY      token = 运算符，lhs、rhs = 左右操作数
+ *   UNARY       token = 运算符，lhs = 操作数
+ *   CALL        token = '('，lhs = 被调用的表达式，rhs = 实参列表
+ *   INDEX       token = '['，lhs = 数组表达式，rhs = 下标表达式
+ *   INIT_LIST   token = '{'，lhs = 元素列表
+ *   IDENTIFIER、各类LITERAL  只有主Token
+ *   ERROR       token = 出错处的Token（缺少表达式时的占位）
+ */
+
+#ifndef AST_H
+#define AST_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "arena.h"
+#include "lexer.h"
+
+/* 节点类型 */
+typedef enum {
+    AST_PROGRAM,
+    AST_STRUCT,
+    AST_FUNCTION,
+    AST_PARAM,
+    AST_VAR_DECL,
+    AST_DECL_LIST,
+    AST_TYPE,
+    AST_BLOCK,
+    AST_IF,
+    AST_WHILE,
+    AST_FOR,
+    AST_RETURN,
+    AST_BREAK,
+    AST_CONTINUE,
+    AST_EXPR_STMT,
+    AST_EMPTY,
+    AST_ASSIGN,
+    AST_BINARY,
+    AST_UNARY,
+    AST_CALL,
+    AST_INDEX,
+    AST_INIT_LIST,
+    AST_IDENTIFIER,
+    AST_INT_LITERAL,
+    AST_DOUBLE_LITERAL,
+    AST_CHAR_LITERAL,
+    AST_STRING_LITERAL,
+    AST_ERROR,
+    NUM_AST_KINDS
+} AstKind;
+
+#define AST_NONE (-1)           // 没有该子节点
+
+/* 语法错误 */
+typedef struct {
+    int token;              // 出错处的Token下标
+    const char *message;    // 错误信息
+} AstError;
+
+/* 抽象语法树（按列存放） */
+typedef struct {
+    TokenStream *tokens;    // 语法树引用的Token流
+    int count;              // 节点数量
+    int capacity;           // 各节点数组容量
+    uint8_t *kinds;         // 节点类型
+    int32_t *main_tokens;   // 主Token的下标
+    int32_t *lhs;           // 数据域（含义随节点类型而定，见文件头）
+    int32_t *rhs;           // 数据域
+    int32_t *extra;         // 子节点列表和多于两个的子节点
+    int num_extra;          // extra已用项数
+    int extra_capacity;     // extra容量
+    int root;               // 根节点（PROGRAM），尚未分析时为AST_NONE
+    AstError *errors;       // 语法错误
+    int num_errors;         // 语法错误数量
+    int error_capacity;     // errors容量
+    Arena arena;            // 错误信息所在的区域分配器
+} Ast;
+
+/* 语法树函数 */
+void ast_init(Ast *ast, TokenStream *tokens, int expected_nodes);
+int ast_add_node(Ast *ast, AstKind kind, int token, int lhs, int rhs);
+int ast_add_extra(Ast *ast, const int32_t *items, int count);
+int ast_add_list(Ast *ast, const int32_t *items, int count);
+int ast_list_count(const Ast *ast, int list);
+const int32_t *ast_list_items(const Ast *ast, int list);
+void ast_add_error(Ast *ast, int token, const char *message);
+const char *ast_kind_to_string(AstKind kind);
+void ast_print(FILE *out, Ast *ast);
+void ast_print_errors(FILE *out, Ast *ast);
+void ast_free(Ast *ast);
+
+#endif /* AST_H */
@@ -0,0 +1,541 @@
+/**
+ * bench.c - 词法分析器和自动机基准测试
+ *
+ * 在语料（通常由corpus_gen生成）上测量：
+ *   lex_hand       手写扫描逐个get_next_token
+ *   lex_table      表驱动扫描逐个get_next_token
+ *   lex_direct     直接编码的扫描器逐个get_next_token
+ *   lex_all        批量分析为Token流
+ *   lex_deferred   批量分析为Token流，数值常量延迟转换
+ *   lex_all_direct 批量分析为Token流，最长匹配由直接编码的扫描器完成
+ *   lex_all_lazy   批量分析为Token流，最长匹配由惰性DFA完成（默认预算，缓存在各次运行间保留）
+ *   lex_lazy_small 同上，但预算只有BENCH_LAZY_SMALL_BUDGET字节，缓存不断清空
+ *   read_number    只含数值常量的缓冲区上逐个read_number
+ *   lookup_keyword 语料中全部标识符和关键字的关键字查找
+ *   relex          均匀分布的单字节编辑（改写标识符首字母）后的增量分析
+ *   parse          由语料的Token流构造语法树（项为Token）
+ *   validate_serial 语料中全部标识符和关键字逐个在标识符的最简DFA上校验（dfa_next）
+ *   validate_batch 同上，但由dfa_accept_batch多路交错校验
+ *   state_map      语料逐块求从Token规则最简DFA每个状态出发到达的状态（项为字节）
+ *   nfa_to_dfa     全部Token规则的NFA确定化
+ *   minimize_dfa   上述DFA的最简化
+ * 每项重复运行到累计至少BENCH_MIN_SECONDS秒，取最快的一次，
+ * 报告MB/s、项/s、ns/项和每项的堆分配次数（由链接时包装malloc、calloc、realloc计数）。
+ *
+ * 结果以制表符分隔追加到结果文件，每行为：
+ *   标签  日期  测试项  MB/s  项/s  ns/项  分配/项
+ * 运行时与结果文件中同一测试项最近一次的ns/项比较，提交之间的变化一目了然。
+ *
+ * 使用方法：
+ *   ./c0bench [-o <results.tsv>] [-l <label>] <corpus.c>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "token.h"
+#include "lexer.h"
+#include "nfa_dfa.h"
+#include "scanner.h"
+#include "lazy_dfa.h"
+#include "dfa_batch.h"
+#include "source_file.h"
+#include "parser.h"
+
+#define BENCH_MIN_SECONDS 0.5   // 每项至少累计运行的时间
+#define BENCH_MIN_RUNS 3        // 每项至少运行的次数
+#define MAX_BENCHES 24          // 测试项数量上限
+#define NUMBER_BUFFER_SIZE (1024 * 1024)    // read_number测试缓冲区大小
+#define BENCH_RELEX_EDITS 256   // relex每次运行的编辑次数
+#define BENCH_LAZY_SMALL_BUDGET 4096 // lex_lazy_small的惰性DFA预算（字节）
+#define BENCH_STATE_MAP_CHUNK (64 * 1024) // state_map每块的字节数
+
+/* 堆分配计数（由-Wl,--wrap=malloc等把调用转到下面的包装函数） */
+static long allocation_count = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    allocation_count++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    allocation_count++;
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    allocation_count++;
+    return __real_realloc(ptr, size);
+}
+
+/* 测试数据 */
+typedef struct {
+    const char *source;     // 语料
+    size_t length;          // 语料长度
+    char *numbers;          // 只含数值常量的缓冲区
+    size_t numbers_length;  // 其长度
+    const char **words;     // 语料中的标识符和关键字
+    size_t *word_lengths;   // 各自的长度
+    long num_words;         // 数量
+    NFA *nfa;               // 全部Token规则的NFA
+    DFA *dfa;               // 其确定化结果
+    DFA *min_dfa;           // 其最简化结果
+    DFA *id_dfa;            // 标识符的最简DFA
+    LazyDFA lazy;           // 由上述NFA按默认预算构造的惰性DFA
+    LazyDFA lazy_small;     // 预算很小的惰性DFA
+    char *edited;           // 语料的可写副本（relex在其上编辑）
+    TokenStream edit_stream; // 可写副本的Token流，随编辑增量更新
+    TokenStream parse_stream; // 语料的Token流（parse使用）
+} BenchData;
+
+/* 测试项：运行一次，返回处理的项数，*bytes为处理的字节数（不适用时为0） */
+typedef long (*BenchFunction)(BenchData *data, size_t *bytes);
+
+/* 一项测试的结果 */
+typedef struct {
+    const char *name;       // 测试项名称
+    double seconds;         // 最快一次的耗时
+    size_t bytes;           // 每次处理的字节数
+    long items;             // 每次处理的项数
+    long allocations;       // 每次的堆分配次数
+} BenchResult;
+
+/* 防止被优化掉的结果 */
+static volatile long bench_sink = 0;
+
+/**
+ * 取单调时钟（秒）
+ */
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * 逐个get_next_token直到EOF
+ * @param use_table 是否使用表驱动扫描
+ * @param direct 表驱动扫描是否使用直接编码的扫描器
+ */
+static long lex_tokens(BenchData *data, size_t *bytes, bool use_table, bool direct) {
+    Lexer *lexer = create_lexer(data->source, data->length);
+    if (direct) {
+        lexer_use_direct(lexer);
+    } else if (use_table) {
+        lexer_use_table(lexer, get_c0_scan_table());
+    }
+    long count = 0;
+    while (get_next_token(lexer)->type != TOKEN_EOF) {
+        count++;
+    }
+    free_lexer(lexer);
+    *bytes = data->length;
+    return count;
+}
+
+static long bench_lex_hand(BenchData *data, size_t *bytes) {
+    return lex_tokens(data, bytes, false, false);
+}
+
+static long bench_lex_table(BenchData *data, size_t *bytes) {
+    return lex_tokens(data, bytes, true, false);
+}
+
+static long bench_lex_direct(BenchData *data, size_t *bytes) {
+    return lex_tokens(data, bytes, true, true);
+}
+
+static long bench_lex_all(BenchData *data, size_t *bytes) {
+    TokenStream stream;
+    lex_all(data->source, data->length, &stream);
+    long count = stream.count - 1;
+    free_token_stream(&stream);
+    *bytes = data->length;
+    return count;
+}
+
+static long bench_lex_deferred(BenchData *data, size_t *bytes) {
+    TokenStream stream;
+    lex_all_deferred(data->source, data->length, &stream);
+    long count = stream.count - 1;
+    free_token_stream(&stream);
+    *bytes = data->length;
+    return count;
+}
+
+static long bench_lex_all_direct(BenchData *data, size_t *bytes) {
+    TokenStream stream;
+    lex_all_direct(data->source, data->length, &stream);
+    long count = stream.count - 1;
+    free_token_stream(&stream);
+    *bytes = data->length;
+    return count;
+}
+
+static long bench_lex_all_lazy(BenchData *data, size_t *bytes) {
+    TokenStream stream;
+    lex_all_lazy(data->source, data->length, &data->lazy, &stream);
+    long count = stream.count - 1;
+    free_token_stream(&stream);
+    *bytes = data->length;
+    return count;
+}
+
+static long bench_lex_lazy_small(BenchData *data, size_t *bytes) {
+    TokenStream stream;
+    lex_all_lazy(data->source, data->length, &data->lazy_small, &stream);
+    long count = stream.count - 1;
+    free_token_stream(&stream);
+    *bytes = data->length;
+    return count;
+}
+
+static long bench_read_number(BenchData *data, size_t *bytes) {
+    Lexer *lexer = create_lexer(data->numbers, data->numbers_length);
+    long count = 0;
+    while (1) {
+        skip_whitespace(lexer);
+        if (lexer->pos >= lexer->length) {
+            break;
+        }
+        bench_sink += read_number(lexer)->type;
+        count++;
+    }
+    free_lexer(lexer);
+    *bytes = data->numbers_length;
+    return count;
+}
+
+static long bench_lookup_keyword(BenchData *data, size_t *bytes) {
+    long keywords = 0;
+    for (long i = 0; i < data->num_words; i++) {
+        keywords += lookup_keyword(data->words[i], data->word_lengths[i]) != TOKEN_IDENTIFIER;
+    }
+    bench_sink += keywords;
+    *bytes = 0;
+    return data->num_words;
+}
+
+static long bench_relex(BenchData *data, size_t *bytes) {
+    TokenStream *stream = &data->edit_stream;
+    long edits = 0;
+    for (int k = 0; k < BENCH_RELEX_EDITS; k++) {
+        int i = (int)((long)stream->count * k / BENCH_RELEX_EDITS);
+        if (stream->types[i] != TOKEN_IDENTIFIER) {
+            continue;
+        }
+        size_t offset = stream->offsets[i];
+        data->edited[offset] = data->edited[offset] == 'z' ? 'y' : 'z';
+        TokenEdit edit = { offset, 1, 1 };
+        token_stream_relex(stream, data->edited, data->length, &edit, NULL);
+        edits++;
+    }
+    *bytes = 0;
+    return edits;
+}
+
+static long bench_parse(BenchData *data, size_t *bytes) {
+    Ast ast;
+    parse_program(&data->parse_stream, &ast);
+    bench_sink += ast.count;
+    ast_free(&ast);
+    *bytes = data->length;
+    return data->parse_stream.count - 1;
+}
+
+static long bench_validate_serial(BenchData *data, size_t *bytes) {
+    const DFA *dfa = data->id_dfa;
+    long valid = 0;
+    for (long i = 0; i < data->num_words; i++) {
+        int state = dfa->start_state;
+        for (size_t j = 0; j < data->word_lengths[i] && state >= 0; j++) {
+            state = dfa_next(dfa, state, (unsigned char)data->words[i][j]);
+        }
+        valid += state >= 0 && dfa->final_states[state];
+    }
+    bench_sink += valid;
+    *bytes = 0;
+    return data->num_words;
+}
+
+static long bench_validate_batch(BenchData *data, size_t *bytes) {
+    bench_sink += dfa_accept_batch(data->id_dfa, (const unsigned char *const *)data->words,
+                                   data->word_lengths, (int)data->num_words, NULL);
+    *bytes = 0;
+    return data->num_words;
+}
+
+static long bench_state_map(BenchData *data, size_t *bytes) {
+    int *map = (int *)malloc(sizeof(int) * data->min_dfa->num_states);
+    if (!map) {
+        fprintf(stderr, "内存分配失败: bench_state_map\n");
+        exit(1);
+    }
+    for (size_t start = 0; start < data->length; start += BENCH_STATE_MAP_CHUNK) {
+        size_t n = data->length - start < BENCH_STATE_MAP_CHUNK ? data->length - start : BENCH_STATE_MAP_CHUNK;
+        dfa_state_map(data->min_dfa, (const unsigned char *)data->source + start, n, map);
+        bench_sink += map[data->min_dfa->start_state];
+    }
+    free(map);
+    *bytes = data->length;
+    return (long)data->length;
+}
+
+static long bench_nfa_to_dfa(BenchData *data, size_t *bytes) {
+    DFA *dfa = nfa_to_dfa(data->nfa);
+    bench_sink += dfa->num_states;
+    free_dfa(dfa);
+    *bytes = 0;
+    return 1;
+}
+
+static long bench_minimize_dfa(BenchData *data, size_t *bytes) {
+    DFA *min_dfa = minimize_dfa(data->dfa);
+    bench_sink += min_dfa->num_states;
+    free_dfa(min_dfa);
+    *bytes = 0;
+    return 1;
+}
+
+/**
+ * 准备测试数据：数值缓冲区、标识符列表和自动机
+ */
+static void bench_data_init(BenchData *data, const char *source, size_t length) {
+    static const char *const NUMBERS[] = {
+        "0", "7", "42", "65535", "1234567", "0xFF", "0x1A2B", "0xDEADBEEF",
+        "3.14159", "0.5", "100.25", "1.23e10", "6.02E23", "1.5e-7", "2.0e+3"
+    };
+    const int num_numbers = (int)(sizeof(NUMBERS) / sizeof(NUMBERS[0]));
+    
+    data->source = source;
+    data->length = length;
+    
+    data->numbers = (char *)malloc(NUMBER_BUFFER_SIZE);
+    if (!data->numbers) {
+        fprintf(stderr, "内存分配失败: bench_data_init\n");
+        exit(1);
+    }
+    size_t pos = 0;
+    for (int i = 0; ; i = (i + 1) % num_numbers) {
+        size_t n = strlen(NUMBERS[i]);
+        if (pos + n + 1 > NUMBER_BUFFER_SIZE) {
+            break;
+        }
+        memcpy(data->numbers + pos, NUMBERS[i], n);
+        pos += n;
+        data->numbers[pos++] = ' ';
+    }
+    data->numbers_length = pos;
+    
+    // 标识符和关键字取自语料的Token流
+    TokenStream stream;
+    lex_all(source, length, &stream);
+    data->words = (const char **)malloc((size_t)stream.count * sizeof(const char *));
+    data->word_lengths = (size_t *)malloc((size_t)stream.count * sizeof(size_t));
+    if (!data->words || !data->word_lengths) {
+        fprintf(stderr, "内存分配失败: bench_data_init\n");
+        exit(1);
+    }
+    data->num_words = 0;
+    for (int i = 0; i < stream.count; i++) {
+        TokenType type = (TokenType)stream.types[i];
+        if (type == TOKEN_IDENTIFIER || type < TOKEN_IDENTIFIER) {
+            data->words[data->num_words] = source + stream.offsets[i];
+            data->word_lengths[data->num_words] = stream.lengths[i];
+            data->num_words++;
+        }
+    }
+    free_token_stream(&stream);
+    
+    data->nfa = create_nfa_for_c0_tokens();
+    data->dfa = nfa_to_dfa(data->nfa);
+    data->min_dfa = minimize_dfa(data->dfa);
+    NFA *id_nfa = create_nfa_for_identifier();
+    DFA *id_dfa = nfa_to_dfa(id_nfa);
+    data->id_dfa = minimize_dfa(id_dfa);
+    free_dfa(id_dfa);
+    free_nfa(id_nfa);
+    lazy_dfa_init(&data->lazy, data->nfa, LAZY_DFA_DEFAULT_BUDGET);
+    lazy_dfa_init(&data->lazy_small, data->nfa, BENCH_LAZY_SMALL_BUDGET);
+    
+    data->edited = (char *)malloc(length + 1);
+    if (!data->edited) {
+        fprintf(stderr, "内存分配失败: bench_data_init\n");
+        exit(1);
+    }
+    memcpy(data->edited, source, length);
+    lex_all(data->edited, length, &data->edit_stream);
+    lex_all(source, length, &data->parse_stream);
+}
+
+/**
+ * 释放测试数据
+ */
+static void bench_data_free(BenchData *data) {
+    free(data->numbers);
+    free(data->words);
+    free(data->word_lengths);
+    free_dfa(data->dfa);
+    free_dfa(data->min_dfa);
+    free_dfa(data->id_dfa);
+    lazy_dfa_free(&data->lazy);
+    lazy_dfa_free(&data->lazy_small);
+    free_nfa(data->nfa);
+    free_token_stream(&data->edit_stream);
+    free_token_stream(&data->parse_stream);
+    free(data->edited);
+}
+
+/**
+ * 运行一项测试
+ * @param result 输出：结果
+ * @param name 测试项名称
+ * @param function 测试函数
+ * @param data 测试数据
+ */
+static void run_bench(BenchResult *result, const char *name, BenchFunction function,
+                      BenchData *data) {
+    result->name = name;
+    result->seconds = 0;
+    double total = 0;
+    for (int run = 0; run < BENCH_MIN_RUNS || total < BENCH_MIN_SECONDS; run++) {
+        long allocations = allocation_count;
+        double start = now_seconds();
+        long items = function(data, &result->bytes);
+        double elapsed = now_seconds() - start;
+        total += elapsed;
+        if (run == 0 || elapsed < result->seconds) {
+            result->seconds = elapsed;
+        }
+        result->items = items;
+        result->allocations = allocation_count - allocations;
+    }
+}
+
+/**
+ * 在结果文件中查找同一测试项最近一次的ns/项
+ * @param filename 结果文件
+ * @param name 测试项名称
+ * @param label 输出：那一次的标签（至少64字节）
+ * @return ns/项，没有记录时返回0
+ */
+static double previous_ns_per_item(const char *filename, const char *name, char *label) {
+    FILE *file = fopen(filename, "r");
+    if (!file) {
+        return 0;
+    }
+    double previous = 0;
+    char line[512];
+    while (fgets(line, sizeof(line), file)) {
+        char line_label[64], date[32], line_name[64];
+        double mbps, rate, ns, allocations;
+        if (sscanf(line, "%63[^\t]\t%31[^\t]\t%63[^\t]\t%lf\t%lf\t%lf\t%lf",
+                   line_label, date, line_name, &mbps, &rate, &ns, &allocations) == 7 &&
+            strcmp(line_name, name) == 0) {
+            previous = ns;
+            strcpy(label, line_label);
+        }
+    }
+    fclose(file);
+    return previous;
+}
+
+/**
+ * 主函数
+ */
+int main(int argc, char *argv[]) {
+    const char *results_file = NULL;
+    const char *label = "unknown";
+    const char *corpus = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            results_file = argv[++i];
+        } else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            label = argv[++i];
+        } else {
+            corpus = argv[i];
+        }
+    }
+    if (!corpus) {
+        fprintf(stderr, "使用方法: %s [-o <results.tsv>] [-l <label>] <corpus.c>\n", argv[0]);
+        return 1;
+    }
+    
+    SourceFile file;
+    if (!source_file_open(&file, corpus)) {
+        return 1;
+    }
+    BenchData data;
+    bench_data_init(&data, file.data, file.length);
+    
+    BenchResult results[MAX_BENCHES];
+    int num_results = 0;
+    run_bench(&results[num_results++], "lex_hand", bench_lex_hand, &data);
+    run_bench(&results[num_results++], "lex_table", bench_lex_table, &data);
+    run_bench(&results[num_results++], "lex_direct", bench_lex_direct, &data);
+    run_bench(&results[num_results++], "lex_all", bench_lex_all, &data);
+    run_bench(&results[num_results++], "lex_deferred", bench_lex_deferred, &data);
+    run_bench(&results[num_results++], "lex_all_direct", bench_lex_all_direct, &data);
+    run_bench(&results[num_results++], "lex_all_lazy", bench_lex_all_lazy, &data);
+    run_bench(&results[num_results++], "lex_lazy_small", bench_lex_lazy_small, &data);
+    run_bench(&results[num_results++], "read_number", bench_read_number, &data);
+    run_bench(&results[num_results++], "lookup_keyword", bench_lookup_keyword, &data);
+    run_bench(&results[num_results++], "relex", bench_relex, &data);
+    run_bench(&results[num_results++], "parse", bench_parse, &data);
+    run_bench(&results[num_results++], "validate_serial", bench_validate_serial, &data);
+    run_bench(&results[num_results++], "validate_batch", bench_validate_batch, &data);
+    run_bench(&results[num_results++], "state_map", bench_state_map, &data);
+    run_bench(&results[num_results++], "nfa_to_dfa", bench_nfa_to_dfa, &data);
+    run_bench(&results[num_results++], "minimize_dfa", bench_minimize_dfa, &data);
+    
+    // 当前日期，作为结果文件中的一列
+    char date[32];
+    time_t now = time(NULL);
+    strftime(date, sizeof(date), "%Y-%m-%d", localtime(&now));
+    
+    FILE *out = results_file ? fopen(results_file, "a") : NULL;
+    if (results_file && !out) {
+        fprintf(stderr, "错误: 无法写入结果文件 '%s'\n", results_file);
+    }
+    
+    printf("语料: %s（%.2f MB）  标签: %s\n\n", corpus, file.length / (1024.0 * 1024.0), label);
+    printf("%-16s %10s %14s %12s %10s  %s\n", "测试项", "MB/s", "项/s", "ns/项", "分配/项", "与上次相比");
+    for (int i = 0; i < num_results; i++) {
+        BenchResult *r = &results[i];
+        double mbps = r->bytes > 0 ? r->bytes / (1024.0 * 1024.0) / r->seconds : 0;
+        double rate = r->items / r->seconds;
+        double ns = r->seconds * 1e9 / r->items;
+        double allocations = (double)r->allocations / r->items;
+        
+        char change[96] = "";
+        char previous_label[64];
+        double previous = results_file ? previous_ns_per_item(results_file, r->name, previous_label) : 0;
+        if (previous > 0) {
+            snprintf(change, sizeof(change), "%+.1f%%（%s）", (ns - previous) / previous * 100, previous_label);
+        }
+        char throughput[32] = "-";
+        if (r->bytes > 0) {
+            snprintf(throughput, sizeof(throughput), "%.1f", mbps);
+        }
+        printf("%-16s %10s %14.0f %12.2f %10.4f  %s\n", r->name, throughput, rate, ns, allocations, change);
+        
+        if (out) {
+            fprintf(out, "%s\t%s\t%s\t%.1f\t%.0f\t%.2f\t%.4f\n", label, date, r->name, mbps, rate, ns, allocations);
+        }
+    }
+    if (out) {
+        fclose(out);
+        printf("\n结果已追加到 %s\n", results_file);
+    }
+    
+    bench_data_free(&data);
+    source_file_close(&file);
+    return 0;
+}
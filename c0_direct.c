@@ -0,0 +1,24 @@
+/**
+ * c0_direct.c - 预生成的直接编码C0扫描器
+ *
+ * c0_direct.h 由 tablegen --direct 根据scanner.c中的规则表生成：
+ * 最简DFA的每个状态是一个标号，按下一字节的等价类switch后goto到目标状态。
+ * 与c0_tables.h的转换表来自同一最简DFA，两者可互换使用。
+ */
+
+#include "scanner.h"
+#include "c0_direct.h"
+
+/**
+ * 从指定位置做最长匹配（直接编码）
+ * @param source 源代码
+ * @param length 源代码长度
+ * @param start 起始位置
+ * @param end 输出：匹配的结束位置
+ * @param stop 输出：扫描停止的位置
+ * @return 识别出的规则编号，或NO_RULE（没有可接受的前缀，或在文件结束处停在非终态）
+ */
+int c0_direct_match(const unsigned char *source, size_t length, size_t start,
+                    size_t *end, size_t *stop) {
+    return c0_direct_scanner(source, length, start, end, stop);
+}
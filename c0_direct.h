@@ -0,0 +1,1390 @@
+/**
+ * 预生成的直接编码扫描器：103 个状态，51 个字节等价类，45 条规则
+ *
+ * 由 tablegen --direct 自动生成，请勿手工修改；
+ * 修改scanner.c中的规则表后执行make即可重新生成
+ */
+
+#ifndef C0_DIRECT_SCANNER_H
+#define C0_DIRECT_SCANNER_H
+
+#include <stddef.h>
+#include "scanner.h"
+
+static const unsigned char c0_direct_scanner_class[256] = {
+    50, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 1, 1, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 3, 4, 0, 0, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    16, 17, 17, 17, 17, 17, 17, 17, 17, 17, 0, 18, 19, 20, 21, 0,
+    0, 22, 22, 22, 22, 23, 22, 24, 24, 24, 24, 24, 24, 24, 24, 24,
+    24, 24, 24, 24, 24, 24, 24, 24, 25, 24, 24, 26, 27, 28, 0, 24,
+    0, 29, 30, 31, 32, 33, 34, 24, 35, 36, 24, 37, 38, 24, 39, 40,
+    24, 24, 41, 42, 43, 44, 45, 46, 25, 24, 24, 47, 48, 49, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+static int c0_direct_scanner(const unsigned char *source, size_t length, size_t start,
+                             size_t *end, size_t *stop) {
+    size_t pos = start;
+    int rule = NO_RULE;
+
+    if (pos == length) goto incomplete;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 0: case 14: case 27: case 50:
+            goto done;
+        case 1: case 2:
+            pos++;
+            goto state_1;
+        case 3:
+            pos++;
+            goto state_2;
+        case 4:
+            pos++;
+            goto state_3;
+        case 5:
+            pos++;
+            goto state_4;
+        case 6:
+            pos++;
+            goto state_5;
+        case 7:
+            pos++;
+            goto state_6;
+        case 8:
+            pos++;
+            goto state_7;
+        case 9:
+            pos++;
+            goto state_8;
+        case 10:
+            pos++;
+            goto state_9;
+        case 11:
+            pos++;
+            goto state_10;
+        case 12:
+            pos++;
+            goto state_11;
+        case 13:
+            pos++;
+            goto state_12;
+        case 15:
+            pos++;
+            goto state_13;
+        case 16:
+            pos++;
+            goto state_14;
+        case 17:
+            pos++;
+            goto state_15;
+        case 18:
+            pos++;
+            goto state_16;
+        case 19:
+            pos++;
+            goto state_17;
+        case 20:
+            pos++;
+            goto state_18;
+        case 21:
+            pos++;
+            goto state_19;
+        case 26:
+            pos++;
+            goto state_21;
+        case 28:
+            pos++;
+            goto state_22;
+        case 30:
+            pos++;
+            goto state_23;
+        case 31:
+            pos++;
+            goto state_24;
+        case 32:
+            pos++;
+            goto state_25;
+        case 33:
+            pos++;
+            goto state_26;
+        case 34:
+            pos++;
+            goto state_27;
+        case 36:
+            pos++;
+            goto state_28;
+        case 41:
+            pos++;
+            goto state_29;
+        case 42:
+            pos++;
+            goto state_30;
+        case 45:
+            pos++;
+            goto state_31;
+        case 46:
+            pos++;
+            goto state_32;
+        case 47:
+            pos++;
+            goto state_33;
+        case 48:
+            pos++;
+            goto state_34;
+        case 49:
+            pos++;
+            goto state_35;
+        default:
+            pos++;
+            goto state_20;
+    }
+
+state_1:
+    rule = 0;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 1: case 2:
+            pos++;
+            goto state_1;
+        default:
+            goto done;
+    }
+
+state_2:
+    rule = 36;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 20:
+            pos++;
+            goto state_102;
+        default:
+            goto done;
+    }
+
+state_3:
+    if (pos == length) goto incomplete;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 4:
+            pos++;
+            goto state_100;
+        case 27:
+            pos++;
+            goto state_101;
+        case 50:
+            goto done;
+        default:
+            pos++;
+            goto state_3;
+    }
+
+state_4:
+    rule = 32;
+    *end = pos;
+    goto done;
+
+state_5:
+    if (pos == length) goto incomplete;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 6:
+            pos++;
+            goto state_99;
+        default:
+            goto done;
+    }
+
+state_6:
+    if (pos == length) goto incomplete;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 7:
+            pos++;
+            goto state_97;
+        case 27:
+            pos++;
+            goto state_98;
+        case 50:
+            goto done;
+        default:
+            pos++;
+            goto state_96;
+    }
+
+state_7:
+    rule = 39;
+    *end = pos;
+    goto done;
+
+state_8:
+    rule = 40;
+    *end = pos;
+    goto done;
+
+state_9:
+    rule = 30;
+    *end = pos;
+    goto done;
+
+state_10:
+    rule = 28;
+    *end = pos;
+    goto done;
+
+state_11:
+    rule = 38;
+    *end = pos;
+    goto done;
+
+state_12:
+    rule = 29;
+    *end = pos;
+    goto done;
+
+state_13:
+    rule = 31;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 10:
+            pos++;
+            goto state_91;
+        case 15:
+            pos++;
+            goto state_92;
+        default:
+            goto done;
+    }
+
+state_14:
+    rule = 17;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 14:
+            pos++;
+            goto state_86;
+        case 16: case 17:
+            pos++;
+            goto state_15;
+        case 23: case 33:
+            pos++;
+            goto state_87;
+        case 25:
+            pos++;
+            goto state_90;
+        default:
+            goto done;
+    }
+
+state_15:
+    rule = 17;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 14:
+            pos++;
+            goto state_86;
+        case 16: case 17:
+            pos++;
+            goto state_15;
+        case 23: case 33:
+            pos++;
+            goto state_87;
+        default:
+            goto done;
+    }
+
+state_16:
+    rule = 37;
+    *end = pos;
+    goto done;
+
+state_17:
+    rule = 34;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 20:
+            pos++;
+            goto state_85;
+        default:
+            goto done;
+    }
+
+state_18:
+    rule = 33;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 20:
+            pos++;
+            goto state_84;
+        default:
+            goto done;
+    }
+
+state_19:
+    rule = 35;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 20:
+            pos++;
+            goto state_83;
+        default:
+            goto done;
+    }
+
+state_20:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        default:
+            goto done;
+    }
+
+state_21:
+    rule = 43;
+    *end = pos;
+    goto done;
+
+state_22:
+    rule = 44;
+    *end = pos;
+    goto done;
+
+state_23:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 41:
+            pos++;
+            goto state_79;
+        default:
+            goto done;
+    }
+
+state_24:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 36: case 37: case 38: case 39: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 35:
+            pos++;
+            goto state_67;
+        case 40:
+            pos++;
+            goto state_68;
+        default:
+            goto done;
+    }
+
+state_25:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 40:
+            pos++;
+            goto state_62;
+        default:
+            goto done;
+    }
+
+state_26:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 38:
+            pos++;
+            goto state_59;
+        default:
+            goto done;
+    }
+
+state_27:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 40:
+            pos++;
+            goto state_57;
+        default:
+            goto done;
+    }
+
+state_28:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 35: case 36: case 37: case 38: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 34:
+            pos++;
+            goto state_54;
+        case 39:
+            pos++;
+            goto state_55;
+        default:
+            goto done;
+    }
+
+state_29:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 33:
+            pos++;
+            goto state_49;
+        default:
+            goto done;
+    }
+
+state_30:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 43:
+            pos++;
+            goto state_44;
+        default:
+            goto done;
+    }
+
+state_31:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 40:
+            pos++;
+            goto state_41;
+        default:
+            goto done;
+    }
+
+state_32:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 35:
+            pos++;
+            goto state_37;
+        default:
+            goto done;
+    }
+
+state_33:
+    rule = 41;
+    *end = pos;
+    goto done;
+
+state_34:
+    if (pos == length) goto incomplete;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 48:
+            pos++;
+            goto state_36;
+        default:
+            goto done;
+    }
+
+state_35:
+    rule = 42;
+    *end = pos;
+    goto done;
+
+state_36:
+    rule = 27;
+    *end = pos;
+    goto done;
+
+state_37:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 36:
+            pos++;
+            goto state_38;
+        default:
+            goto done;
+    }
+
+state_38:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 38:
+            pos++;
+            goto state_39;
+        default:
+            goto done;
+    }
+
+state_39:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 33:
+            pos++;
+            goto state_40;
+        default:
+            goto done;
+    }
+
+state_40:
+    rule = 10;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        default:
+            goto done;
+    }
+
+state_41:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 36:
+            pos++;
+            goto state_42;
+        default:
+            goto done;
+    }
+
+state_42:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 32:
+            pos++;
+            goto state_43;
+        default:
+            goto done;
+    }
+
+state_43:
+    rule = 7;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        default:
+            goto done;
+    }
+
+state_44:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 41:
+            pos++;
+            goto state_45;
+        default:
+            goto done;
+    }
+
+state_45:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 44:
+            pos++;
+            goto state_46;
+        default:
+            goto done;
+    }
+
+state_46:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 31:
+            pos++;
+            goto state_47;
+        default:
+            goto done;
+    }
+
+state_47:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 43:
+            pos++;
+            goto state_48;
+        default:
+            goto done;
+    }
+
+state_48:
+    rule = 15;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        default:
+            goto done;
+    }
+
+state_49:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 43:
+            pos++;
+            goto state_50;
+        default:
+            goto done;
+    }
+
+state_50:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 44:
+            pos++;
+            goto state_51;
+        default:
+            goto done;
+    }
+
+state_51:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 41:
+            pos++;
+            goto state_52;
+        default:
+            goto done;
+    }
+
+state_52:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 39:
+            pos++;
+            goto state_53;
+        default:
+            goto done;
+    }
+
+state_53:
+    rule = 12;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        default:
+            goto done;
+    }
+
+state_54:
+    rule = 8;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        default:
+            goto done;
+    }
+
+state_55:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 43:
+            pos++;
+            goto state_56;
+        default:
+            goto done;
+    }
+
+state_56:
+    rule = 4;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        default:
+            goto done;
+    }
+
+state_57:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 41:
+            pos++;
+            goto state_58;
+        default:
+            goto done;
+    }
+
+state_58:
+    rule = 11;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        default:
+            goto done;
+    }
+
+state_59:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 42:
+            pos++;
+            goto state_60;
+        default:
+            goto done;
+    }
+
+state_60:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 33:
+            pos++;
+            goto state_61;
+        default:
+            goto done;
+    }
+
+state_61:
+    rule = 9;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        default:
+            goto done;
+    }
+
+state_62:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 44:
+            pos++;
+            goto state_63;
+        default:
+            goto done;
+    }
+
+state_63:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 30:
+            pos++;
+            goto state_64;
+        default:
+            goto done;
+    }
+
+state_64:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 38:
+            pos++;
+            goto state_65;
+        default:
+            goto done;
+    }
+
+state_65:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 33:
+            pos++;
+            goto state_66;
+        default:
+            goto done;
+    }
+
+state_66:
+    rule = 5;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        default:
+            goto done;
+    }
+
+state_67:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 29:
+            pos++;
+            goto state_77;
+        default:
+            goto done;
+    }
+
+state_68:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 39:
+            pos++;
+            goto state_69;
+        default:
+            goto done;
+    }
+
+state_69:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 42:
+            pos++;
+            goto state_70;
+        case 43:
+            pos++;
+            goto state_71;
+        default:
+            goto done;
+    }
+
+state_70:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 43:
+            pos++;
+            goto state_76;
+        default:
+            goto done;
+    }
+
+state_71:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 36:
+            pos++;
+            goto state_72;
+        default:
+            goto done;
+    }
+
+state_72:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 39:
+            pos++;
+            goto state_73;
+        default:
+            goto done;
+    }
+
+state_73:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 44:
+            pos++;
+            goto state_74;
+        default:
+            goto done;
+    }
+
+state_74:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 33:
+            pos++;
+            goto state_75;
+        default:
+            goto done;
+    }
+
+state_75:
+    rule = 14;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        default:
+            goto done;
+    }
+
+state_76:
+    rule = 3;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        default:
+            goto done;
+    }
+
+state_77:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 41:
+            pos++;
+            goto state_78;
+        default:
+            goto done;
+    }
+
+state_78:
+    rule = 6;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        default:
+            goto done;
+    }
+
+state_79:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 33:
+            pos++;
+            goto state_80;
+        default:
+            goto done;
+    }
+
+state_80:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 29:
+            pos++;
+            goto state_81;
+        default:
+            goto done;
+    }
+
+state_81:
+    rule = 16;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        case 37:
+            pos++;
+            goto state_82;
+        default:
+            goto done;
+    }
+
+state_82:
+    rule = 13;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 24: case 25: case 29: case 30: case 31: case 32: case 33: case 34: case 35: case 36: case 37: case 38: case 39: case 40: case 41: case 42: case 43: case 44: case 45: case 46:
+            pos++;
+            goto state_20;
+        default:
+            goto done;
+    }
+
+state_83:
+    rule = 25;
+    *end = pos;
+    goto done;
+
+state_84:
+    rule = 22;
+    *end = pos;
+    goto done;
+
+state_85:
+    rule = 24;
+    *end = pos;
+    goto done;
+
+state_86:
+    if (pos == length) goto incomplete;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17:
+            pos++;
+            goto state_89;
+        default:
+            goto done;
+    }
+
+state_87:
+    rule = 19;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 11: case 13: case 16: case 17:
+            pos++;
+            goto state_88;
+        default:
+            goto done;
+    }
+
+state_88:
+    rule = 19;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17:
+            pos++;
+            goto state_88;
+        default:
+            goto done;
+    }
+
+state_89:
+    rule = 19;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17:
+            pos++;
+            goto state_89;
+        case 23: case 33:
+            pos++;
+            goto state_87;
+        default:
+            goto done;
+    }
+
+state_90:
+    rule = 18;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 16: case 17: case 22: case 23: case 29: case 30: case 31: case 32: case 33: case 34:
+            pos++;
+            goto state_90;
+        default:
+            goto done;
+    }
+
+state_91:
+    if (pos == length) goto incomplete;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 10:
+            pos++;
+            goto state_94;
+        case 50:
+            goto done;
+        default:
+            pos++;
+            goto state_91;
+    }
+
+state_92:
+    rule = 1;
+    *end = pos;
+    if (pos == length) goto done;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 2:
+            pos++;
+            goto state_93;
+        case 50:
+            goto done;
+        default:
+            pos++;
+            goto state_92;
+    }
+
+state_93:
+    rule = 1;
+    *end = pos;
+    goto done;
+
+state_94:
+    if (pos == length) goto incomplete;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 10:
+            pos++;
+            goto state_94;
+        case 15:
+            pos++;
+            goto state_95;
+        case 50:
+            goto done;
+        default:
+            pos++;
+            goto state_91;
+    }
+
+state_95:
+    rule = 2;
+    *end = pos;
+    goto done;
+
+state_96:
+    if (pos == length) goto incomplete;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 7:
+            pos++;
+            goto state_97;
+        default:
+            goto done;
+    }
+
+state_97:
+    rule = 20;
+    *end = pos;
+    goto done;
+
+state_98:
+    if (pos == length) goto incomplete;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 50:
+            goto done;
+        default:
+            pos++;
+            goto state_96;
+    }
+
+state_99:
+    rule = 26;
+    *end = pos;
+    goto done;
+
+state_100:
+    rule = 21;
+    *end = pos;
+    goto done;
+
+state_101:
+    if (pos == length) goto incomplete;
+    switch (c0_direct_scanner_class[source[pos]]) {
+        case 50:
+            goto done;
+        default:
+            pos++;
+            goto state_3;
+    }
+
+state_102:
+    rule = 23;
+    *end = pos;
+    goto done;
+
+incomplete:
+    *stop = pos;
+    return NO_RULE;
+done:
+    *stop = pos;
+    return rule;
+}
+
+#endif /* C0_DIRECT_SCANNER_H */
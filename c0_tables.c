@@ -0,0 +1,18 @@
+/**
+ * c0_tables.c - 预生成的C0扫描表
+ *
+ * c0_tables.h 由 tablegen（或 c0compiler --emit-tables）根据scanner.c中的
+ * 规则表生成，包含最简DFA的扁平转换表。表驱动词法分析直接使用这里的
+ * 只读常量，启动时不再构造NFA和DFA。
+ */
+
+#include "scanner.h"
+#include "c0_tables.h"
+
+/**
+ * 获取预生成的C0扫描表
+ * @return 扫描表指针（只读常量，无需释放）
+ */
+const ScanTable *get_c0_scan_table() {
+    return &c0_scan_table;
+}
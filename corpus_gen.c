@@ -0,0 +1,401 @@
+/**
+ * corpus_gen.c - 合成C0源代码生成器
+ *
+ * 为基准测试生成任意大小的C0源代码：由函数组成，函数体中是声明、赋值、
+ * 条件和循环语句，语句的种类按给定比例混合。同一种子总生成同样的内容。
+ *
+ * 使用方法：
+ *   ./corpus_gen [-s <MB>] [-r <seed>] [--mix=<ident>,<number>,<string>,<comment>] [out.c]
+ *
+ *   -s      生成的大小（MB，默认8）
+ *   -r      随机数种子（默认1）
+ *   --mix   四类语句的相对比例（默认40,25,10,25）：
+ *           ident   标识符为主的赋值和函数调用
+ *           number  含十进制、十六进制、浮点和字符常量的表达式
+ *           string  带转义字符的字符串常量
+ *           comment 单行注释和跨多行的长块注释
+ *   out.c   输出文件（默认标准输出）
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+
+/* 语句种类 */
+enum {
+    MIX_IDENT,
+    MIX_NUMBER,
+    MIX_STRING,
+    MIX_COMMENT,
+    MIX_KINDS
+};
+
+#define STATEMENTS_PER_FUNCTION 24  // 每个函数的语句数
+
+/* 生成器状态 */
+typedef struct {
+    FILE *out;              // 输出文件
+    uint64_t seed;          // xorshift64随机数状态
+    int mix[MIX_KINDS];     // 各类语句的相对比例
+    int mix_total;          // 比例之和
+    size_t written;         // 已输出的字节数
+    int depth;              // 当前缩进层数
+} Generator;
+
+/* 组成标识符的词根 */
+static const char *const WORDS[] = {
+    "count", "index", "value", "total", "buffer", "node", "left", "right",
+    "sum", "result", "state", "next", "prev", "size", "offset", "limit",
+    "key", "item", "temp", "flag", "width", "height", "row", "col"
+};
+#define NUM_WORDS ((int)(sizeof(WORDS) / sizeof(WORDS[0])))
+
+/* 注释中的词 */
+static const char *const COMMENT_WORDS[] = {
+    "compute", "the", "next", "value", "before", "updating", "state",
+    "this", "loop", "keeps", "invariant", "that", "index", "stays", "below",
+    "limit", "see", "notes", "above", "for", "details", "检查", "边界", "条件"
+};
+#define NUM_COMMENT_WORDS ((int)(sizeof(COMMENT_WORDS) / sizeof(COMMENT_WORDS[0])))
+
+static const char *const BINARY_OPERATORS[] = {
+    "+", "-", "*", "/", "%", "<", "<=", ">", ">=", "==", "!=", "&&", "||"
+};
+#define NUM_BINARY_OPERATORS ((int)(sizeof(BINARY_OPERATORS) / sizeof(BINARY_OPERATORS[0])))
+
+/**
+ * 取下一个随机数（xorshift64）
+ */
+static uint64_t next_random(Generator *gen) {
+    uint64_t x = gen->seed;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    gen->seed = x;
+    return x;
+}
+
+/**
+ * 取[0, n)中的随机整数
+ */
+static int random_below(Generator *gen, int n) {
+    return (int)(next_random(gen) % (uint64_t)n);
+}
+
+/**
+ * 输出格式化文本并计数
+ */
+static void emit(Generator *gen, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    int n = vfprintf(gen->out, format, args);
+    va_end(args);
+    if (n > 0) {
+        gen->written += (size_t)n;
+    }
+}
+
+/**
+ * 输出当前缩进
+ */
+static void emit_indent(Generator *gen) {
+    for (int i = 0; i < gen->depth; i++) {
+        emit(gen, "    ");
+    }
+}
+
+/**
+ * 输出一个标识符，如 buffer_size、node3
+ */
+static void emit_identifier(Generator *gen) {
+    const char *word = WORDS[random_below(gen, NUM_WORDS)];
+    switch (random_below(gen, 4)) {
+        case 0:
+            emit(gen, "%s", word);
+            break;
+        case 1:
+            emit(gen, "%s_%s", word, WORDS[random_below(gen, NUM_WORDS)]);
+            break;
+        case 2:
+            emit(gen, "%s%d", word, random_below(gen, 100));
+            break;
+        default:
+            emit(gen, "_%s", word);
+            break;
+    }
+}
+
+/**
+ * 输出一个数值或字符常量
+ */
+static void emit_number(Generator *gen) {
+    switch (random_below(gen, 6)) {
+        case 0:
+        case 1:
+            emit(gen, "%d", random_below(gen, 100000));
+            break;
+        case 2:
+            emit(gen, "0x%X", random_below(gen, 0x10000));
+            break;
+        case 3:
+            emit(gen, "%d.%d", random_below(gen, 1000), random_below(gen, 100000));
+            break;
+        case 4:
+            emit(gen, "%d.%de%s%d", random_below(gen, 10), random_below(gen, 1000),
+                 random_below(gen, 2) ? "-" : "", random_below(gen, 300));
+            break;
+        default:
+            emit(gen, "'%c'", 'a' + random_below(gen, 26));
+            break;
+    }
+}
+
+/**
+ * 输出一个表达式：操作数按语句种类偏向标识符或常量
+ * @param gen 生成器
+ * @param kind 语句种类
+ */
+static void emit_expression(Generator *gen, int kind) {
+    int operands = 1 + random_below(gen, 4);
+    for (int i = 0; i < operands; i++) {
+        if (i > 0) {
+            emit(gen, " %s ", BINARY_OPERATORS[random_below(gen, NUM_BINARY_OPERATORS)]);
+        }
+        if ((kind == MIX_NUMBER) == (random_below(gen, 4) != 0)) {
+            emit_number(gen);
+        } else {
+            emit_identifier(gen);
+        }
+    }
+}
+
+/**
+ * 输出一个字符串常量（含转义字符）
+ */
+static void emit_string(Generator *gen) {
+    static const char *const PIECES[] = {
+        "Hello", "world", "value=", "%d", "\\n", "\\t", "\\\"quoted\\\"", "error: ", "\\\\", "中文"
+    };
+    int pieces = 1 + random_below(gen, 8);
+    emit(gen, "\"");
+    for (int i = 0; i < pieces; i++) {
+        emit(gen, "%s%s", i > 0 ? " " : "", PIECES[random_below(gen, (int)(sizeof(PIECES) / sizeof(PIECES[0])))]);
+    }
+    emit(gen, "\"");
+}
+
+/**
+ * 输出注释：单行注释，或跨若干行的长块注释
+ */
+static void emit_comment(Generator *gen) {
+    if (random_below(gen, 3) != 0) {
+        emit_indent(gen);
+        emit(gen, "//");
+        int words = 3 + random_below(gen, 10);
+        for (int i = 0; i < words; i++) {
+            emit(gen, " %s", COMMENT_WORDS[random_below(gen, NUM_COMMENT_WORDS)]);
+        }
+        emit(gen, "\n");
+        return;
+    }
+    
+    emit_indent(gen);
+    emit(gen, "/*");
+    int lines = 2 + random_below(gen, 12);
+    for (int line = 0; line < lines; line++) {
+        emit(gen, "\n");
+        emit_indent(gen);
+        emit(gen, " *");
+        int words = 4 + random_below(gen, 12);
+        for (int i = 0; i < words; i++) {
+            emit(gen, " %s", COMMENT_WORDS[random_below(gen, NUM_COMMENT_WORDS)]);
+        }
+    }
+    emit(gen, "\n");
+    emit_indent(gen);
+    emit(gen, " */\n");
+}
+
+/**
+ * 按比例选择语句种类
+ */
+static int choose_kind(Generator *gen) {
+    int r = random_below(gen, gen->mix_total);
+    for (int kind = 0; kind < MIX_KINDS; kind++) {
+        if (r < gen->mix[kind]) {
+            return kind;
+        }
+        r -= gen->mix[kind];
+    }
+    return MIX_IDENT;
+}
+
+/**
+ * 输出一条语句，偶尔是包含若干语句的if或while
+ */
+static void emit_statement(Generator *gen) {
+    int kind = choose_kind(gen);
+    if (kind == MIX_COMMENT) {
+        emit_comment(gen);
+        return;
+    }
+    
+    // 控制语句：嵌套不超过3层
+    if (gen->depth < 4 && random_below(gen, 8) == 0) {
+        static const char *const CONTROLS[] = {"if", "while"};
+        emit_indent(gen);
+        emit(gen, "%s (", CONTROLS[random_below(gen, 2)]);
+        emit_expression(gen, kind);
+        emit(gen, ") {\n");
+        gen->depth++;
+        int body = 1 + random_below(gen, 4);
+        for (int i = 0; i < body; i++) {
+            emit_statement(gen);
+        }
+        gen->depth--;
+        emit_indent(gen);
+        emit(gen, "}\n");
+        return;
+    }
+    
+    emit_indent(gen);
+    switch (kind) {
+        case MIX_STRING:
+            emit(gen, "print_str(");
+            emit_string(gen);
+            emit(gen, ");\n");
+            break;
+        case MIX_NUMBER:
+            emit(gen, "%s ", random_below(gen, 2) ? "double" : "int");
+            emit_identifier(gen);
+            emit(gen, " = ");
+            emit_expression(gen, kind);
+            emit(gen, ";\n");
+            break;
+        default:
+            if (random_below(gen, 3) == 0) {
+                emit_identifier(gen);
+                emit(gen, "(");
+                emit_identifier(gen);
+                emit(gen, ", ");
+                emit_identifier(gen);
+                emit(gen, ");\n");
+            } else {
+                emit_identifier(gen);
+                emit(gen, " = ");
+                emit_expression(gen, kind);
+                emit(gen, ";\n");
+            }
+            break;
+    }
+}
+
+/**
+ * 输出一个函数
+ * @param gen 生成器
+ * @param number 函数编号
+ */
+static void emit_function(Generator *gen, int number) {
+    static const char *const TYPES[] = {"int", "double", "char", "void"};
+    emit(gen, "%s func_%d(int ", TYPES[random_below(gen, 4)], number);
+    emit_identifier(gen);
+    emit(gen, ", double ");
+    emit_identifier(gen);
+    emit(gen, ") {\n");
+    gen->depth = 1;
+    for (int i = 0; i < STATEMENTS_PER_FUNCTION; i++) {
+        emit_statement(gen);
+    }
+    emit(gen, "    return ");
+    emit_expression(gen, MIX_IDENT);
+    emit(gen, ";\n}\n\n");
+    gen->depth = 0;
+}
+
+/**
+ * 解析--mix=a,b,c,d
+ * @return 是否有效
+ */
+static bool parse_mix(Generator *gen, const char *text) {
+    int total = 0;
+    for (int kind = 0; kind < MIX_KINDS; kind++) {
+        char *end;
+        long value = strtol(text, &end, 10);
+        if (end == text || value < 0 || value > 1000) {
+            return false;
+        }
+        gen->mix[kind] = (int)value;
+        total += (int)value;
+        if (kind + 1 < MIX_KINDS) {
+            if (*end != ',') {
+                return false;
+            }
+            text = end + 1;
+        } else if (*end != '\0') {
+            return false;
+        }
+    }
+    gen->mix_total = total;
+    return total > 0;
+}
+
+/**
+ * 主函数
+ */
+int main(int argc, char *argv[]) {
+    Generator gen;
+    memset(&gen, 0, sizeof(gen));
+    gen.out = stdout;
+    gen.seed = 1;
+    parse_mix(&gen, "40,25,10,25");
+    double megabytes = 8;
+    const char *filename = NULL;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            megabytes = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            gen.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strncmp(argv[i], "--mix=", 6) == 0) {
+            if (!parse_mix(&gen, argv[i] + 6)) {
+                fprintf(stderr, "错误: 无效的比例 '%s'（格式为 ident,number,string,comment）\n", argv[i] + 6);
+                return 1;
+            }
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            fprintf(stderr, "使用方法: %s [-s <MB>] [-r <seed>] [--mix=<ident>,<number>,<string>,<comment>] [out.c]\n", argv[0]);
+            return 1;
+        } else {
+            filename = argv[i];
+        }
+    }
+    if (megabytes <= 0) {
+        fprintf(stderr, "错误: 大小必须为正数\n");
+        return 1;
+    }
+    if (gen.seed == 0) {
+        gen.seed = 1;
+    }
+    
+    if (filename) {
+        gen.out = fopen(filename, "w");
+        if (!gen.out) {
+            fprintf(stderr, "错误: 无法写入文件 '%s'\n", filename);
+            return 1;
+        }
+    }
+    
+    size_t target = (size_t)(megabytes * 1024 * 1024);
+    emit(&gen, "// 由corpus_gen生成的C0源代码（种子%llu）\n\n", (unsigned long long)gen.seed);
+    for (int number = 0; gen.written < target; number++) {
+        emit_function(&gen, number);
+    }
+    
+    if (filename && fclose(gen.out) != 0) {
+        fprintf(stderr, "错误: 无法写入文件 '%s'\n", filename);
+        return 1;
+    }
+    return 0;
+}
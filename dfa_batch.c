@@ -0,0 +1,285 @@
+/**
+ * dfa_batch.c - DFA批量执行实现
+ *
+ * 逐路运行DFA时每一步都要等上一次查表的结果，访存延迟首尾相接；
+ * 多路交错运行时同一步中各路的查表互不依赖，可以同时在途。
+ * 为使每步的查表不必判断"没有转换"，先把DFA的转换表扩充一行一列：
+ * 没有转换的字节映射到最后一列，没有转换的状态映射到补上的死状态，
+ * 死状态的一行全部指向自身；表项直接存放目标行的起点，每步只有一次加法和一次访存。
+ * 各路只在输入结束或进入死状态时换下一个输入。
+ *
+ * dfa_state_map的各路读同一段输入，每个字节只查一次等价类；
+ * 确定的自动机中到达同一状态的各路此后结果相同，定期合并，
+ * 通常很快只剩少数几路。
+ */
+
+#include "dfa_batch.h"
+
+#define BATCH_MERGE_INTERVAL 16 // dfa_state_map每隔多少字节合并一次到达同一状态的各路
+
+/* 补上死状态和无转换列的转换表 */
+typedef struct {
+    int *next;              // next[行 + 列]为目标状态的行起点（状态 * width），省去每步的乘法
+    int width;              // 每行宽度（等价类数量加1）
+    int dead;               // 死状态（原DFA的状态数）的行起点
+    int column[MAX_ALPHABET]; // 字节 -> 列
+} BatchTable;
+
+/**
+ * 由DFA建立批量执行用的转换表
+ * @param dfa DFA指针
+ * @param table 输出：转换表（用batch_table_free释放）
+ */
+static void batch_table_init(const DFA *dfa, BatchTable *table) {
+    int k = dfa->alphabet_size;
+    table->width = k + 1;
+    table->dead = dfa->num_states * table->width;
+    table->next = (int *)malloc(sizeof(int) * (size_t)(dfa->num_states + 1) * table->width);
+    if (!table->next) {
+        fprintf(stderr, "内存分配失败: batch_table_init\n");
+        exit(1);
+    }
+    
+    for (int s = 0; s <= dfa->num_states; s++) {
+        int *row = table->next + (size_t)s * table->width;
+        for (int c = 0; c < k; c++) {
+            int target = s < dfa->num_states ? dfa->transition[s * k + c] : -1;
+            row[c] = target >= 0 ? target * table->width : table->dead;
+        }
+        row[k] = table->dead;
+    }
+    for (int b = 0; b < MAX_ALPHABET; b++) {
+        table->column[b] = dfa->symbol_index[b] >= 0 ? dfa->symbol_index[b] : k;
+    }
+}
+
+/**
+ * 释放批量执行用的转换表
+ * @param table 转换表
+ */
+static void batch_table_free(BatchTable *table) {
+    free(table->next);
+    table->next = NULL;
+}
+
+/**
+ * 让一路开始处理第i个输入；不必运行的输入（起始状态无效或输入为空）直接写出结果
+ * @param dfa DFA指针
+ * @param table 转换表
+ * @param starts 各输入的起始状态（NULL表示都从dfa->start_state出发）
+ * @param inputs 各输入
+ * @param lengths 各输入长度
+ * @param i 输入下标
+ * @param finals 输出：各输入到达的状态
+ * @param state 输出：该路状态的行起点
+ * @param pos 输出：该路下一个字节
+ * @param end 输出：该路输入的末尾
+ * @return 该路是否已装入输入
+ */
+static bool start_lane(const DFA *dfa, const BatchTable *table, const int *starts,
+                       const unsigned char *const *inputs, const size_t *lengths, int i,
+                       int *finals, int *state, const unsigned char **pos,
+                       const unsigned char **end) {
+    int start = starts ? starts[i] : dfa->start_state;
+    if (start < 0 || lengths[i] == 0) {
+        finals[i] = start >= 0 ? start : -1;
+        return false;
+    }
+    *state = start * table->width;
+    *pos = inputs[i];
+    *end = inputs[i] + lengths[i];
+    return true;
+}
+
+/**
+ * 交错运行全部输入：DFA_BATCH_LANES路各处理一个输入，每步让各路前进一个字节，
+ * 某路的输入结束（或进入死状态）时写出结果并立即装入下一个输入，
+ * 长短不一的输入不会让其他路空等
+ * @param dfa DFA指针
+ * @param table 由该DFA建立的转换表
+ * @param starts 各输入的起始状态（NULL表示都从dfa->start_state出发）
+ * @param inputs 各输入
+ * @param lengths 各输入长度
+ * @param count 输入数量
+ * @param finals 输出：各输入到达的状态（中途没有转换时为-1）
+ */
+static void run_all(const DFA *dfa, const BatchTable *table, const int *starts,
+                    const unsigned char *const *inputs, const size_t *lengths, int count,
+                    int *finals) {
+    int input[DFA_BATCH_LANES];             // 各路正在处理的输入
+    int state[DFA_BATCH_LANES];             // 各路当前状态的行起点
+    const unsigned char *pos[DFA_BATCH_LANES];  // 各路下一个字节
+    const unsigned char *end[DFA_BATCH_LANES];  // 各路输入的末尾
+    int active = 0;
+    int next_input = 0;
+    while (active < DFA_BATCH_LANES && next_input < count) {
+        if (start_lane(dfa, table, starts, inputs, lengths, next_input, finals,
+                       &state[active], &pos[active], &end[active])) {
+            input[active++] = next_input;
+        }
+        next_input++;
+    }
+    
+    while (active > 0) {
+        for (int a = 0; a < active; a++) {
+            int next = table->next[state[a] + table->column[*pos[a]++]];
+            state[a] = next;
+            if (next != table->dead && pos[a] != end[a]) {
+                continue;
+            }
+            
+            finals[input[a]] = next == table->dead ? -1 : next / table->width;
+            bool loaded = false;
+            while (!loaded && next_input < count) {
+                loaded = start_lane(dfa, table, starts, inputs, lengths, next_input, finals,
+                                    &state[a], &pos[a], &end[a]);
+                if (loaded) {
+                    input[a] = next_input;
+                }
+                next_input++;
+            }
+            if (!loaded) {
+                // 没有更多输入：把最后一路移到这里，本步接着处理它
+                active--;
+                input[a] = input[active];
+                state[a] = state[active];
+                pos[a] = pos[active];
+                end[a] = end[active];
+                a--;
+            }
+        }
+    }
+}
+
+/**
+ * 在同一个DFA上运行多路输入，求各路读完输入后到达的状态
+ * DFA_BATCH_LANES路交错运行，结果与逐路调用dfa_next相同。
+ * @param dfa DFA指针（通常为最简DFA）
+ * @param starts 各路的起始状态（NULL表示都从dfa->start_state出发）
+ * @param inputs 各路输入
+ * @param lengths 各路输入长度
+ * @param count 路数
+ * @param finals 输出：各路到达的状态（中途没有转换时为-1）
+ */
+void dfa_run_batch(const DFA *dfa, const int *starts, const unsigned char *const *inputs,
+                   const size_t *lengths, int count, int *finals) {
+    BatchTable table;
+    batch_table_init(dfa, &table);
+    run_all(dfa, &table, starts, inputs, lengths, count, finals);
+    batch_table_free(&table);
+}
+
+/**
+ * 批量校验：各路输入是否整个为DFA所接受（例如校验一批名字是否都是合法标识符）
+ * @param dfa DFA指针
+ * @param inputs 各路输入
+ * @param lengths 各路输入长度
+ * @param count 路数
+ * @param accepted 输出：各路是否被接受（可以为NULL）
+ * @return 被接受的路数
+ */
+int dfa_accept_batch(const DFA *dfa, const unsigned char *const *inputs, const size_t *lengths,
+                     int count, bool *accepted) {
+    int *finals = (int *)malloc(sizeof(int) * (count > 0 ? count : 1));
+    if (!finals) {
+        fprintf(stderr, "内存分配失败: dfa_accept_batch\n");
+        exit(1);
+    }
+    BatchTable table;
+    batch_table_init(dfa, &table);
+    run_all(dfa, &table, NULL, inputs, lengths, count, finals);
+    batch_table_free(&table);
+    
+    int total = 0;
+    for (int i = 0; i < count; i++) {
+        bool ok = finals[i] >= 0 && dfa->final_states[finals[i]];
+        if (accepted) {
+            accepted[i] = ok;
+        }
+        total += ok;
+    }
+    free(finals);
+    return total;
+}
+
+/**
+ * 求一段输入从每个状态出发到达的状态
+ * 各状态为一路，每个字节只查一次等价类，每隔BATCH_MERGE_INTERVAL字节把
+ * 到达同一状态的各路合并为一路，进入死状态的路直接结束。
+ * @param dfa DFA指针
+ * @param input 输入
+ * @param length 输入长度
+ * @param map 输出：map[s]为从状态s出发读完输入后的状态（中途没有转换时为-1），
+ *            共dfa->num_states项
+ */
+void dfa_state_map(const DFA *dfa, const unsigned char *input, size_t length, int *map) {
+    int n = dfa->num_states;
+    if (n == 0) {
+        return;
+    }
+    BatchTable table;
+    batch_table_init(dfa, &table);
+    
+    int *state = (int *)malloc(sizeof(int) * n);    // 各活跃路当前状态的行起点
+    int *lane = (int *)malloc(sizeof(int) * n);     // 各活跃路的编号（即其起始状态）
+    int *alias = (int *)malloc(sizeof(int) * n);    // 被合并的路并入的路，-1表示未合并
+    int *owner = (int *)malloc(sizeof(int) * (n + 1)); // 合并时：状态 -> 已到达该状态的路
+    if (!state || !lane || !alias || !owner) {
+        fprintf(stderr, "内存分配失败: dfa_state_map\n");
+        exit(1);
+    }
+    for (int s = 0; s < n; s++) {
+        state[s] = s * table.width;
+        lane[s] = s;
+        alias[s] = -1;
+        map[s] = n;
+    }
+    
+    int active = n;
+    for (size_t t = 0; t < length && active > 0; t++) {
+        const int *column = table.next + table.column[input[t]];
+        for (int a = 0; a < active; a++) {
+            state[a] = column[state[a]];
+        }
+        
+        if ((t + 1) % BATCH_MERGE_INTERVAL == 0 || t + 1 == length) {
+            for (int s = 0; s <= n; s++) {
+                owner[s] = -1;
+            }
+            int kept = 0;
+            for (int a = 0; a < active; a++) {
+                if (state[a] == table.dead) {
+                    continue;                   // map中已是死状态
+                }
+                int target = state[a] / table.width;
+                if (owner[target] >= 0) {
+                    alias[lane[a]] = owner[target];
+                    continue;
+                }
+                owner[target] = lane[a];
+                state[kept] = state[a];
+                lane[kept] = lane[a];
+                kept++;
+            }
+            active = kept;
+        }
+    }
+    
+    for (int a = 0; a < active; a++) {
+        map[lane[a]] = state[a] / table.width;
+    }
+    // 被合并的路沿合并链取其最终并入的路的结果
+    for (int s = 0; s < n; s++) {
+        int root = s;
+        while (alias[root] >= 0) {
+            root = alias[root];
+        }
+        map[s] = map[root] == n ? -1 : map[root];
+    }
+    
+    free(state);
+    free(lane);
+    free(alias);
+    free(owner);
+    batch_table_free(&table);
+}
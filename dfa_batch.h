@@ -0,0 +1,26 @@
+/**
+ * dfa_batch.h - DFA批量执行头文件
+ *
+ * 在同一个DFA上同时运行多路互不相关的输入：DFA_BATCH_LANES路轮流各走一步，
+ * 各路的查表彼此独立，访存延迟可以重叠；一路读完输入后立即换下一个输入。
+ * 用于批量校验词素（例如标识符列表）和计算一段输入从每个状态出发
+ * 到达的状态（分块推测分析时块起点的状态未知，可以先对所有起始状态求出结果）。
+ */
+
+#ifndef DFA_BATCH_H
+#define DFA_BATCH_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "nfa_dfa.h"
+
+#define DFA_BATCH_LANES 16      // 一组交错运行的输入路数
+
+/* DFA批量执行函数 */
+void dfa_run_batch(const DFA *dfa, const int *starts, const unsigned char *const *inputs,
+                   const size_t *lengths, int count, int *finals);
+int dfa_accept_batch(const DFA *dfa, const unsigned char *const *inputs, const size_t *lengths,
+                     int count, bool *accepted);
+void dfa_state_map(const DFA *dfa, const unsigned char *input, size_t length, int *map);
+
+#endif /* DFA_BATCH_H */
@@ -0,0 +1,339 @@
+/**
+ * lazy_dfa.c - 惰性DFA实现
+ *
+ * 与nfa_to_dfa的子集构造相同，DFA状态为NFA状态集合的ε闭包，
+ * 但只有扫描时实际经过的(状态, 等价类)才计算move和闭包，结果记入转换表，
+ * 再次经过时只查一次表。缓存按内存预算预先分配：
+ * 1. 每个状态占用集合位图、一行转换表、规则编号和散列表槽位，
+ *    预算除以每个状态的开销即为可缓存的状态数
+ * 2. 缓存已满又需要新状态时清空缓存，重新加入初始状态和当前状态后继续扫描
+ * 3. 两次清空之间平均每个状态扫描的字节少于LAZY_DFA_MIN_BYTES_PER_STATE，
+ *    说明工作集大于缓存；连续LAZY_DFA_MAX_THRASH次如此，则随后至少
+ *    LAZY_DFA_NFA_BYTES字节直接模拟NFA（每字节一次move和闭包，不再缓存）
+ * Thompson构造的NFA中每个状态都能到达终态，因此空集合即死状态，
+ * 与最简DFA删去的死状态一致，扫描停止的位置也与按扫描表匹配相同。
+ */
+
+#include "lazy_dfa.h"
+
+#define LAZY_DFA_GIVE_UP (-3)   // 缓存失效，改为模拟NFA
+
+/**
+ * 求状态集合识别的规则：集合中各NFA终态的规则编号取最小者
+ * @param nfa NFA指针
+ * @param set 状态集合
+ * @return 规则编号（NO_RULE表示不含终态）
+ */
+static int set_accept_rule(const NFA *nfa, const StateSet *set) {
+    int rule = NO_RULE;
+    for (int state = state_set_next(set, 0); state >= 0; state = state_set_next(set, state + 1)) {
+        if (nfa->final_states[state] && (rule == NO_RULE || nfa->accept_rule[state] < rule)) {
+            rule = nfa->accept_rule[state];
+        }
+    }
+    return rule;
+}
+
+/**
+ * 把sets[num_states]中已经填好的集合登记为新状态：规则编号、
+ * 转换表的一行（无转换列为死状态，其余尚未计算）和散列表
+ * @param lazy 惰性DFA
+ * @return 新状态编号
+ */
+static int register_state(LazyDFA *lazy) {
+    int state = lazy->num_states++;
+    lazy->accept[state] = set_accept_rule(lazy->nfa, &lazy->sets[state]);
+    int *row = lazy->next + (size_t)state * lazy->width;
+    for (int c = 0; c < lazy->width - 1; c++) {
+        row[c] = LAZY_DFA_UNKNOWN;
+    }
+    row[lazy->width - 1] = -1;
+    state_set_map_insert(&lazy->map, lazy->sets, state);
+    lazy->states_built++;
+    return state;
+}
+
+/**
+ * 把一个集合加入缓存（调用者保证缓存未满且集合尚不存在）
+ * @param lazy 惰性DFA
+ * @param set 状态集合
+ * @return 新状态编号
+ */
+static int add_state(LazyDFA *lazy, const StateSet *set) {
+    StateSet *slot = &lazy->sets[lazy->num_states];
+    memcpy(slot->words, set->words, sizeof(uint64_t) * set->num_words);
+    slot->count = set->count;
+    return register_state(lazy);
+}
+
+/**
+ * 初始化惰性DFA：按预算分配状态缓存，只构造初始状态
+ * @param lazy 惰性DFA
+ * @param nfa NFA指针（最长匹配返回其终态的规则编号）
+ * @param budget 状态缓存的内存预算（字节），不足LAZY_DFA_MIN_STATES个状态时按该数量分配
+ */
+void lazy_dfa_init(LazyDFA *lazy, NFA *nfa, size_t budget) {
+    lazy->nfa = nfa;
+    int class_of[MAX_ALPHABET];
+    int num_classes = nfa_byte_classes(nfa, class_of);
+    lazy->width = num_classes + 1;
+    for (int b = MAX_ALPHABET - 1; b >= 0; b--) {
+        lazy->class_of[b] = class_of[b] >= 0 ? class_of[b] : num_classes;
+        if (class_of[b] >= 0) {
+            lazy->representative[class_of[b]] = (unsigned char)b;  // 最终为最小字节
+        }
+    }
+    
+    // 每个状态：位图、集合结构、规则编号、一行转换表，以及装填因子不低于1/4的散列表槽位
+    int num_words = (nfa->num_states + 63) / 64;
+    size_t per_state = sizeof(uint64_t) * (num_words > 0 ? num_words : 1) + sizeof(StateSet) +
+                       sizeof(int) * (1 + (size_t)lazy->width + 4);
+    size_t max_states = budget / per_state;
+    if (max_states < LAZY_DFA_MIN_STATES) {
+        max_states = LAZY_DFA_MIN_STATES;
+    }
+    if (max_states > (size_t)INT32_MAX / 4) {
+        max_states = (size_t)INT32_MAX / 4;
+    }
+    lazy->budget = budget;
+    lazy->max_states = (int)max_states;
+    
+    lazy->sets = (StateSet *)malloc(sizeof(StateSet) * max_states);
+    lazy->accept = (int *)malloc(sizeof(int) * max_states);
+    lazy->next = (int *)malloc(sizeof(int) * max_states * lazy->width);
+    if (!lazy->sets || !lazy->accept || !lazy->next) {
+        fprintf(stderr, "内存分配失败: lazy_dfa_init\n");
+        exit(1);
+    }
+    for (int i = 0; i < lazy->max_states; i++) {
+        state_set_init(&lazy->sets[i], nfa->num_states);
+    }
+    state_set_init(&lazy->current, nfa->num_states);
+    state_set_init(&lazy->target, nfa->num_states);
+    state_set_map_init(&lazy->map);
+    
+    lazy->num_states = 0;
+    lazy->scanned = 0;
+    lazy->thrash = 0;
+    lazy->nfa_left = 0;
+    lazy->states_built = 0;
+    lazy->flushes = 0;
+    lazy->fallbacks = 0;
+    lazy->nfa_bytes = 0;
+    lazy_dfa_flush(lazy);
+    lazy->flushes = 0;
+}
+
+/**
+ * 释放惰性DFA（不释放NFA）
+ * @param lazy 惰性DFA
+ */
+void lazy_dfa_free(LazyDFA *lazy) {
+    for (int i = 0; i < lazy->max_states; i++) {
+        state_set_free(&lazy->sets[i]);
+    }
+    free(lazy->sets);
+    free(lazy->accept);
+    free(lazy->next);
+    state_set_free(&lazy->current);
+    state_set_free(&lazy->target);
+    state_set_map_free(&lazy->map);
+    lazy->sets = NULL;
+    lazy->accept = NULL;
+    lazy->next = NULL;
+    lazy->num_states = 0;
+    lazy->max_states = 0;
+}
+
+/**
+ * 清空状态缓存，只保留重新构造的初始状态（编号为0）
+ * @param lazy 惰性DFA
+ */
+void lazy_dfa_flush(LazyDFA *lazy) {
+    for (int i = 0; i < lazy->map.capacity; i++) {
+        lazy->map.slots[i] = -1;
+    }
+    lazy->map.count = 0;
+    lazy->num_states = 0;
+    
+    StateSet *start = &lazy->sets[0];
+    state_set_clear(start);
+    state_set_add(start, lazy->nfa->start_state);
+    epsilon_closure(lazy->nfa, start);
+    lazy->start_state = register_state(lazy);
+    lazy->scanned = 0;
+    lazy->flushes++;
+}
+
+/**
+ * 缓存已满时腾出空间：清空缓存并重新加入当前状态
+ * 两次清空之间扫描的字节过少时记一次过早清空，连续过多则放弃DFA，
+ * 此时当前集合留在lazy->current中，由调用者从这里开始模拟NFA。
+ * @param lazy 惰性DFA
+ * @param state 当前状态（清空后更新为它的新编号）
+ * @return 是否可以继续按DFA扫描
+ */
+static bool make_room(LazyDFA *lazy, int *state) {
+    StateSet *current = &lazy->current;
+    memcpy(current->words, lazy->sets[*state].words, sizeof(uint64_t) * current->num_words);
+    current->count = lazy->sets[*state].count;
+    
+    if (lazy->scanned < (size_t)lazy->max_states * LAZY_DFA_MIN_BYTES_PER_STATE) {
+        lazy->thrash++;
+    } else {
+        lazy->thrash = 0;
+    }
+    lazy_dfa_flush(lazy);
+    
+    if (lazy->thrash >= LAZY_DFA_MAX_THRASH) {
+        lazy->thrash = 0;
+        lazy->fallbacks++;
+        lazy->nfa_left = LAZY_DFA_NFA_BYTES;
+        return false;
+    }
+    
+    int found = state_set_map_find(&lazy->map, lazy->sets, current);
+    *state = found >= 0 ? found : add_state(lazy, current);
+    return true;
+}
+
+/**
+ * 计算尚未缓存的转换：对等价类的代表字节做move和ε闭包，查找或构造目标状态
+ * @param lazy 惰性DFA
+ * @param state 当前状态（缓存被清空时更新为它的新编号）
+ * @param cls 等价类
+ * @return 目标状态，-1为死状态，LAZY_DFA_GIVE_UP表示改为模拟NFA
+ */
+static int compute_next(LazyDFA *lazy, int *state, int cls) {
+    StateSet *target = &lazy->target;
+    move(lazy->nfa, &lazy->sets[*state], lazy->representative[cls], target);
+    int found = -1;
+    if (target->count > 0) {
+        epsilon_closure(lazy->nfa, target);
+        found = state_set_map_find(&lazy->map, lazy->sets, target);
+        if (found < 0) {
+            if (lazy->num_states == lazy->max_states) {
+                if (!make_room(lazy, state)) {
+                    return LAZY_DFA_GIVE_UP;
+                }
+                // 清空后重新加入了初始状态和当前状态，目标可能就是其中之一
+                found = state_set_map_find(&lazy->map, lazy->sets, target);
+            }
+            if (found < 0) {
+                found = add_state(lazy, target);
+            }
+        }
+    }
+    lazy->next[(size_t)*state * lazy->width + cls] = found;
+    return found;
+}
+
+/**
+ * 直接模拟NFA继续最长匹配：每字节一次move和ε闭包（不使用也不改变缓存）
+ * @param lazy 惰性DFA（lazy->current为位于pos处的当前集合）
+ * @param source 源代码
+ * @param length 源代码长度
+ * @param pos 当前位置
+ * @param last_rule 此前识别的规则编号（NO_RULE表示尚无）
+ * @param end 输出：匹配的结束位置
+ * @param stop 输出：扫描停止的位置
+ * @return 识别出的规则编号，或NO_RULE
+ */
+static int simulate_nfa(LazyDFA *lazy, const unsigned char *source, size_t length, size_t pos,
+                        int last_rule, size_t *end, size_t *stop) {
+    size_t from = pos;
+    bool alive = true;
+    
+    while (pos < length) {
+        move(lazy->nfa, &lazy->current, source[pos], &lazy->target);
+        if (lazy->target.count == 0) {
+            alive = false;
+            break;
+        }
+        epsilon_closure(lazy->nfa, &lazy->target);
+        StateSet swap = lazy->current;
+        lazy->current = lazy->target;
+        lazy->target = swap;
+        pos++;
+        int rule = set_accept_rule(lazy->nfa, &lazy->current);
+        if (rule != NO_RULE) {
+            last_rule = rule;
+            *end = pos;
+        }
+    }
+    
+    lazy->nfa_bytes += pos - from;
+    size_t consumed = pos - from > 0 ? pos - from : 1;
+    lazy->nfa_left = lazy->nfa_left > consumed ? lazy->nfa_left - consumed : 0;
+    *stop = pos;
+    if (alive && pos == length && set_accept_rule(lazy->nfa, &lazy->current) == NO_RULE) {
+        return NO_RULE;
+    }
+    return last_rule;
+}
+
+/**
+ * 从指定位置做最长匹配，按需构造DFA状态
+ * 没有可接受的前缀，或在文件结束处停在非终态时返回NO_RULE（与match_longest相同）。
+ * @param lazy 惰性DFA
+ * @param source 源代码
+ * @param length 源代码长度
+ * @param start 起始位置
+ * @param end 输出：匹配的结束位置
+ * @param stop 输出：扫描停止的位置（等于length表示直到末尾仍未进入死状态）
+ * @return 识别出的规则编号，或NO_RULE
+ */
+int lazy_dfa_match(LazyDFA *lazy, const unsigned char *source, size_t length, size_t start,
+                   size_t *end, size_t *stop) {
+    if (lazy->nfa_left > 0) {
+        StateSet *start_set = &lazy->sets[lazy->start_state];
+        memcpy(lazy->current.words, start_set->words, sizeof(uint64_t) * start_set->num_words);
+        lazy->current.count = start_set->count;
+        return simulate_nfa(lazy, source, length, start, NO_RULE, end, stop);
+    }
+    
+    size_t pos = start;
+    size_t counted = start;
+    int last_rule = NO_RULE;
+    int state = lazy->start_state;
+    
+    while (pos < length) {
+        int cls = lazy->class_of[source[pos]];
+        int next = lazy->next[(size_t)state * lazy->width + cls];
+        if (next == LAZY_DFA_UNKNOWN) {
+            lazy->scanned += pos - counted;
+            counted = pos;
+            next = compute_next(lazy, &state, cls);
+            if (next == LAZY_DFA_GIVE_UP) {
+                return simulate_nfa(lazy, source, length, pos, last_rule, end, stop);
+            }
+        }
+        if (next < 0) break;
+        state = next;
+        pos++;
+        if (lazy->accept[state] != NO_RULE) {
+            last_rule = lazy->accept[state];
+            *end = pos;
+        }
+    }
+    
+    lazy->scanned += pos - counted;
+    *stop = pos;
+    if (pos == length && lazy->accept[state] == NO_RULE) {
+        return NO_RULE;
+    }
+    return last_rule;
+}
+
+/**
+ * 输出惰性DFA的缓存统计
+ * @param out 输出文件
+ * @param lazy 惰性DFA
+ */
+void lazy_dfa_print_stats(FILE *out, const LazyDFA *lazy) {
+    fprintf(out, "\n惰性DFA（预算 %zu 字节，最多缓存 %d 个状态）:\n", lazy->budget, lazy->max_states);
+    fprintf(out, "  当前缓存: %d 状态\n", lazy->num_states);
+    fprintf(out, "  构造状态: %ld\n", lazy->states_built);
+    fprintf(out, "  清空缓存: %ld 次\n", lazy->flushes);
+    fprintf(out, "  模拟NFA:  %ld 次，%zu 字节\n", lazy->fallbacks, lazy->nfa_bytes);
+}
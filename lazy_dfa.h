@@ -0,0 +1,60 @@
+/**
+ * lazy_dfa.h - 惰性DFA头文件
+ *
+ * 扫描时才由NFA按需构造DFA状态（子集构造的一步），构造出的状态和转换
+ * 缓存在固定内存预算之内，规则很多、彼此重叠而完整确定化代价过高时，
+ * 内存占用仍然可以预测。缓存满时清空缓存并从当前状态继续；若清空过于频繁
+ * （每清空一次扫描的字节太少，缓存已失效），则对随后一段输入改为直接模拟NFA。
+ * 最长匹配的约定与按扫描表匹配相同，规则编号即构造NFA时的规则下标。
+ */
+
+#ifndef LAZY_DFA_H
+#define LAZY_DFA_H
+
+#include <stdio.h>
+#include "nfa_dfa.h"
+
+#define LAZY_DFA_DEFAULT_BUDGET (256 * 1024) // 默认的状态缓存内存预算（字节）
+#define LAZY_DFA_MIN_STATES 4       // 缓存至少能容纳的状态数（初始状态、当前状态和新状态）
+#define LAZY_DFA_MIN_BYTES_PER_STATE 10 // 两次清空之间平均每个缓存状态至少应扫描的字节数
+#define LAZY_DFA_MAX_THRASH 3       // 连续多少次过早清空后改为模拟NFA
+#define LAZY_DFA_NFA_BYTES 4096     // 每次改为模拟NFA后，至少以NFA扫描的字节数
+
+/* 惰性DFA：状态为NFA状态集合，转换在首次经过时才计算 */
+typedef struct {
+    NFA *nfa;               // NFA（不属于惰性DFA，必须比它存活更久）
+    int class_of[MAX_ALPHABET]; // 字节 -> 等价类，没有转换的字节映射到最后一列
+    int width;              // 转换表每行的宽度（等价类数量加上无转换列）
+    unsigned char representative[MAX_ALPHABET]; // 每个等价类的代表字节
+    size_t budget;          // 内存预算（字节）
+    int max_states;         // 预算下缓存可容纳的状态数
+    int num_states;         // 已缓存的状态数
+    StateSet *sets;         // 各状态的NFA状态集合（预先分配max_states个）
+    int *accept;            // 各状态识别的规则编号（NO_RULE表示非终态）
+    int *next;              // 转换表：next[状态 * width + 等价类]，-1为死状态，LAZY_DFA_UNKNOWN为尚未计算
+    StateSetMap map;        // 状态集合 -> 状态编号
+    int start_state;        // 初始状态（清空缓存后重新加入）
+    StateSet current;       // 清空缓存或模拟NFA时的当前集合
+    StateSet target;        // 计算转换用的目标集合
+    size_t scanned;         // 自上次清空以来扫描的字节数
+    int thrash;             // 连续过早清空的次数
+    size_t nfa_left;        // 尚需以NFA扫描的字节数（为0时按DFA扫描）
+    
+    /* 统计 */
+    long states_built;      // 构造的状态总数
+    long flushes;           // 清空缓存的次数
+    long fallbacks;         // 改为模拟NFA的次数
+    size_t nfa_bytes;       // 以NFA模拟扫描的字节数
+} LazyDFA;
+
+#define LAZY_DFA_UNKNOWN (-2)   // 转换尚未计算
+
+/* 惰性DFA函数 */
+void lazy_dfa_init(LazyDFA *lazy, NFA *nfa, size_t budget);
+void lazy_dfa_free(LazyDFA *lazy);
+void lazy_dfa_flush(LazyDFA *lazy);
+int lazy_dfa_match(LazyDFA *lazy, const unsigned char *source, size_t length, size_t start,
+                   size_t *end, size_t *stop);
+void lazy_dfa_print_stats(FILE *out, const LazyDFA *lazy);
+
+#endif /* LAZY_DFA_H */
@@ -0,0 +1,695 @@
+/**
+ * lex_server.c - 常驻词法分析服务实现
+ *
+ * 固定数量的工作线程在同一个监听套接字上accept，各自处理接受的连接，
+ * 连接上的请求依次处理；每个线程保留自己的请求缓冲区（大请求之后收缩到固定大小），反复使用。
+ * 扫描表、关键字表都是只读的静态数据，各请求的Token流只由处理它的线程访问。
+ * 所有线程都屏蔽SIGINT和SIGTERM，由调用线程sigwait等待；收到信号或停止请求后，
+ * 关闭监听套接字和各连接的读方向，唤醒阻塞中的工作线程后再回收。
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include "lex_server.h"
+#include "lexer.h"
+#include "source_file.h"
+#include "parallel_lex.h"
+#include "token_output.h"
+
+#define SERVER_BUFFER_KEEP (1024 * 1024) // 请求之间保留的请求缓冲区容量上限（字节）
+#define SERVER_IO_TIMEOUT 30    // 连接上收发停滞多少秒后关闭连接（不让客户端长期占住工作线程）
+
+/* 服务的共享状态 */
+typedef struct {
+    int listen_fd;          // 监听套接字
+    pthread_t main_thread;  // 等待信号的调用线程
+    pthread_mutex_t lock;   // 保护以下字段
+    bool stopping;          // 是否正在停止
+    int *connections;       // 各工作线程正在处理的连接（-1表示没有）
+    LexServerSummary summary; // 汇总结果
+} LexServer;
+
+/* 工作线程参数 */
+typedef struct {
+    LexServer *server;      // 服务
+    int id;                 // 线程编号
+    char *buffer;           // 请求内容缓冲区（在该线程处理的各请求之间复用）
+    size_t capacity;        // 缓冲区容量
+} LexServerWorker;
+
+/**
+ * 按小端序写出32位整数
+ * @param bytes 输出位置
+ * @param value 整数
+ */
+static void put_le32(unsigned char *bytes, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        bytes[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+/**
+ * 按小端序写出64位整数
+ * @param bytes 输出位置
+ * @param value 整数
+ */
+static void put_le64(unsigned char *bytes, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+/**
+ * 按小端序读取32位整数
+ * @param bytes 输入位置
+ * @return 整数
+ */
+static uint32_t get_le32(const unsigned char *bytes) {
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; i--) {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+/**
+ * 按小端序读取64位整数
+ * @param bytes 输入位置
+ * @return 整数
+ */
+static uint64_t get_le64(const unsigned char *bytes) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+/**
+ * 从套接字读满size字节
+ * @param fd 套接字
+ * @param data 输出缓冲区
+ * @param size 字节数
+ * @return 是否读满（对方关闭连接或出错时返回false）
+ */
+static bool read_full(int fd, void *data, size_t size) {
+    char *bytes = (char *)data;
+    while (size > 0) {
+        ssize_t n = recv(fd, bytes, size, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        bytes += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+/**
+ * 向套接字写出size字节（对方已关闭时不产生SIGPIPE）
+ * @param fd 套接字
+ * @param data 数据
+ * @param size 字节数
+ * @return 是否全部写出
+ */
+static bool write_full(int fd, const void *data, size_t size) {
+    const char *bytes = (const char *)data;
+    while (size > 0) {
+        ssize_t n = send(fd, bytes, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        bytes += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+/**
+ * 写出一个消息头（请求头和回复头格式相同）和随后的内容
+ * @param fd 套接字
+ * @param code 请求类型或回复状态
+ * @param data 内容
+ * @param size 内容长度
+ * @return 是否全部写出
+ */
+static bool send_message(int fd, uint32_t code, const void *data, size_t size) {
+    unsigned char header[LEX_SERVER_HEADER_SIZE];
+    put_le32(header, code);
+    put_le32(header + 4, 0);
+    put_le64(header + 8, size);
+    return write_full(fd, header, sizeof(header)) && (size == 0 || write_full(fd, data, size));
+}
+
+/**
+ * 回复错误信息
+ * @param fd 套接字
+ * @param message 错误信息
+ * @return 是否全部写出
+ */
+static bool send_error(int fd, const char *message) {
+    return send_message(fd, LEX_REPLY_ERROR, message, strlen(message));
+}
+
+/**
+ * 由套接字路径填写Unix域套接字地址
+ * @param socket_path 套接字路径
+ * @param address 输出：套接字地址
+ * @return 路径是否可用（过长时返回false，已输出错误信息）
+ */
+static bool socket_address(const char *socket_path, struct sockaddr_un *address) {
+    memset(address, 0, sizeof(struct sockaddr_un));
+    address->sun_family = AF_UNIX;
+    if (socket_path[0] == '\0' || strlen(socket_path) >= sizeof(address->sun_path)) {
+        fprintf(stderr, "错误: 套接字路径无效或过长 '%s'\n", socket_path);
+        return false;
+    }
+    strcpy(address->sun_path, socket_path);
+    return true;
+}
+
+/**
+ * 连接到服务
+ * @param socket_path 套接字路径
+ * @return 已连接的套接字，失败时返回-1（已输出错误信息）
+ */
+static int connect_server(const char *socket_path) {
+    struct sockaddr_un address;
+    if (!socket_address(socket_path, &address)) {
+        return -1;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+        fprintf(stderr, "错误: 无法连接词法分析服务 '%s'\n", socket_path);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * 把一次分析的结果编码为二进制Token流
+ * @param source 源代码
+ * @param length 源代码长度
+ * @param size 输出：编码后的长度
+ * @param token_count 输出：Token数量（不含EOF）
+ * @return 编码结果（由调用者free）
+ */
+static char *encode_tokens(const char *source, size_t length, size_t *size, long *token_count) {
+    char *output = NULL;
+    FILE *out = open_memstream(&output, size);
+    if (!out) {
+        fprintf(stderr, "内存分配失败: encode_tokens\n");
+        exit(1);
+    }
+    
+    TokenStream stream;
+    lex_all(source, length, &stream);
+    TokenWriter writer;
+    token_writer_init(&writer, out, OUTPUT_BINARY);
+    *token_count = 0;
+    for (int index = 0; ; index++) {
+        Token token;
+        int line, column;
+        token_stream_get(&stream, index, &token);
+        line_index_position(&stream.lines, token.offset, &line, &column);
+        token_writer_write(&writer, &token, line, column);
+        if (token.type == TOKEN_EOF) {
+            break;
+        }
+        (*token_count)++;
+    }
+    token_writer_free(&writer);
+    fclose(out);
+    free_token_stream(&stream);
+    return output;
+}
+
+/**
+ * 分析一段源代码并回复Token流
+ * @param server 服务
+ * @param fd 连接
+ * @param source 源代码
+ * @param length 源代码长度
+ * @return 回复是否全部写出
+ */
+static bool reply_tokens(LexServer *server, int fd, const char *source, size_t length) {
+    size_t size;
+    long token_count;
+    char *output = encode_tokens(source, length, &size, &token_count);
+    bool sent = send_message(fd, LEX_REPLY_OK, output, size);
+    free(output);
+    
+    pthread_mutex_lock(&server->lock);
+    server->summary.requests++;
+    server->summary.token_count += token_count;
+    pthread_mutex_unlock(&server->lock);
+    return sent;
+}
+
+/**
+ * 回复请求失败，并计入失败的请求数
+ * @param server 服务
+ * @param fd 连接
+ * @param message 错误信息
+ * @return 回复是否全部写出
+ */
+static bool reply_failure(LexServer *server, int fd, const char *message) {
+    pthread_mutex_lock(&server->lock);
+    server->summary.requests++;
+    server->summary.failed_requests++;
+    pthread_mutex_unlock(&server->lock);
+    return send_error(fd, message);
+}
+
+/**
+ * 确保工作线程的请求缓冲区至少能容纳size字节
+ * @param worker 工作线程
+ * @param size 字节数
+ */
+static void reserve_buffer(LexServerWorker *worker, size_t size) {
+    if (size <= worker->capacity) {
+        return;
+    }
+    size_t capacity = worker->capacity > 0 ? worker->capacity : 4096;
+    while (capacity < size) {
+        capacity *= 2;
+    }
+    char *buffer = (char *)realloc(worker->buffer, capacity);
+    if (!buffer) {
+        fprintf(stderr, "内存分配失败: reserve_buffer\n");
+        exit(1);
+    }
+    worker->buffer = buffer;
+    worker->capacity = capacity;
+}
+
+/**
+ * 请求处理完后收缩请求缓冲区：超过SERVER_BUFFER_KEEP的部分归还，
+ * 偶尔的大请求不会使每个工作线程一直占用其大小的内存
+ * @param worker 工作线程
+ */
+static void trim_buffer(LexServerWorker *worker) {
+    if (worker->capacity <= SERVER_BUFFER_KEEP) {
+        return;
+    }
+    char *buffer = (char *)realloc(worker->buffer, SERVER_BUFFER_KEEP);
+    if (buffer) {
+        worker->buffer = buffer;
+        worker->capacity = SERVER_BUFFER_KEEP;
+    }
+}
+
+/**
+ * 处理路径请求：映射文件后分析
+ * @param worker 工作线程（请求内容在其缓冲区中，已以'\0'结尾）
+ * @param fd 连接
+ * @param length 路径长度
+ * @return 回复是否全部写出
+ */
+static bool serve_path(LexServerWorker *worker, int fd, size_t length) {
+    const char *path = worker->buffer;
+    SourceFile file;
+    // "-"对服务而言是它自己的标准输入，不接受
+    if (memchr(path, '\0', length) || strcmp(path, "-") == 0 || !source_file_open(&file, path)) {
+        char message[LEX_SERVER_MAX_PATH + 64];
+        snprintf(message, sizeof(message), "无法读取文件 '%s'", path);
+        return reply_failure(worker->server, fd, message);
+    }
+    bool sent = reply_tokens(worker->server, fd, file.data, file.length);
+    source_file_close(&file);
+    return sent;
+}
+
+/**
+ * 请求停止服务：唤醒在sigwait中等待的调用线程
+ * @param server 服务
+ */
+static void request_stop(LexServer *server) {
+    pthread_kill(server->main_thread, SIGTERM);
+}
+
+/**
+ * 处理一个连接上的全部请求，直到对方关闭连接、请求无效或服务停止
+ * @param worker 工作线程
+ * @param fd 连接
+ */
+static void serve_connection(LexServerWorker *worker, int fd) {
+    LexServer *server = worker->server;
+    unsigned char header[LEX_SERVER_HEADER_SIZE];
+    while (read_full(fd, header, sizeof(header))) {
+        uint32_t kind = get_le32(header);
+        uint64_t length = get_le64(header + 8);
+        
+        if (kind == LEX_REQUEST_SHUTDOWN) {
+            send_message(fd, LEX_REPLY_OK, NULL, 0);
+            request_stop(server);
+            return;
+        }
+        if ((kind != LEX_REQUEST_PATH && kind != LEX_REQUEST_BUFFER) ||
+            (kind == LEX_REQUEST_PATH && (length == 0 || length > LEX_SERVER_MAX_PATH)) ||
+            length > LEX_SERVER_MAX_BUFFER) {
+            reply_failure(server, fd, "无效的请求");
+            return;
+        }
+        
+        reserve_buffer(worker, (size_t)length + 1);
+        bool sent = false;
+        if (read_full(fd, worker->buffer, (size_t)length)) {
+            worker->buffer[length] = '\0';
+            sent = kind == LEX_REQUEST_PATH
+                ? serve_path(worker, fd, (size_t)length)
+                : reply_tokens(server, fd, worker->buffer, (size_t)length);
+        }
+        trim_buffer(worker);
+        if (!sent) {
+            return;
+        }
+    }
+}
+
+/**
+ * 工作线程：不断接受连接并处理，直到服务停止
+ * @param arg 工作线程参数（LexServerWorker）
+ * @return NULL
+ */
+static void *server_worker(void *arg) {
+    LexServerWorker *worker = (LexServerWorker *)arg;
+    LexServer *server = worker->server;
+    
+    while (1) {
+        int fd = accept(server->listen_fd, NULL, NULL);
+        pthread_mutex_lock(&server->lock);
+        bool stopping = server->stopping;
+        if (fd >= 0 && !stopping) {
+            server->connections[worker->id] = fd;
+            server->summary.connections++;
+        }
+        pthread_mutex_unlock(&server->lock);
+        
+        if (fd < 0) {
+            if (stopping) {
+                break;
+            }
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            fprintf(stderr, "错误: 接受连接失败: %s\n", strerror(errno));
+            break;
+        }
+        if (stopping) {
+            close(fd);
+            break;
+        }
+        
+        // 收发超时后recv/send失败，read_full/write_full返回false，连接随之关闭
+        struct timeval timeout = { SERVER_IO_TIMEOUT, 0 };
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        serve_connection(worker, fd);
+        
+        pthread_mutex_lock(&server->lock);
+        server->connections[worker->id] = -1;
+        pthread_mutex_unlock(&server->lock);
+        close(fd);
+    }
+    return NULL;
+}
+
+/**
+ * 绑定前清理旧的套接字文件：已有服务在监听时报错，
+ * 无人监听的套接字文件（服务异常退出后残留）直接删除
+ * @param socket_path 套接字路径
+ * @param address 套接字地址
+ * @return 是否可以绑定（已有服务时返回false，已输出错误信息）
+ */
+static bool remove_stale_socket(const char *socket_path, const struct sockaddr_un *address) {
+    struct stat info;
+    if (stat(socket_path, &info) != 0 || !S_ISSOCK(info.st_mode)) {
+        return true;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    bool alive = fd >= 0 && connect(fd, (const struct sockaddr *)address, sizeof(*address)) == 0;
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (alive) {
+        fprintf(stderr, "错误: 已有词法分析服务在监听 '%s'\n", socket_path);
+        return false;
+    }
+    unlink(socket_path);
+    return true;
+}
+
+/**
+ * 运行常驻词法分析服务，直到收到停止请求、SIGINT或SIGTERM
+ * 结束时删除套接字文件。
+ * @param socket_path 套接字路径
+ * @param num_threads 工作线程数（会被限制在1到MAX_LEX_THREADS之间）
+ * @param summary 输出：汇总结果
+ * @return 服务是否成功启动（套接字无法创建或绑定时返回false，已输出错误信息）
+ */
+bool lex_server_run(const char *socket_path, int num_threads, LexServerSummary *summary) {
+    memset(summary, 0, sizeof(LexServerSummary));
+    if (num_threads > MAX_LEX_THREADS) {
+        num_threads = MAX_LEX_THREADS;
+    }
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+    
+    struct sockaddr_un address;
+    if (!socket_address(socket_path, &address) || !remove_stale_socket(socket_path, &address)) {
+        return false;
+    }
+    // 套接字文件只允许本用户连接（权限0600）；此时还没有创建工作线程，可以临时改umask
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    mode_t old_mask = umask(0177);
+    bool bound = listen_fd >= 0 && bind(listen_fd, (struct sockaddr *)&address, sizeof(address)) == 0;
+    umask(old_mask);
+    if (!bound || listen(listen_fd, SOMAXCONN) != 0) {
+        fprintf(stderr, "错误: 无法在 '%s' 上监听: %s\n", socket_path, strerror(errno));
+        if (listen_fd >= 0) {
+            close(listen_fd);
+        }
+        return false;
+    }
+    
+    LexServer server;
+    memset(&server, 0, sizeof(LexServer));
+    server.listen_fd = listen_fd;
+    server.main_thread = pthread_self();
+    server.connections = (int *)malloc(num_threads * sizeof(int));
+    pthread_t *threads = (pthread_t *)malloc(num_threads * sizeof(pthread_t));
+    LexServerWorker *workers = (LexServerWorker *)calloc(num_threads, sizeof(LexServerWorker));
+    if (!server.connections || !threads || !workers) {
+        fprintf(stderr, "内存分配失败: lex_server_run\n");
+        exit(1);
+    }
+    pthread_mutex_init(&server.lock, NULL);
+    
+    // 工作线程继承屏蔽字，信号只由调用线程在sigwait中接收
+    sigset_t signals, saved;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, &saved);
+    
+    for (int t = 0; t < num_threads; t++) {
+        server.connections[t] = -1;
+        workers[t].server = &server;
+        workers[t].id = t;
+        if (pthread_create(&threads[t], NULL, server_worker, &workers[t]) != 0) {
+            fprintf(stderr, "错误: 无法创建工作线程\n");
+            exit(1);
+        }
+    }
+    fprintf(stderr, "词法分析服务已启动: %s（%d 个工作线程）\n", socket_path, num_threads);
+    
+    int signal_number;
+    while (sigwait(&signals, &signal_number) != 0) {
+    }
+    
+    // 唤醒阻塞在accept和recv中的工作线程
+    pthread_mutex_lock(&server.lock);
+    server.stopping = true;
+    for (int t = 0; t < num_threads; t++) {
+        if (server.connections[t] >= 0) {
+            shutdown(server.connections[t], SHUT_RD);
+        }
+    }
+    pthread_mutex_unlock(&server.lock);
+    shutdown(listen_fd, SHUT_RDWR);
+    
+    for (int t = 0; t < num_threads; t++) {
+        pthread_join(threads[t], NULL);
+        free(workers[t].buffer);
+    }
+    close(listen_fd);
+    unlink(socket_path);
+    pthread_sigmask(SIG_SETMASK, &saved, NULL);
+    
+    *summary = server.summary;
+    pthread_mutex_destroy(&server.lock);
+    free(server.connections);
+    free(threads);
+    free(workers);
+    return true;
+}
+
+/**
+ * 读取一条回复
+ * @param fd 连接
+ * @param status 输出：回复状态
+ * @param size 输出：内容长度
+ * @return 回复内容（由调用者free），连接中断或回复无效时返回NULL
+ */
+static char *receive_reply(int fd, uint32_t *status, size_t *size) {
+    unsigned char header[LEX_SERVER_HEADER_SIZE];
+    if (!read_full(fd, header, sizeof(header))) {
+        return NULL;
+    }
+    *status = get_le32(header);
+    uint64_t length = get_le64(header + 8);
+    if (length > SIZE_MAX - 1) {
+        return NULL;
+    }
+    *size = (size_t)length;
+    char *data = (char *)malloc(*size + 1);
+    if (!data) {
+        fprintf(stderr, "内存分配失败: receive_reply\n");
+        exit(1);
+    }
+    if (!read_full(fd, data, *size)) {
+        free(data);
+        return NULL;
+    }
+    data[*size] = '\0';
+    return data;
+}
+
+/**
+ * 发送一个文件的分析请求：普通文件发送绝对路径，由服务直接映射；
+ * "-"读入标准输入后连同内容一起发送
+ * @param fd 连接
+ * @param filename 文件名
+ * @return 请求是否已发送（文件无法读取时返回false，已输出错误信息）
+ */
+static bool send_file_request(int fd, const char *filename) {
+    if (strcmp(filename, "-") == 0) {
+        SourceFile file;
+        if (!source_file_open(&file, filename)) {
+            return false;
+        }
+        bool sent = send_message(fd, LEX_REQUEST_BUFFER, file.data, file.length);
+        source_file_close(&file);
+        return sent;
+    }
+    
+    // 服务的工作目录可能不同，相对路径先补上当前目录
+    char path[LEX_SERVER_MAX_PATH + 1];
+    size_t used = 0;
+    if (filename[0] != '/') {
+        if (!getcwd(path, sizeof(path))) {
+            path[0] = '\0';
+        }
+        used = strlen(path);
+        if (used > 0 && path[used - 1] != '/' && used < sizeof(path) - 1) {
+            path[used++] = '/';
+        }
+    }
+    size_t length = strlen(filename);
+    if (used + length > LEX_SERVER_MAX_PATH) {
+        fprintf(stderr, "错误: 文件路径过长 '%s'\n", filename);
+        return false;
+    }
+    memcpy(path + used, filename, length);
+    return send_message(fd, LEX_REQUEST_PATH, path, used + length);
+}
+
+/**
+ * 请求服务分析多个文件，在同一连接上依次发送，
+ * 各文件的二进制Token流按顺序写到out
+ * @param socket_path 套接字路径
+ * @param filenames 文件名数组（"-"表示标准输入）
+ * @param num_files 文件数量
+ * @param out 输出流
+ * @return 是否全部成功（失败的文件已输出错误信息，其余文件照常输出）
+ */
+bool lex_server_request(const char *socket_path, const char *const *filenames, int num_files,
+                        FILE *out) {
+    int fd = connect_server(socket_path);
+    if (fd < 0) {
+        return false;
+    }
+    
+    bool ok = true;
+    for (int i = 0; i < num_files; i++) {
+        if (!send_file_request(fd, filenames[i])) {
+            ok = false;
+            continue;
+        }
+        uint32_t status;
+        size_t size;
+        char *reply = receive_reply(fd, &status, &size);
+        if (!reply) {
+            fprintf(stderr, "错误: 词法分析服务中断了连接\n");
+            ok = false;
+            break;
+        }
+        if (status == LEX_REPLY_OK) {
+            fwrite(reply, 1, size, out);
+        } else {
+            fprintf(stderr, "错误: %s\n", reply);
+            ok = false;
+        }
+        free(reply);
+    }
+    fflush(out);
+    close(fd);
+    return ok;
+}
+
+/**
+ * 请求服务停止
+ * @param socket_path 套接字路径
+ * @return 服务是否已确认
+ */
+bool lex_server_shutdown(const char *socket_path) {
+    int fd = connect_server(socket_path);
+    if (fd < 0) {
+        return false;
+    }
+    uint32_t status;
+    size_t size;
+    char *reply = NULL;
+    if (send_message(fd, LEX_REQUEST_SHUTDOWN, NULL, 0)) {
+        reply = receive_reply(fd, &status, &size);
+    }
+    close(fd);
+    if (!reply) {
+        fprintf(stderr, "错误: 词法分析服务没有确认停止请求\n");
+        return false;
+    }
+    free(reply);
+    return status == LEX_REPLY_OK;
+}
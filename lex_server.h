@@ -0,0 +1,59 @@
+/**
+ * lex_server.h - 常驻词法分析服务头文件
+ *
+ * 构建系统逐个文件调用编译器时，每次调用都要重新启动进程、映射可执行文件、
+ * 创建线程；常驻服务只启动一次，工作线程和各线程的缓冲区（不超过1MB）一直保留，
+ * 请求经Unix域套接字送达，结果以二进制Token格式（见token_output.h）返回。
+ * 同一连接上可以依次发送任意多个请求。
+ *
+ * 协议（所有整数为小端序）：
+ *   请求  u32 kind  u32 保留（0）  u64 length，之后紧跟length字节的内容：
+ *         LEX_REQUEST_PATH     文件路径（不含'\0'，相对路径相对于服务的工作目录）
+ *         LEX_REQUEST_BUFFER   源代码
+ *         LEX_REQUEST_SHUTDOWN 无内容，服务回复后退出
+ *   回复  u32 status  u32 保留（0）  u64 length，之后紧跟length字节的内容：
+ *         LEX_REPLY_OK    "C0TOKEN\1"开头的完整Token流，与 -t --format=binary 的输出相同
+ *         LEX_REPLY_ERROR 错误信息（UTF-8，不含'\0'）
+ * 请求无效（类型未知、长度超出上限）时回复错误后关闭连接；收发停滞超过30秒的连接
+ * 直接关闭。套接字文件的权限为0600，只有启动服务的用户可以连接。
+ */
+
+#ifndef LEX_SERVER_H
+#define LEX_SERVER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LEX_SERVER_HEADER_SIZE 16       // 请求头和回复头的字节数
+#define LEX_SERVER_MAX_PATH 4096        // 路径请求的最大长度
+#define LEX_SERVER_MAX_BUFFER ((uint64_t)1 << 31) // 源代码请求的最大长度（Token偏移为32位）
+
+/* 请求类型 */
+typedef enum {
+    LEX_REQUEST_PATH = 1,       // 分析服务端可以读取的文件
+    LEX_REQUEST_BUFFER = 2,     // 分析随请求发送的源代码
+    LEX_REQUEST_SHUTDOWN = 3    // 停止服务
+} LexRequestKind;
+
+/* 回复状态 */
+typedef enum {
+    LEX_REPLY_OK = 0,           // 内容为二进制Token流
+    LEX_REPLY_ERROR = 1         // 内容为错误信息
+} LexReplyStatus;
+
+/* 服务的汇总结果 */
+typedef struct {
+    long connections;       // 接受的连接数
+    long requests;          // 处理的分析请求数
+    long failed_requests;   // 失败的请求数（文件无法读取、请求无效）
+    long token_count;       // 返回的Token总数（不含EOF）
+} LexServerSummary;
+
+/* 常驻词法分析服务函数 */
+bool lex_server_run(const char *socket_path, int num_threads, LexServerSummary *summary);
+bool lex_server_request(const char *socket_path, const char *const *filenames, int num_files,
+                        FILE *out);
+bool lex_server_shutdown(const char *socket_path);
+
+#endif /* LEX_SERVER_H */
@@ -0,0 +1,215 @@
+/**
+ * lex_stats.c - 词法分析统计实现
+ *
+ * 计时使用单调时钟，峰值内存取自getrusage。
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "lex_stats.h"
+#include "nfa_dfa.h"
+#include "scanner.h"
+#include "source_file.h"
+
+/**
+ * 取单调时钟（秒）
+ * @return 当前时刻
+ */
+double lex_stats_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * 初始化统计（全部清零）
+ * @param stats 统计
+ */
+void lex_stats_init(LexStats *stats) {
+    memset(stats, 0, sizeof(LexStats));
+}
+
+/**
+ * 计入一个Token（EOF不计入）
+ * @param stats 统计
+ * @param type Token类型
+ */
+void lex_stats_count_token(LexStats *stats, TokenType type) {
+    if (type == TOKEN_EOF) {
+        return;
+    }
+    stats->type_counts[type]++;
+    stats->token_count++;
+    if (type == TOKEN_ERROR) {
+        stats->error_count++;
+    }
+}
+
+/**
+ * 计入Token流中的全部Token和Token流的内存
+ * @param stats 统计
+ * @param stream Token流
+ */
+void lex_stats_count_stream(LexStats *stats, const TokenStream *stream) {
+    for (int i = 0; i < stream->count; i++) {
+        lex_stats_count_token(stats, (TokenType)stream->types[i]);
+    }
+    stats->array_allocations += stream->allocations;
+    stats->array_bytes += (size_t)stream->capacity *
+                          (sizeof(uint8_t) + 2 * sizeof(uint32_t) + sizeof(int)) +
+                          (size_t)stream->value_capacity * sizeof(TokenValue) +
+                          (size_t)stream->message_capacity * sizeof(const char *);
+    lex_stats_count_arena(stats, &stream->arena);
+}
+
+/**
+ * 计入区域分配器的内存块
+ * @param stats 统计
+ * @param arena 区域分配器
+ */
+void lex_stats_count_arena(LexStats *stats, const Arena *arena) {
+    for (const ArenaBlock *block = arena->head; block; block = block->next) {
+        stats->arena_blocks++;
+    }
+    stats->arena_bytes += arena->total;
+}
+
+/**
+ * 结束统计：记录进程的峰值常驻内存
+ * @param stats 统计
+ */
+void lex_stats_finish(LexStats *stats) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        stats->peak_rss_kb = usage.ru_maxrss;
+    }
+}
+
+/**
+ * 读入并分析一个文件，只统计不输出
+ * @param filename 源文件名（"-"表示标准输入）
+ * @param stats 输出：统计
+ * @return 文件能否读取
+ */
+bool lex_stats_file(const char *filename, LexStats *stats) {
+    lex_stats_init(stats);
+    
+    double start = lex_stats_now();
+    SourceFile file;
+    if (!source_file_open(&file, filename)) {
+        return false;
+    }
+    stats->bytes = file.length;
+    stats->read_seconds = lex_stats_now() - start;
+    
+    start = lex_stats_now();
+    TokenStream stream;
+    lex_all(file.data, file.length, &stream);
+    stats->lex_seconds = lex_stats_now() - start;
+    
+    lex_stats_count_stream(stats, &stream);
+    free_token_stream(&stream);
+    source_file_close(&file);
+    lex_stats_finish(stats);
+    return true;
+}
+
+/**
+ * 由全部Token规则构造NFA、DFA和最简DFA，记录状态数和各步耗时
+ * （-t使用预生成的扫描表，平时不经过这些步骤）
+ * @param stats 输出：自动机统计
+ */
+void automaton_stats_collect(AutomatonStats *stats) {
+    memset(stats, 0, sizeof(AutomatonStats));
+    
+    double start = lex_stats_now();
+    NFA *nfa = create_nfa_for_c0_tokens();
+    stats->nfa_seconds = lex_stats_now() - start;
+    stats->nfa_states = nfa->num_states;
+    stats->nfa_transitions = nfa->num_transitions;
+    
+    start = lex_stats_now();
+    DFA *dfa = nfa_to_dfa(nfa);
+    stats->subset_seconds = lex_stats_now() - start;
+    stats->dfa_states = dfa->num_states;
+    stats->alphabet_size = dfa->alphabet_size;
+    
+    start = lex_stats_now();
+    DFA *min_dfa = minimize_dfa(dfa);
+    stats->minimize_seconds = lex_stats_now() - start;
+    stats->min_dfa_states = min_dfa->num_states;
+    
+    free_dfa(min_dfa);
+    free_dfa(dfa);
+    free_nfa(nfa);
+}
+
+/**
+ * 按速率输出（耗时过短无法计算时输出"-"）
+ */
+static void print_rate(FILE *out, const char *label, double amount, double seconds,
+                       const char *unit) {
+    if (seconds > 0) {
+        fprintf(out, "%s %.1f %s\n", label, amount / seconds, unit);
+    } else {
+        fprintf(out, "%s - %s\n", label, unit);
+    }
+}
+
+/**
+ * 输出统计
+ * @param out 输出流
+ * @param stats 词法分析统计
+ * @param automata 自动机统计（NULL表示不输出）
+ */
+void lex_stats_print(FILE *out, const LexStats *stats, const AutomatonStats *automata) {
+    fprintf(out, "\n========================================\n");
+    fprintf(out, "          词法分析统计\n");
+    fprintf(out, "========================================\n");
+    fprintf(out, "读入:   %10.3f ms\n", stats->read_seconds * 1e3);
+    fprintf(out, "分析:   %10.3f ms%s\n", stats->lex_seconds * 1e3,
+            stats->cache_hit ? "（缓存命中）" : "");
+    fprintf(out, "输出:   %10.3f ms\n", stats->output_seconds * 1e3);
+    fprintf(out, "字节数: %zu\n", stats->bytes);
+    fprintf(out, "Token:  %ld（错误 %ld）\n", stats->token_count, stats->error_count);
+    print_rate(out, "分析速度:", stats->bytes / (1024.0 * 1024.0), stats->lex_seconds, "MB/s");
+    print_rate(out, "         ", (double)stats->token_count, stats->lex_seconds, "Token/s");
+    if (stats->token_count > 0) {
+        fprintf(out, "         %.2f ns/Token\n", stats->lex_seconds * 1e9 / stats->token_count);
+    }
+    
+    fprintf(out, "\n各类Token:\n");
+    for (int type = 0; type < NUM_TOKEN_TYPES; type++) {
+        if (stats->type_counts[type] == 0) {
+            continue;
+        }
+        fprintf(out, "  %-20s %10ld  %5.1f%%\n", token_type_to_string((TokenType)type),
+                stats->type_counts[type], 100.0 * stats->type_counts[type] / stats->token_count);
+    }
+    
+    fprintf(out, "\n内存:\n");
+    fprintf(out, "  区域分配器: %d 块，已分配 %zu 字节\n", stats->arena_blocks, stats->arena_bytes);
+    fprintf(out, "  Token流数组: %d 次分配（含扩容），%zu 字节\n",
+            stats->array_allocations, stats->array_bytes);
+    if (stats->token_count > 0) {
+        fprintf(out, "  分配次数/Token: %.6f\n",
+                (double)(stats->arena_blocks + stats->array_allocations) / stats->token_count);
+    }
+    fprintf(out, "  峰值常驻内存: %ld KB\n", stats->peak_rss_kb);
+    
+    if (automata) {
+        fprintf(out, "\n自动机（由全部Token规则构造）:\n");
+        fprintf(out, "  NFA:     %6d 状态  %6d 转换  %10.3f ms\n",
+                automata->nfa_states, automata->nfa_transitions, automata->nfa_seconds * 1e3);
+        fprintf(out, "  DFA:     %6d 状态  %6d 等价类 %9.3f ms（子集构造）\n",
+                automata->dfa_states, automata->alphabet_size, automata->subset_seconds * 1e3);
+        fprintf(out, "  最简DFA: %6d 状态  %17.3f ms（最简化）\n",
+                automata->min_dfa_states, automata->minimize_seconds * 1e3);
+    }
+    fprintf(out, "========================================\n");
+}
@@ -0,0 +1,61 @@
+/**
+ * lex_stats.h - 词法分析统计头文件
+ *
+ * 记录一次词法分析各阶段的耗时（读入、分析、输出）、吞吐量、各类Token的数量、
+ * 内存使用和分配次数，以及由规则表构造自动机的状态数和耗时。
+ * 供--stats输出，也可由调用者直接取得统计结构。
+ */
+
+#ifndef LEX_STATS_H
+#define LEX_STATS_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "token.h"
+#include "arena.h"
+#include "lexer.h"
+
+#define NUM_TOKEN_TYPES (TOKEN_ERROR + 1)  // Token类型数量
+
+/* 一次词法分析的统计 */
+typedef struct {
+    double read_seconds;    // 读入（映射）源文件的耗时
+    double lex_seconds;     // 词法分析的耗时
+    double output_seconds;  // 输出Token的耗时
+    size_t bytes;           // 源代码字节数
+    long token_count;       // Token数量（不含EOF）
+    long error_count;       // 词法错误数量
+    long type_counts[NUM_TOKEN_TYPES]; // 各类Token的数量
+    int arena_blocks;       // 区域分配器的内存块数（每块一次分配）
+    size_t arena_bytes;     // 从区域分配器分配出去的字节数
+    int array_allocations;  // Token流数组的分配次数（按容量估计，含扩容）
+    size_t array_bytes;     // Token流数组的字节数
+    long peak_rss_kb;       // 进程的峰值常驻内存（KB）
+    bool cache_hit;         // Token流是否来自缓存
+} LexStats;
+
+/* 由规则表构造自动机的统计 */
+typedef struct {
+    int nfa_states;         // NFA状态数
+    int nfa_transitions;    // NFA转换数
+    int dfa_states;         // 子集构造得到的DFA状态数
+    int min_dfa_states;     // 最简DFA状态数
+    int alphabet_size;      // 字节等价类数量
+    double nfa_seconds;     // 构造NFA的耗时
+    double subset_seconds;  // 子集构造的耗时
+    double minimize_seconds; // 最简化的耗时
+} AutomatonStats;
+
+/* 统计函数 */
+double lex_stats_now();
+void lex_stats_init(LexStats *stats);
+void lex_stats_count_token(LexStats *stats, TokenType type);
+void lex_stats_count_stream(LexStats *stats, const TokenStream *stream);
+void lex_stats_count_arena(LexStats *stats, const Arena *arena);
+void lex_stats_finish(LexStats *stats);
+bool lex_stats_file(const char *filename, LexStats *stats);
+void automaton_stats_collect(AutomatonStats *stats);
+void lex_stats_print(FILE *out, const LexStats *stats, const AutomatonStats *automata);
+
+#endif /* LEX_STATS_H */
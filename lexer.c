@@ -13,35 +13,102 @@
  */
 
 #include "lexer.h"
+#include "simd_scan.h"
+
+/**
+ * 初始化词法分析器状态（源代码在length之内不含'\0'）
+ * @param lexer 词法分析器指针
+ * @param source 源代码
+ * @param length 源代码长度
+ */
+static void lexer_init_text(Lexer *lexer, const char *source, size_t length) {
+    lexer->source = source;
+    lexer->pos = 0;
+    lexer->length = length;
+    lexer->current_char = length > 0 ? source[0] : '\0';
+    lexer->table = NULL;
+    lexer->direct = false;
+    lexer->lazy = NULL;
+    arena_init(&lexer->arena);
+    line_index_init(&lexer->lines, source, length);
+    symbol_table_init(&lexer->symbols);
+}
+
+/**
+ * 初始化词法分析器状态
+ * 源代码在第一个'\0'处结束，与手写扫描遇到'\0'即结束一致
+ * @param lexer 词法分析器指针
+ * @param source 源代码
+ * @param length 源代码长度
+ */
+static void lexer_init(Lexer *lexer, const char *source, size_t length) {
+    const char *nul = (const char *)memchr(source, '\0', length);
+    if (nul) {
+        length = (size_t)(nul - source);
+    }
+    lexer_init_text(lexer, source, length);
+}
 
 /**
  * 创建词法分析器
- * @param source 源代码字符串
+ * @param source 源代码（无需以'\0'结尾）
+ * @param length 源代码长度
  * @return 新创建的词法分析器指针
  */
-Lexer *create_lexer(const char *source) {
+Lexer *create_lexer(const char *source, size_t length) {
     Lexer *lexer = (Lexer *)malloc(sizeof(Lexer));
     if (!lexer) {
         fprintf(stderr, "内存分配失败: create_lexer\n");
         exit(1);
     }
     
-    lexer->source = source;
-    lexer->pos = 0;
-    lexer->length = strlen(source);
-    lexer->line = 1;
-    lexer->column = 1;
-    lexer->current_char = source[0];
-    
+    lexer_init(lexer, source, length);
     return lexer;
 }
 
 /**
- * 释放词法分析器内存
+ * 切换到表驱动扫描模式
+ * @param lexer 词法分析器指针
+ * @param table 扫描表（NULL表示恢复手写扫描）
+ */
+void lexer_use_table(Lexer *lexer, const ScanTable *table) {
+    lexer->table = table;
+    lexer->direct = false;
+    lexer->lazy = NULL;
+}
+
+/**
+ * 切换到直接编码的表驱动扫描（C0规则）：最长匹配由c0_direct_match完成，
+ * 不再逐字节查转换表，识别结果与lexer_use_table(lexer, get_c0_scan_table())相同
+ * @param lexer 词法分析器指针
+ */
+void lexer_use_direct(Lexer *lexer) {
+    lexer->table = get_c0_scan_table();
+    lexer->direct = true;
+    lexer->lazy = NULL;
+}
+
+/**
+ * 切换到由惰性DFA做最长匹配的表驱动扫描（C0规则）：DFA状态在扫描时按需构造，
+ * 缓存不超过惰性DFA的内存预算，识别结果与lexer_use_table(lexer, get_c0_scan_table())相同
+ * @param lexer 词法分析器指针
+ * @param lazy 由create_nfa_for_c0_tokens的NFA初始化的惰性DFA（可在多个词法分析器间依次复用）
+ */
+void lexer_use_lazy(Lexer *lexer, LazyDFA *lazy) {
+    lexer->table = get_c0_scan_table();
+    lexer->direct = false;
+    lexer->lazy = lazy;
+}
+
+/**
+ * 释放词法分析器内存，包括它创建的所有Token
  * @param lexer 词法分析器指针
  */
 void free_lexer(Lexer *lexer) {
     if (lexer) {
+        arena_free(&lexer->arena);
+        line_index_free(&lexer->lines);
+        symbol_table_free(&lexer->symbols);
         free(lexer);
     }
 }
@@ -52,12 +119,6 @@ void free_lexer(Lexer *lexer) {
  */
 void advance(Lexer *lexer) {
     if (lexer->pos < lexer->length) {
-        if (lexer->current_char == '\n') {
-            lexer->line++;
-            lexer->column = 1;
-        } else {
-            lexer->column++;
-        }
         lexer->pos++;
         if (lexer->pos < lexer->length) {
             lexer->current_char = lexer->source[lexer->pos];
@@ -79,14 +140,22 @@ char peek(Lexer *lexer) {
     return '\0';
 }
 
+/**
+ * 直接前进到指定位置
+ * @param lexer 词法分析器指针
+ * @param end 目标位置
+ */
+static void advance_to(Lexer *lexer, size_t end) {
+    lexer->pos = end;
+    lexer->current_char = end < lexer->length ? lexer->source[end] : '\0';
+}
+
 /**
  * 跳过空白字符
  * @param lexer 词法分析器指针
  */
 void skip_whitespace(Lexer *lexer) {
-    while (lexer->current_char != '\0' && isspace(lexer->current_char)) {
-        advance(lexer);
-    }
+    advance_to(lexer, simd_skip_whitespace(lexer->source, lexer->pos, lexer->length));
 }
 
 /**
@@ -94,14 +163,8 @@ void skip_whitespace(Lexer *lexer) {
  * @param lexer 词法分析器指针
  */
 void skip_line_comment(Lexer *lexer) {
-    // 跳过 '//'
-    advance(lexer);
-    advance(lexer);
-    
-    // 读取到行尾或文件结束
-    while (lexer->current_char != '\0' && lexer->current_char != '\n') {
-        advance(lexer);
-    }
+    // 跳过 '//'，读取到行尾或文件结束
+    advance_to(lexer, simd_find_line_end(lexer->source, lexer->pos + 2, lexer->length));
     
     // 如果是换行符，跳过它
     if (lexer->current_char == '\n') {
@@ -114,18 +177,10 @@ void skip_line_comment(Lexer *lexer) {
  * @param lexer 词法分析器指针
  */
 void skip_block_comment(Lexer *lexer) {
-    // 跳过 '/*'
-    advance(lexer);
-    advance(lexer);
-    
-    // 读取到 '*/' 或文件结束
-    while (lexer->current_char != '\0') {
-        if (lexer->current_char == '*' && peek(lexer) == '/') {
-            advance(lexer); // 跳过 '*'
-            advance(lexer); // 跳过 '/'
-            break;
-        }
-        advance(lexer);
+    // 跳过 '/*'，读取到 '*/' 或文件结束
+    advance_to(lexer, simd_find_comment_end(lexer->source, lexer->pos + 2, lexer->length));
+    if (lexer->current_char == '*') {
+        advance_to(lexer, lexer->pos + 2);  // 跳过 '*/'
     }
 }
 
@@ -136,27 +191,63 @@ void skip_block_comment(Lexer *lexer) {
  * @return Token指针
  */
 Token *read_identifier(Lexer *lexer) {
-    int start_line = lexer->line;
-    int start_column = lexer->column;
     size_t start_pos = lexer->pos;
     
     // 读取标识符：字母、数字、下划线
-    while (lexer->current_char != '\0' && 
-           (isalnum(lexer->current_char) || lexer->current_char == '_')) {
-        advance(lexer);
-    }
+    advance_to(lexer, simd_identifier_end(lexer->source, lexer->pos, lexer->length));
     
-    // 提取标识符字符串
+    // 词素直接引用源代码，检查是否为关键字
+    const char *identifier = lexer->source + start_pos;
     size_t length = lexer->pos - start_pos;
-    char *identifier = (char *)malloc(length + 1);
-    strncpy(identifier, lexer->source + start_pos, length);
-    identifier[length] = '\0';
-    
-    // 检查是否为关键字
-    TokenType type = lookup_keyword(identifier);
-    Token *token = create_token(type, identifier, start_line, start_column);
-    
-    free(identifier);
+    TokenType type = lookup_keyword(identifier, length);
+    return create_token(&lexer->arena, type, identifier, length, start_pos);
+}
+
+/* 整型常量溢出时的错误信息 */
+static const char INT_OVERFLOW_MESSAGE[] = "整数常量超出范围";
+
+/**
+ * 判断Token类型是否为数值常量（延迟转换模式下分析时不计算值）
+ */
+static bool is_number_type(TokenType type) {
+    return type == TOKEN_INT_CONST || type == TOKEN_DOUBLE_CONST;
+}
+
+/**
+ * 计算数字词素的值：直接在源代码中的词素上转换，不复制词素
+ * @param number_str 数字词素起始地址
+ * @param length 词素长度
+ * @param is_float 是否为浮点数
+ * @param value 输出：常量值
+ * @return 转换结果（整数超出范围时为NUMBER_OVERFLOW，浮点数溢出为无穷大）
+ */
+static NumberStatus decode_number(const char *number_str, size_t length, int is_float,
+                                  TokenValue *value) {
+    if (is_float) {
+        return parse_double_literal(number_str, length, &value->double_value);
+    }
+    return parse_int_literal(number_str, length, &value->int_value);
+}
+
+/**
+ * 根据源代码中的数字词素创建常量Token并计算其值
+ * 整数超出long long范围时返回错误Token（浮点数溢出为无穷大，与atof一致）
+ * @param arena Token所在的区域分配器
+ * @param number_str 数字词素起始地址
+ * @param length 词素长度
+ * @param is_float 是否为浮点数
+ * @param offset Token在源代码中的字节偏移
+ * @return Token指针
+ */
+static Token *create_number_token(Arena *arena, const char *number_str, size_t length,
+                                  int is_float, size_t offset) {
+    TokenValue value;
+    if (decode_number(number_str, length, is_float, &value) == NUMBER_OVERFLOW && !is_float) {
+        return create_error_token(arena, INT_OVERFLOW_MESSAGE, offset);
+    }
+    Token *token = create_token(arena, is_float ? TOKEN_DOUBLE_CONST : TOKEN_INT_CONST,
+                                number_str, length, offset);
+    token->value = value;
     return token;
 }
 
@@ -171,15 +262,11 @@ Token *read_identifier(Lexer *lexer) {
  * @return Token指针
  */
 Token *read_number(Lexer *lexer) {
-    int start_line = lexer->line;
-    int start_column = lexer->column;
     size_t start_pos = lexer->pos;
     int is_float = 0;
-    int is_hex = 0;
     
     // 检查是否为16进制数 (0x 或 0X)
     if (lexer->current_char == '0' && (peek(lexer) == 'x' || peek(lexer) == 'X')) {
-        is_hex = 1;
         advance(lexer); // 跳过 '0'
         advance(lexer); // 跳过 'x' 或 'X'
         
@@ -221,28 +308,8 @@ Token *read_number(Lexer *lexer) {
         }
     }
     
-    // 提取数字字符串
-    size_t length = lexer->pos - start_pos;
-    char *number_str = (char *)malloc(length + 1);
-    strncpy(number_str, lexer->source + start_pos, length);
-    number_str[length] = '\0';
-    
-    // 创建Token
-    Token *token;
-    if (is_float) {
-        token = create_token(TOKEN_DOUBLE_CONST, number_str, start_line, start_column);
-        token->value.double_value = atof(number_str);
-    } else {
-        token = create_token(TOKEN_INT_CONST, number_str, start_line, start_column);
-        if (is_hex) {
-            token->value.int_value = strtoll(number_str, NULL, 16);
-        } else {
-            token->value.int_value = atoll(number_str);
-        }
-    }
-    
-    free(number_str);
-    return token;
+    return create_number_token(&lexer->arena, lexer->source + start_pos,
+                               lexer->pos - start_pos, is_float, start_pos);
 }
 
 /**
@@ -252,44 +319,48 @@ Token *read_number(Lexer *lexer) {
  * @return Token指针
  */
 Token *read_string(Lexer *lexer) {
-    int start_line = lexer->line;
-    int start_column = lexer->column;
     size_t start_pos = lexer->pos;
     
     advance(lexer); // 跳过开头的引号
     
     // 读取字符串内容，直到遇到结束引号或文件结束
-    while (lexer->current_char != '\0' && lexer->current_char != '"') {
-        if (lexer->current_char == '\\') {
-            advance(lexer); // 跳过转义符
-            if (lexer->current_char != '\0') {
-                advance(lexer); // 跳过被转义的字符
-            }
-        } else {
-            advance(lexer);
+    while (1) {
+        advance_to(lexer, simd_find_string_special(lexer->source, lexer->pos, lexer->length));
+        if (lexer->current_char != '\\') break;
+        advance(lexer); // 跳过转义符
+        if (lexer->current_char != '\0') {
+            advance(lexer); // 跳过被转义的字符
         }
     }
     
     // 检查是否正常结束
     if (lexer->current_char != '"') {
         // 字符串未正常结束
-        Token *token = create_token(TOKEN_ERROR, "未结束的字符串", 
-                                   start_line, start_column);
-        return token;
+        return create_error_token(&lexer->arena, "未结束的字符串", start_pos);
     }
     
     advance(lexer); // 跳过结束引号
     
-    // 提取字符串（包括引号）
-    size_t length = lexer->pos - start_pos;
-    char *string = (char *)malloc(length + 1);
-    strncpy(string, lexer->source + start_pos, length);
-    string[length] = '\0';
-    
-    Token *token = create_token(TOKEN_STRING_CONST, string, start_line, start_column);
-    
-    free(string);
-    return token;
+    // 词素（包括引号）直接引用源代码
+    return create_token(&lexer->arena, TOKEN_STRING_CONST, lexer->source + start_pos,
+                        lexer->pos - start_pos, start_pos);
+}
+
+/**
+ * 计算转义字符的值
+ * @param c 转义符之后的字符
+ * @return 转义后的字符值
+ */
+static char decode_escape(char c) {
+    switch (c) {
+        case 'n': return '\n';
+        case 't': return '\t';
+        case 'r': return '\r';
+        case '\\': return '\\';
+        case '\'': return '\'';
+        case '0': return '\0';
+        default: return c;
+    }
 }
 
 /**
@@ -299,8 +370,6 @@ Token *read_string(Lexer *lexer) {
  * @return Token指针
  */
 Token *read_char(Lexer *lexer) {
-    int start_line = lexer->line;
-    int start_column = lexer->column;
     size_t start_pos = lexer->pos;
     
     advance(lexer); // 跳过开头的单引号
@@ -310,15 +379,7 @@ Token *read_char(Lexer *lexer) {
     if (lexer->current_char == '\\') {
         // 转义字符
         advance(lexer);
-        switch (lexer->current_char) {
-            case 'n': char_value = '\n'; break;
-            case 't': char_value = '\t'; break;
-            case 'r': char_value = '\r'; break;
-            case '\\': char_value = '\\'; break;
-            case '\'': char_value = '\''; break;
-            case '0': char_value = '\0'; break;
-            default: char_value = lexer->current_char; break;
-        }
+        char_value = decode_escape(lexer->current_char);
         advance(lexer);
     } else if (lexer->current_char != '\0' && lexer->current_char != '\'') {
         // 普通字符
@@ -328,36 +389,28 @@ Token *read_char(Lexer *lexer) {
     
     // 检查结束单引号
     if (lexer->current_char != '\'') {
-        Token *token = create_token(TOKEN_ERROR, "未结束的字符常量", 
-                                   start_line, start_column);
-        return token;
+        return create_error_token(&lexer->arena, "未结束的字符常量", start_pos);
     }
     
     advance(lexer); // 跳过结束单引号
     
-    // 提取字符常量（包括单引号）
-    size_t length = lexer->pos - start_pos;
-    char *char_str = (char *)malloc(length + 1);
-    strncpy(char_str, lexer->source + start_pos, length);
-    char_str[length] = '\0';
-    
-    Token *token = create_token(TOKEN_CHAR_CONST, char_str, start_line, start_column);
+    // 词素（包括单引号）直接引用源代码
+    Token *token = create_token(&lexer->arena, TOKEN_CHAR_CONST, lexer->source + start_pos,
+                                lexer->pos - start_pos, start_pos);
     token->value.char_value = char_value;
-    
-    free(char_str);
     return token;
 }
 
 /**
- * 获取下一个Token
- * 主要的词法分析函数，返回下一个识别的Token
+ * 手写扫描：逐字符分支判断识别下一个Token
  * @param lexer 词法分析器指针
  * @return Token指针
  */
-Token *get_next_token(Lexer *lexer) {
+static Token *get_next_token_by_hand(Lexer *lexer) {
+    Arena *arena = &lexer->arena;
+    
     while (lexer->current_char != '\0') {
-        int start_line = lexer->line;
-        int start_column = lexer->column;
+        size_t start_pos = lexer->pos;
         
         // 跳过空白字符
         if (isspace(lexer->current_char)) {
@@ -403,76 +456,1090 @@ Token *get_next_token(Lexer *lexer) {
         // 双字符运算符
         if (current == '=' && next == '=') {
             advance(lexer); advance(lexer);
-            return create_token(TOKEN_EQ, "==", start_line, start_column);
+            return create_token(arena, TOKEN_EQ, "==", 2, start_pos);
         }
         if (current == '!' && next == '=') {
             advance(lexer); advance(lexer);
-            return create_token(TOKEN_NE, "!=", start_line, start_column);
+            return create_token(arena, TOKEN_NE, "!=", 2, start_pos);
         }
         if (current == '<' && next == '=') {
             advance(lexer); advance(lexer);
-            return create_token(TOKEN_LE, "<=", start_line, start_column);
+            return create_token(arena, TOKEN_LE, "<=", 2, start_pos);
         }
         if (current == '>' && next == '=') {
             advance(lexer); advance(lexer);
-            return create_token(TOKEN_GE, ">=", start_line, start_column);
+            return create_token(arena, TOKEN_GE, ">=", 2, start_pos);
         }
         if (current == '&' && next == '&') {
             advance(lexer); advance(lexer);
-            return create_token(TOKEN_AND, "&&", start_line, start_column);
+            return create_token(arena, TOKEN_AND, "&&", 2, start_pos);
         }
         if (current == '|' && next == '|') {
             advance(lexer); advance(lexer);
-            return create_token(TOKEN_OR, "||", start_line, start_column);
+            return create_token(arena, TOKEN_OR, "||", 2, start_pos);
         }
         
         // 单字符运算符和分隔符
         advance(lexer);
         switch (current) {
-            case '+': return create_token(TOKEN_PLUS, "+", start_line, start_column);
-            case '-': return create_token(TOKEN_MINUS, "-", start_line, start_column);
-            case '*': return create_token(TOKEN_MULTIPLY, "*", start_line, start_column);
-            case '/': return create_token(TOKEN_DIVIDE, "/", start_line, start_column);
-            case '%': return create_token(TOKEN_MODULO, "%", start_line, start_column);
-            case '=': return create_token(TOKEN_ASSIGN, "=", start_line, start_column);
-            case '<': return create_token(TOKEN_LT, "<", start_line, start_column);
-            case '>': return create_token(TOKEN_GT, ">", start_line, start_column);
-            case '!': return create_token(TOKEN_NOT, "!", start_line, start_column);
-            case ';': return create_token(TOKEN_SEMICOLON, ";", start_line, start_column);
-            case ',': return create_token(TOKEN_COMMA, ",", start_line, start_column);
-            case '(': return create_token(TOKEN_LPAREN, "(", start_line, start_column);
-            case ')': return create_token(TOKEN_RPAREN, ")", start_line, start_column);
-            case '{': return create_token(TOKEN_LBRACE, "{", start_line, start_column);
-            case '}': return create_token(TOKEN_RBRACE, "}", start_line, start_column);
-            case '[': return create_token(TOKEN_LBRACKET, "[", start_line, start_column);
-            case ']': return create_token(TOKEN_RBRACKET, "]", start_line, start_column);
+            case '+': return create_token(arena, TOKEN_PLUS, "+", 1, start_pos);
+            case '-': return create_token(arena, TOKEN_MINUS, "-", 1, start_pos);
+            case '*': return create_token(arena, TOKEN_MULTIPLY, "*", 1, start_pos);
+            case '/': return create_token(arena, TOKEN_DIVIDE, "/", 1, start_pos);
+            case '%': return create_token(arena, TOKEN_MODULO, "%", 1, start_pos);
+            case '=': return create_token(arena, TOKEN_ASSIGN, "=", 1, start_pos);
+            case '<': return create_token(arena, TOKEN_LT, "<", 1, start_pos);
+            case '>': return create_token(arena, TOKEN_GT, ">", 1, start_pos);
+            case '!': return create_token(arena, TOKEN_NOT, "!", 1, start_pos);
+            case ';': return create_token(arena, TOKEN_SEMICOLON, ";", 1, start_pos);
+            case ',': return create_token(arena, TOKEN_COMMA, ",", 1, start_pos);
+            case '(': return create_token(arena, TOKEN_LPAREN, "(", 1, start_pos);
+            case ')': return create_token(arena, TOKEN_RPAREN, ")", 1, start_pos);
+            case '{': return create_token(arena, TOKEN_LBRACE, "{", 1, start_pos);
+            case '}': return create_token(arena, TOKEN_RBRACE, "}", 1, start_pos);
+            case '[': return create_token(arena, TOKEN_LBRACKET, "[", 1, start_pos);
+            case ']': return create_token(arena, TOKEN_RBRACKET, "]", 1, start_pos);
             default: {
                 char error_msg[64];
                 snprintf(error_msg, sizeof(error_msg), "非法字符: '%c'", current);
-                return create_token(TOKEN_ERROR, error_msg, start_line, start_column);
+                return create_error_token(arena, error_msg, start_pos);
+            }
+        }
+    }
+    
+    // 文件结束
+    return create_token(arena, TOKEN_EOF, "", 0, lexer->pos);
+}
+
+/**
+ * 计算扫描表识别出的常量词素的值
+ * @param type Token类型
+ * @param text 词素起始地址
+ * @param length 词素长度
+ * @param value 输出：常量值
+ * @param overflow 输出：整型常量是否超出范围
+ * @return 该类型是否带有常量值
+ */
+static bool decode_rule_value(TokenType type, const char *text, size_t length, TokenValue *value,
+                              bool *overflow) {
+    *overflow = false;
+    switch (type) {
+        case TOKEN_INT_CONST:
+            *overflow = decode_number(text, length, 0, value) == NUMBER_OVERFLOW;
+            return true;
+        case TOKEN_DOUBLE_CONST:
+            decode_number(text, length, 1, value);
+            return true;
+        case TOKEN_CHAR_CONST:
+            if (length == 2) {
+                value->char_value = '\0';      // ''
+            } else if (text[1] == '\\') {
+                value->char_value = decode_escape(text[2]);
+            } else {
+                value->char_value = text[1];
             }
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * 根据扫描表识别出的规则创建Token
+ * @param lexer 词法分析器指针
+ * @param rule 识别出的规则
+ * @param start 词素起始位置
+ * @return Token指针
+ */
+static Token *create_rule_token(Lexer *lexer, const ScanRule *rule, size_t start) {
+    size_t length = lexer->pos - start;
+    if (rule->lexeme) {
+        return create_token(&lexer->arena, rule->type, rule->lexeme, length, start);
+    }
+    
+    const char *text = lexer->source + start;
+    TokenValue value;
+    bool overflow;
+    decode_rule_value(rule->type, text, length, &value, &overflow);
+    if (overflow) {
+        return create_error_token(&lexer->arena, INT_OVERFLOW_MESSAGE, start);
+    }
+    Token *token = create_token(&lexer->arena, rule->type, text, length, start);
+    token->value = value;
+    return token;
+}
+
+/**
+ * 按扫描表从指定位置做最长匹配
+ * 没有可接受的前缀，或在文件结束处停在非终态（未结束的字符串、
+ * 注释等）时返回NO_RULE，由调用者交给手写扫描处理。
+ * @param table 扫描表
+ * @param source 源代码
+ * @param length 源代码长度
+ * @param start 起始位置
+ * @param end 输出：匹配的结束位置
+ * @param stop 输出：扫描停止的位置（等于length表示直到末尾仍未进入死状态）
+ * @return 识别出的规则编号，或NO_RULE
+ */
+static int match_longest(const ScanTable *table, const unsigned char *source, size_t length,
+                         size_t start, size_t *end, size_t *stop) {
+    size_t pos = start;
+    int last_rule = NO_RULE;
+    int state = table->start_state;
+    
+    while (pos < length) {
+        state = table->next[state * table->num_classes + table->class_map[source[pos]]];
+        if (state < 0) break;
+        pos++;
+        if (table->accept[state] != NO_RULE) {
+            last_rule = table->accept[state];
+            *end = pos;
+        }
+    }
+    
+    *stop = pos;
+    if (pos == length && state >= 0 && table->accept[state] == NO_RULE) {
+        return NO_RULE;
+    }
+    return last_rule;
+}
+
+/**
+ * 按词法分析器选择的方式做最长匹配：直接编码的扫描器、惰性DFA或查转换表，结果相同
+ * @param lexer 词法分析器指针
+ * @param table 扫描表
+ * @param source 源代码
+ * @param length 源代码长度
+ * @param start 起始位置
+ * @param end 输出：匹配的结束位置
+ * @param stop 输出：扫描停止的位置
+ * @return 识别出的规则编号，或NO_RULE
+ */
+static int match_rule(const Lexer *lexer, const ScanTable *table, const unsigned char *source,
+                      size_t length, size_t start, size_t *end, size_t *stop) {
+    if (lexer->direct) {
+        return c0_direct_match(source, length, start, end, stop);
+    }
+    if (lexer->lazy) {
+        return lazy_dfa_match(lexer->lazy, source, length, start, end, stop);
+    }
+    return match_longest(table, source, length, start, end, stop);
+}
+
+/**
+ * 表驱动扫描：每个字节查一次转换表（或经直接编码的扫描器），按最长匹配识别下一个Token
+ * 没有可接受的前缀，或在文件结束处停在非终态（未结束的字符串、
+ * 注释等）时，交给手写扫描处理，以保持相同的错误报告。
+ * @param lexer 词法分析器指针
+ * @return Token指针
+ */
+static Token *get_next_token_by_table(Lexer *lexer) {
+    const ScanTable *table = lexer->table;
+    const unsigned char *source = (const unsigned char *)lexer->source;
+    
+    while (lexer->pos < lexer->length) {
+        size_t start = lexer->pos;
+        size_t last_end = start;
+        size_t stop;
+        int last_rule = match_rule(lexer, table, source, lexer->length, start, &last_end, &stop);
+        if (last_rule == NO_RULE) {
+            return get_next_token_by_hand(lexer);
+        }
+        
+        advance_to(lexer, last_end);
+        
+        const ScanRule *rule = &table->rules[last_rule];
+        if (!rule->skip) {
+            return create_rule_token(lexer, rule, start);
         }
     }
     
     // 文件结束
-    return create_token(TOKEN_EOF, "", lexer->line, lexer->column);
+    return create_token(&lexer->arena, TOKEN_EOF, "", 0, lexer->pos);
+}
+
+/**
+ * 判断Token类型是否驻留到符号表（标识符和字符串常量）
+ */
+static bool is_symbol_type(TokenType type) {
+    return type == TOKEN_IDENTIFIER || type == TOKEN_STRING_CONST;
+}
+
+/**
+ * 标识符和字符串常量的词素驻留到词法分析器的符号表，记下符号编号
+ * @param lexer 词法分析器指针
+ * @param token Token指针
+ * @return 同一Token指针
+ */
+static Token *intern_token(Lexer *lexer, Token *token) {
+    if (is_symbol_type(token->type)) {
+        token->value.symbol_id = symbol_table_intern(&lexer->symbols, token->lexeme, token->length);
+    }
+    return token;
+}
+
+/**
+ * 获取下一个Token
+ * 主要的词法分析函数，返回下一个识别的Token
+ * @param lexer 词法分析器指针
+ * @return Token指针（标识符和字符串常量带有符号编号）
+ */
+Token *get_next_token(Lexer *lexer) {
+    if (lexer->table) {
+        return intern_token(lexer, get_next_token_by_table(lexer));
+    }
+    return intern_token(lexer, get_next_token_by_hand(lexer));
+}
+
+/**
+ * 将Token流的一个数组重新分配为指定容量
+ * @param array 数组指针的地址
+ * @param new_capacity 新容量
+ * @param elem_size 元素大小
+ */
+static void grow_stream_array(void *array, int new_capacity, size_t elem_size) {
+    void **p = (void **)array;
+    void *grown = realloc(*p, elem_size * new_capacity);
+    if (!grown) {
+        fprintf(stderr, "内存分配失败: lex_all\n");
+        exit(1);
+    }
+    *p = grown;
+}
+
+/**
+ * 向Token流追加一个Token，标识符和字符串常量同时驻留到Token流的符号表
+ * @param stream Token流
+ * @param type Token类型
+ * @param offset 词素偏移
+ * @param length 词素长度
+ * @return 新Token的下标
+ */
+static int stream_push(TokenStream *stream, TokenType type, size_t offset, size_t length) {
+    if (stream->count == stream->capacity) {
+        int capacity = stream->capacity * 2;
+        grow_stream_array(&stream->types, capacity, sizeof(uint8_t));
+        grow_stream_array(&stream->offsets, capacity, sizeof(uint32_t));
+        grow_stream_array(&stream->lengths, capacity, sizeof(uint32_t));
+        grow_stream_array(&stream->value_index, capacity, sizeof(int));
+        stream->capacity = capacity;
+        stream->allocations += 4;
+    }
+    
+    int i = stream->count++;
+    stream->types[i] = (uint8_t)type;
+    stream->offsets[i] = (uint32_t)offset;
+    stream->lengths[i] = (uint32_t)length;
+    stream->value_index[i] = is_symbol_type(type)
+        ? (int)symbol_table_intern(&stream->symbols, stream->source + offset, length) : -1;
+    return i;
+}
+
+/**
+ * 为Token流中的Token记录常量值
+ * @param stream Token流
+ * @param index Token下标
+ * @param value 常量值
+ */
+static void stream_set_value(TokenStream *stream, int index, TokenValue value) {
+    if (stream->num_values == stream->value_capacity) {
+        stream->value_capacity = stream->value_capacity ? stream->value_capacity * 2 : 64;
+        grow_stream_array(&stream->values, stream->value_capacity, sizeof(TokenValue));
+        stream->allocations++;
+    }
+    stream->value_index[index] = stream->num_values;
+    stream->values[stream->num_values++] = value;
+}
+
+/**
+ * C0规则的快速路径：空白、注释、标识符和字符串的结束位置可由向量化扫描
+ * 直接确定，结果与按扫描表逐字节最长匹配相同。含'\0'或未结束的注释、
+ * 字符串不走快速路径。
+ * @param source 源代码
+ * @param length 源代码长度
+ * @param start 起始位置
+ * @param end 输出：匹配的结束位置
+ * @return 识别出的Token类型；TOKEN_EOF表示应丢弃（空白、注释）；
+ *         TOKEN_ERROR表示不适用快速路径
+ */
+static TokenType match_fast(const char *source, size_t length, size_t start, size_t *end) {
+    unsigned char c = (unsigned char)source[start];
+    unsigned char next = start + 1 < length ? (unsigned char)source[start + 1] : '\0';
+    
+    if (c == ' ' || (c >= 9 && c <= 13)) {
+        *end = simd_skip_whitespace(source, start, length);
+        return TOKEN_EOF;
+    }
+    
+    if (c == '/' && next == '/') {
+        size_t p = simd_find_line_end(source, start + 2, length);
+        if (p < length && source[p] == '\0') {
+            return TOKEN_ERROR;
+        }
+        *end = (p < length) ? p + 1 : length;   // 包括行尾的'\n'
+        return TOKEN_EOF;
+    }
+    
+    if (c == '/' && next == '*') {
+        size_t p = simd_find_comment_end(source, start + 2, length);
+        if (p == length || source[p] == '\0') {
+            return TOKEN_ERROR;
+        }
+        *end = p + 2;
+        return TOKEN_EOF;
+    }
+    
+    if (isalpha(c) || c == '_') {
+        *end = simd_identifier_end(source, start, length);
+        return lookup_keyword(source + start, *end - start);
+    }
+    
+    if (c == '"') {
+        size_t p = start + 1;
+        while (1) {
+            p = simd_find_string_special(source, p, length);
+            if (p == length || source[p] == '\0') {
+                return TOKEN_ERROR;
+            }
+            if (source[p] == '"') {
+                *end = p + 1;
+                return TOKEN_STRING_CONST;
+            }
+            // 转义符：跳过它和被转义的字符
+            if (p + 1 >= length || source[p + 1] == '\0') {
+                return TOKEN_ERROR;
+            }
+            p += 2;
+        }
+    }
+    
+    return TOKEN_ERROR;
+}
+
+/**
+ * 为Token流中的错误Token记录错误信息
+ * @param stream Token流
+ * @param index Token下标
+ * @param message 错误信息（位于Token流的区域中）
+ */
+static void stream_set_message(TokenStream *stream, int index, const char *message) {
+    if (stream->num_messages == stream->message_capacity) {
+        stream->message_capacity = stream->message_capacity ? stream->message_capacity * 2 : 16;
+        grow_stream_array(&stream->messages, stream->message_capacity, sizeof(const char *));
+        stream->allocations++;
+    }
+    stream->value_index[index] = stream->num_messages;
+    stream->messages[stream->num_messages++] = message;
+}
+
+/**
+ * 初始化空的Token流
+ * @param stream Token流
+ * @param source 源代码
+ * @param capacity 各数组的初始容量
+ */
+static void token_stream_init(TokenStream *stream, const char *source, int capacity) {
+    memset(stream, 0, sizeof(TokenStream));
+    stream->source = source;
+    stream->capacity = capacity;
+    grow_stream_array(&stream->types, stream->capacity, sizeof(uint8_t));
+    grow_stream_array(&stream->offsets, stream->capacity, sizeof(uint32_t));
+    grow_stream_array(&stream->lengths, stream->capacity, sizeof(uint32_t));
+    grow_stream_array(&stream->value_index, stream->capacity, sizeof(int));
+    stream->allocations = 4;
+    symbol_table_init(&stream->symbols);
+}
+
+/**
+ * 从词法分析器的当前位置识别一项（Token、空白或注释），Token追加到Token流
+ * 按预生成的扫描表做最长匹配，空白、注释、标识符和字符串先尝试向量化的快速路径；
+ * 只有扫描表无法处理的位置（词法错误、未结束的字符串等）交给手写扫描。
+ * @param stream Token流
+ * @param lexer 词法分析器（错误信息分配在其区域中）
+ * @param table 扫描表
+ * @return 是否还有后续输入（到达文件结束、已追加EOF时返回false）
+ */
+static bool lex_step(TokenStream *stream, Lexer *lexer, const ScanTable *table) {
+    const char *source = lexer->source;
+    size_t length = lexer->length;
+    size_t start = lexer->pos;
+    size_t end = start;
+    int rule_index = NO_RULE;
+    if (start < length) {
+        TokenType type = match_fast(source, length, start, &end);
+        if (type != TOKEN_ERROR) {
+            advance_to(lexer, end);
+            if (type != TOKEN_EOF) {
+                stream_push(stream, type, start, end - start);
+            }
+            return true;
+        }
+        size_t stop;
+        rule_index = match_rule(lexer, table, (const unsigned char *)source, length, start,
+                                &end, &stop);
+    }
+    
+    if (rule_index == NO_RULE) {
+        Token *token = get_next_token_by_hand(lexer);
+        int i;
+        if (token->type == TOKEN_ERROR) {
+            i = stream_push(stream, TOKEN_ERROR, token->offset, 0);
+            stream_set_message(stream, i, token->lexeme);
+        } else {
+            i = stream_push(stream, token->type, token->offset, token->length);
+            if ((is_number_type(token->type) && !stream->deferred_values) ||
+                token->type == TOKEN_CHAR_CONST) {
+                stream_set_value(stream, i, token->value);
+            }
+        }
+        return token->type != TOKEN_EOF;
+    }
+    
+    advance_to(lexer, end);
+    
+    const ScanRule *rule = &table->rules[rule_index];
+    if (rule->skip) {
+        return true;
+    }
+    TokenValue value;
+    bool overflow;
+    if (rule->lexeme || (stream->deferred_values && is_number_type(rule->type)) ||
+        !decode_rule_value(rule->type, source + start, end - start, &value, &overflow)) {
+        stream_push(stream, rule->type, start, end - start);
+    } else if (overflow) {
+        int i = stream_push(stream, TOKEN_ERROR, start, 0);
+        stream_set_message(stream, i, INT_OVERFLOW_MESSAGE);
+    } else {
+        int i = stream_push(stream, rule->type, start, end - start);
+        stream_set_value(stream, i, value);
+    }
+    return true;
+}
+
+/**
+ * 词法分析整个缓冲区，结果写入Token流
+ * @param source 源代码（无需以'\0'结尾）
+ * @param length 源代码长度
+ * @param deferred 数值常量是否延迟转换
+ * @param direct 最长匹配是否由直接编码的扫描器完成
+ * @param lazy 非NULL时最长匹配由该惰性DFA完成
+ * @param stream 输出：Token流
+ */
+static void lex_buffer(const char *source, size_t length, bool deferred, bool direct,
+                       LazyDFA *lazy, TokenStream *stream) {
+    const ScanTable *table = get_c0_scan_table();
+    token_stream_init(stream, source, (int)(length / 4) + 16);
+    stream->deferred_values = deferred;
+    
+    // 手写扫描需要的词法分析器状态，错误信息分配在其区域中
+    Lexer lexer;
+    lexer_init(&lexer, source, length);
+    lexer.direct = direct;
+    lexer.lazy = lazy;
+    while (lex_step(stream, &lexer, table)) {
+    }
+    
+    // 行列号按需由换行索引计算，手写扫描的词法分析器未曾查询过位置，其索引无需释放
+    stream->arena = lexer.arena;
+    line_index_init(&stream->lines, source, lexer.length);
+}
+
+/**
+ * 词法分析整个缓冲区，结果写入Token流
+ * Token直接写入各数组，不再逐个创建Token。
+ * @param source 源代码（无需以'\0'结尾）
+ * @param length 源代码长度
+ * @param stream 输出：Token流（用free_token_stream释放）
+ */
+void lex_all(const char *source, size_t length, TokenStream *stream) {
+    lex_buffer(source, length, false, false, NULL, stream);
+}
+
+/**
+ * 词法分析整个缓冲区，数值常量延迟转换
+ * 分析时只记录整型和浮点常量的词素，token_stream_get或token_stream_value取值时
+ * 才由词素转换；整数溢出不产生错误Token，由token_stream_value报告。
+ * 适合只需要Token类型和位置、或只取少数常量值的场合。
+ * @param source 源代码（无需以'\0'结尾）
+ * @param length 源代码长度
+ * @param stream 输出：Token流（用free_token_stream释放）
+ */
+void lex_all_deferred(const char *source, size_t length, TokenStream *stream) {
+    lex_buffer(source, length, true, false, NULL, stream);
+}
+
+/**
+ * 词法分析整个缓冲区，快速路径以外的最长匹配由直接编码的扫描器完成
+ * 结果与lex_all完全相同，用于按基准测试选择扫描方式。
+ * @param source 源代码（无需以'\0'结尾）
+ * @param length 源代码长度
+ * @param stream 输出：Token流（用free_token_stream释放）
+ */
+void lex_all_direct(const char *source, size_t length, TokenStream *stream) {
+    lex_buffer(source, length, false, true, NULL, stream);
+}
+
+/**
+ * 词法分析整个缓冲区，快速路径以外的最长匹配由惰性DFA完成
+ * 结果与lex_all完全相同；扫描表之外的自动机内存不超过惰性DFA的预算。
+ * @param source 源代码（无需以'\0'结尾）
+ * @param length 源代码长度
+ * @param lazy 由create_nfa_for_c0_tokens的NFA初始化的惰性DFA
+ * @param stream 输出：Token流（用free_token_stream释放）
+ */
+void lex_all_lazy(const char *source, size_t length, LazyDFA *lazy, TokenStream *stream) {
+    lex_buffer(source, length, false, false, lazy, stream);
+}
+
+/**
+ * 推测分析一块：假定块起点恰好是一项的开始，识别起点位于[start, stop)中的各项
+ * 最后一项可能越过stop。各块互不依赖，可以在不同线程中同时调用。
+ * @param source 源代码（length之内不含'\0'）
+ * @param length 源代码长度
+ * @param start 块起点
+ * @param stop 下一块的起点
+ * @param chunk 输出：该块的Token流和分析停止的位置（用lex_chunks_stitch合并）
+ */
+void lex_chunk(const char *source, size_t length, size_t start, size_t stop, LexChunk *chunk) {
+    const ScanTable *table = get_c0_scan_table();
+    token_stream_init(&chunk->stream, source, (int)((stop - start) / 4) + 16);
+    chunk->start = start;
+    
+    Lexer lexer;
+    lexer_init_text(&lexer, source, length);
+    advance_to(&lexer, start);
+    while (lexer.pos < stop && lex_step(&chunk->stream, &lexer, table)) {
+    }
+    chunk->end = lexer.pos;
+    chunk->stream.arena = lexer.arena;
+}
+
+/**
+ * 把src中从下标from开始的Token追加到dst，常量值和错误信息一并复制
+ * @param dst 目标Token流
+ * @param src 源Token流
+ * @param from 起始下标
+ */
+static void token_stream_append(TokenStream *dst, const TokenStream *src, int from) {
+    for (int k = from; k < src->count; k++) {
+        TokenType type = (TokenType)src->types[k];
+        int i = stream_push(dst, type, src->offsets[k], src->lengths[k]);
+        int v = src->value_index[k];
+        if (v < 0 || is_symbol_type(type)) {
+            continue;       // 符号编号已由stream_push在目标的符号表中重新驻留
+        }
+        if (type == TOKEN_ERROR) {
+            stream_set_message(dst, i, src->messages[v]);
+        } else {
+            stream_set_value(dst, i, src->values[v]);
+        }
+    }
+}
+
+/**
+ * Token流是否已经以EOF结束
+ * @param stream Token流
+ * @return 是否以EOF结束
+ */
+static bool token_stream_ended(const TokenStream *stream) {
+    return stream->count > 0 && stream->types[stream->count - 1] == TOKEN_EOF;
+}
+
+/**
+ * 合并各块的推测结果，得到与lex_all完全相同的Token流
+ * 第0块从文件开头分析，结果一定正确。之后从已确定部分的末尾继续逐项分析，
+ * 直到分析位置与下一块中某个Token的起点（或该块停止的位置）重合：
+ * 词法分析只取决于起始位置，此后该块的结果与真实结果相同，整段采用。
+ * 块起点落在注释或字符串中时推测结果无效，由逐项分析越过，代价只是少并行了这一段。
+ * @param chunks 各块（按起点顺序，合并后全部释放）
+ * @param num_chunks 块数
+ * @param source 源代码（length之内不含'\0'）
+ * @param length 源代码长度
+ * @param stream 输出：Token流（用free_token_stream释放）
+ */
+void lex_chunks_stitch(LexChunk *chunks, int num_chunks, const char *source, size_t length,
+                       TokenStream *stream) {
+    const ScanTable *table = get_c0_scan_table();
+    *stream = chunks[0].stream;
+    
+    Lexer lexer;
+    lexer_init_text(&lexer, source, length);
+    advance_to(&lexer, chunks[0].end);
+    bool more = !token_stream_ended(stream);
+    
+    for (int c = 1; c < num_chunks; c++) {
+        LexChunk *chunk = &chunks[c];
+        int j = 0;
+        while (more) {
+            while (j < chunk->stream.count && chunk->stream.offsets[j] < lexer.pos) {
+                j++;
+            }
+            if (j < chunk->stream.count && chunk->stream.offsets[j] == lexer.pos) {
+                token_stream_append(stream, &chunk->stream, j);
+                advance_to(&lexer, chunk->end);
+                more = !token_stream_ended(stream);
+                break;
+            }
+            if (lexer.pos >= chunk->end) {
+                break;      // 越过了该块的全部结果（或恰好停在同一位置且其后无Token）
+            }
+            more = lex_step(stream, &lexer, table);
+        }
+        
+        arena_merge(&stream->arena, &chunk->stream.arena);
+        free_token_stream(&chunk->stream);
+    }
+    
+    // 最后一块没有覆盖到文件末尾时（没有重合点），继续分析剩余部分
+    while (more) {
+        more = lex_step(stream, &lexer, table);
+    }
+    
+    arena_merge(&stream->arena, &lexer.arena);
+    line_index_init(&stream->lines, source, length);
+}
+
+/**
+ * 找出第一个偏移不小于offset的Token
+ * @param stream Token流
+ * @param offset 偏移
+ * @return Token下标（都小于offset时为count）
+ */
+static int token_stream_lower_bound(const TokenStream *stream, size_t offset) {
+    int lo = 0;
+    int hi = stream->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (stream->offsets[mid] < offset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * 增量分析：源代码经过一次编辑后，只重新分析编辑附近的Token，原地更新Token流
+ * Token的起点一定不在注释或字符串中，是安全的重新开始点：从扫描预读够不到编辑位置的
+ * 最后一个Token起重新分析，直到分析位置与编辑之后某个旧Token平移后的起点重合——
+ * 与lex_chunks_stitch同理，此后的结果与旧结果相同，其余Token只平移偏移。
+ * 编辑改变了文本的结束位置（删去或插入了'\0'）时从头重新分析。
+ * 被替换的Token的常量值和错误信息留在旁表中，随Token流释放。
+ * @param stream Token流（由lex_all或lex_chunks_stitch得到，分析的是编辑前的源代码）
+ * @param source 编辑后的源代码（必须比Token流存活更久）
+ * @param length 编辑后的源代码长度
+ * @param edit 编辑
+ * @param result 输出：被替换的Token范围（可为NULL）
+ */
+void token_stream_relex(TokenStream *stream, const char *source, size_t length,
+                        const TokenEdit *edit, RelexResult *result) {
+    const ScanTable *table = get_c0_scan_table();
+    size_t offset = edit->offset;
+    size_t removed = edit->removed;
+    size_t inserted = edit->inserted;
+    size_t old_text = stream->lines.length;
+    
+    bool whole = offset + removed > old_text ||
+                 old_text - removed + inserted > length ||
+                 memchr(source + offset, '\0', inserted) != NULL;
+    size_t text = old_text - removed + inserted;
+    int lookahead = table->lookahead;
+    if (lookahead < 0) {
+        whole = true;
+    }
+    
+    int first = 0;          // 第一个重新分析的旧Token
+    int resume;             // 第一个可能沿用的旧Token（起点在删去的部分之后）
+    if (whole) {
+        const char *nul = (const char *)memchr(source, '\0', length);
+        text = nul ? (size_t)(nul - source) : length;
+        resume = stream->count;
+    } else {
+        // 之前各项读过的字节都在该Token起点 + 预读之前；手写扫描多留一个字节的余量。
+        // 错误Token不记录长度，不从紧跟其后的Token开始
+        size_t margin = (size_t)lookahead + 1;
+        first = offset >= margin ? token_stream_lower_bound(stream, offset - margin + 1) : 0;
+        if (first > 0) {
+            first--;
+        }
+        while (first > 0 && stream->types[first - 1] == TOKEN_ERROR) {
+            first--;
+        }
+        resume = token_stream_lower_bound(stream, offset + removed);
+    }
+    
+    // 新Token驻留到原来的符号表，未改变的Token的符号编号保持不变
+    TokenStream fresh;
+    token_stream_init(&fresh, source, 64);
+    fresh.deferred_values = stream->deferred_values;
+    fresh.symbols = stream->symbols;
+    
+    Lexer lexer;
+    lexer_init_text(&lexer, source, text);
+    advance_to(&lexer, first > 0 ? stream->offsets[first] : 0);
+    int j = resume;
+    bool more = true;
+    while (more) {
+        while (j < stream->count && stream->offsets[j] - removed + inserted < lexer.pos) {
+            j++;
+        }
+        if (j < stream->count && stream->offsets[j] - removed + inserted == lexer.pos) {
+            break;
+        }
+        more = lex_step(&fresh, &lexer, table);
+    }
+    if (!more) {
+        j = stream->count;  // 一直分析到了文件末尾，新Token已以EOF结束
+    }
+    
+    // 拼接：[0, first)不变，[first, j)换成新Token，[j, count)平移
+    int added = fresh.count;
+    int tail = stream->count - j;
+    int count = first + added + tail;
+    if (count > stream->capacity) {
+        int capacity = stream->capacity * 2 > count ? stream->capacity * 2 : count;
+        grow_stream_array(&stream->types, capacity, sizeof(uint8_t));
+        grow_stream_array(&stream->offsets, capacity, sizeof(uint32_t));
+        grow_stream_array(&stream->lengths, capacity, sizeof(uint32_t));
+        grow_stream_array(&stream->value_index, capacity, sizeof(int));
+        stream->capacity = capacity;
+        stream->allocations += 4;
+    }
+    if (first + added != j) {
+        memmove(stream->types + first + added, stream->types + j, sizeof(uint8_t) * tail);
+        memmove(stream->offsets + first + added, stream->offsets + j, sizeof(uint32_t) * tail);
+        memmove(stream->lengths + first + added, stream->lengths + j, sizeof(uint32_t) * tail);
+        memmove(stream->value_index + first + added, stream->value_index + j, sizeof(int) * tail);
+    }
+    if (removed != inserted) {
+        for (int i = first + added; i < count; i++) {
+            stream->offsets[i] = (uint32_t)(stream->offsets[i] - removed + inserted);
+        }
+    }
+    
+    for (int k = 0; k < added; k++) {
+        int i = first + k;
+        TokenType type = (TokenType)fresh.types[k];
+        int v = fresh.value_index[k];
+        stream->types[i] = fresh.types[k];
+        stream->offsets[i] = fresh.offsets[k];
+        stream->lengths[i] = fresh.lengths[k];
+        stream->value_index[i] = v;
+        if (v < 0 || is_symbol_type(type)) {
+            continue;
+        }
+        if (type == TOKEN_ERROR) {
+            stream_set_message(stream, i, fresh.messages[v]);
+        } else {
+            stream_set_value(stream, i, fresh.values[v]);
+        }
+    }
+    
+    if (result) {
+        result->first = first;
+        result->old_count = j - first;
+        result->new_count = added;
+    }
+    stream->count = count;
+    stream->source = source;
+    stream->symbols = fresh.symbols;
+    symbol_table_init(&fresh.symbols);
+    free_token_stream(&fresh);
+    arena_merge(&stream->arena, &lexer.arena);
+    if (whole) {
+        line_index_free(&stream->lines);
+        line_index_init(&stream->lines, source, text);
+    } else {
+        line_index_edit(&stream->lines, source, text, offset, removed, inserted);
+    }
+}
+
+/**
+ * 取出Token流中的一个Token
+ * @param stream Token流
+ * @param index Token下标
+ * @param token 输出：Token（词素指向源代码或错误信息）
+ */
+void token_stream_get(const TokenStream *stream, int index, Token *token) {
+    token->type = (TokenType)stream->types[index];
+    token->offset = stream->offsets[index];
+    
+    int v = stream->value_index[index];
+    if (token->type == TOKEN_ERROR) {
+        token->lexeme = stream->messages[v];
+        token->length = strlen(token->lexeme);
+    } else {
+        token->lexeme = stream->source + stream->offsets[index];
+        token->length = stream->lengths[index];
+        if (is_symbol_type(token->type)) {
+            token->value.symbol_id = (uint32_t)v;
+        } else if (v >= 0) {
+            token->value = stream->values[v];
+        } else if (stream->deferred_values && is_number_type(token->type)) {
+            decode_number(token->lexeme, token->length, token->type == TOKEN_DOUBLE_CONST,
+                          &token->value);
+        }
+    }
+}
+
+/**
+ * 取Token流中一个Token的常量值（延迟转换模式下此时才转换数值常量）
+ * @param stream Token流
+ * @param index Token下标
+ * @param value 输出：常量值（与token_stream_get得到的相同）
+ * @return 转换结果：延迟转换的数值常量超出范围时为NUMBER_OVERFLOW
+ *         （非延迟模式下溢出的整数已是错误Token，结果总是NUMBER_OK）
+ */
+NumberStatus token_stream_value(const TokenStream *stream, int index, TokenValue *value) {
+    TokenType type = (TokenType)stream->types[index];
+    if (stream->deferred_values && is_number_type(type)) {
+        return decode_number(stream->source + stream->offsets[index], stream->lengths[index],
+                             type == TOKEN_DOUBLE_CONST, value);
+    }
+    Token token;
+    token_stream_get(stream, index, &token);
+    *value = token.value;
+    return NUMBER_OK;
+}
+
+/**
+ * 释放Token流
+ * @param stream Token流
+ */
+void free_token_stream(TokenStream *stream) {
+    free(stream->types);
+    free(stream->offsets);
+    free(stream->lengths);
+    free(stream->value_index);
+    free(stream->values);
+    free(stream->messages);
+    line_index_free(&stream->lines);
+    symbol_table_free(&stream->symbols);
+    arena_free(&stream->arena);
+    memset(stream, 0, sizeof(TokenStream));
+}
+
+/**
+ * 初始化流式词法分析器
+ * 输入由回调逐块提供，窗口只保留尚未识别完的部分
+ * @param stream 流式词法分析器
+ * @param read 输入回调
+ * @param context 回调参数
+ */
+void stream_lexer_init(StreamLexer *stream, ChunkReader read, void *context) {
+    stream->read = read;
+    stream->context = context;
+    stream->capacity = STREAM_WINDOW_SIZE;
+    stream->buffer = (char *)malloc(stream->capacity);
+    if (!stream->buffer) {
+        fprintf(stderr, "内存分配失败: stream_lexer_init\n");
+        exit(1);
+    }
+    stream->filled = 0;
+    stream->base = 0;
+    stream->eof = false;
+    stream->done = false;
+    stream->token_start = 0;
+    stream->line = 1;
+    stream->line_start = 0;
+    stream->counted = 0;
+    // 窗口尚未读入数据：先以空输入初始化，不扫描缓冲区，第一次补充输入时再指向窗口
+    lexer_init_text(&stream->lexer, NULL, 0);
+    lexer_use_table(&stream->lexer, get_c0_scan_table());
+}
+
+/**
+ * 统计窗口中从已计数位置到指定位置之间的换行，更新行号
+ * @param stream 流式词法分析器
+ * @param offset 目标位置（全局偏移，必须仍在窗口中）
+ */
+static void stream_count_lines(StreamLexer *stream, size_t offset) {
+    size_t end = offset - stream->base;
+    size_t pos = stream->counted - stream->base;
+    while ((pos = simd_find_newline(stream->buffer, pos, end)) < end) {
+        pos++;
+        stream->line++;
+        stream->line_start = stream->base + pos;
+    }
+    stream->counted = offset;
+}
+
+/**
+ * 补充输入：丢弃窗口中下一项之前已识别的部分，再读入新数据
+ * 读入的数据至少与窗口中剩余的部分一样多，跨越多块的长Token
+ * 因而只需重新扫描对数次。
+ * @param stream 流式词法分析器
+ */
+static void stream_refill(StreamLexer *stream) {
+    size_t keep_from = stream->lexer.pos;
+    stream_count_lines(stream, stream->base + keep_from);
+    memmove(stream->buffer, stream->buffer + keep_from, stream->filled - keep_from);
+    stream->filled -= keep_from;
+    stream->base += keep_from;
+    
+    size_t pending = stream->filled;
+    size_t wanted = pending > 0 ? pending : 1;
+    size_t got = 0;
+    while (got < wanted && !stream->eof) {
+        if (stream->filled == stream->capacity) {
+            stream->capacity *= 2;
+            char *grown = (char *)realloc(stream->buffer, stream->capacity);
+            if (!grown) {
+                fprintf(stderr, "内存分配失败: stream_refill\n");
+                exit(1);
+            }
+            stream->buffer = grown;
+        }
+        char *chunk = stream->buffer + stream->filled;
+        size_t n = stream->read(stream->context, chunk, stream->capacity - stream->filled);
+        char *nul = (char *)memchr(chunk, '\0', n);
+        if (nul) {
+            n = (size_t)(nul - chunk);      // 输入在'\0'处结束，其后的数据不再读取
+        }
+        if (n == 0 || nul) {
+            stream->eof = true;
+        }
+        stream->filled += n;
+        got += n;
+    }
+    
+    stream->lexer.source = stream->buffer;
+    stream->lexer.length = stream->filled;
+    advance_to(&stream->lexer, 0);
+}
+
+/**
+ * 在窗口中识别下一个Token，需要更多输入时补充后从该项起点重新识别
+ * 一项的结果只有在扫描没有触及窗口末尾时才是确定的：快速路径以窗口末尾结束、
+ * 扫描表直到窗口末尾仍未进入死状态、手写扫描停在窗口最后一个字节处，
+ * 都说明后续输入可能改变结果。
+ * @param stream 流式词法分析器
+ * @return Token指针（词素指向窗口或区域，下次调用前有效；符号编号在整个流中有效）
+ */
+Token *stream_lexer_next(StreamLexer *stream) {
+    Lexer *lexer = &stream->lexer;
+    const ScanTable *table = lexer->table;
+    arena_reset(&lexer->arena);
+    
+    while (!stream->done) {
+        size_t start = lexer->pos;
+        size_t filled = stream->filled;
+        const char *source = stream->buffer;
+        if (start == filled) {
+            if (stream->eof) {
+                break;
+            }
+            stream_refill(stream);
+            continue;
+        }
+        
+        size_t end = start;
+        TokenType type = match_fast(source, filled, start, &end);
+        if (type != TOKEN_ERROR) {
+            if (end == filled && !stream->eof) {
+                stream_refill(stream);
+                continue;
+            }
+            advance_to(lexer, end);
+            if (type == TOKEN_EOF) {
+                continue;
+            }
+            stream->token_start = stream->base + start;
+            return intern_token(lexer, create_token(&lexer->arena, type, source + start,
+                                                    end - start, stream->token_start));
+        }
+        
+        size_t stop;
+        int rule_index = match_rule(lexer, table, (const unsigned char *)source, filled,
+                                    start, &end, &stop);
+        if (stop == filled && !stream->eof) {
+            stream_refill(stream);
+            continue;
+        }
+        
+        Token *token;
+        if (rule_index != NO_RULE) {
+            advance_to(lexer, end);
+            const ScanRule *rule = &table->rules[rule_index];
+            if (rule->skip) {
+                continue;
+            }
+            token = create_rule_token(lexer, rule, start);
+        } else {
+            token = get_next_token_by_hand(lexer);
+            if (lexer->pos + 1 >= filled && !stream->eof) {
+                advance_to(lexer, start);
+                stream_refill(stream);
+                continue;
+            }
+            if (token->type == TOKEN_EOF) {
+                stream->done = true;    // 遇到'\0'，与整体分析一样在此结束
+            }
+        }
+        stream->token_start = stream->base + token->offset;
+        token->offset = (uint32_t)stream->token_start;
+        return intern_token(lexer, token);
+    }
+    
+    stream->done = true;
+    stream->token_start = stream->base + lexer->pos;
+    return create_token(&lexer->arena, TOKEN_EOF, "", 0, stream->token_start);
+}
+
+/**
+ * 计算最近一次返回的Token的行号和列号
+ * @param stream 流式词法分析器
+ * @param line 输出：行号
+ * @param column 输出：列号
+ */
+void stream_lexer_position(StreamLexer *stream, int *line, int *column) {
+    stream_count_lines(stream, stream->token_start);
+    *line = stream->line;
+    *column = (int)(stream->token_start - stream->line_start) + 1;
+}
+
+/**
+ * 释放流式词法分析器
+ * @param stream 流式词法分析器
+ */
+void free_stream_lexer(StreamLexer *stream) {
+    arena_free(&stream->lexer.arena);
+    line_index_free(&stream->lexer.lines);
+    symbol_table_free(&stream->lexer.symbols);
+    free(stream->buffer);
+    stream->buffer = NULL;
 }
 
 /**
  * 打印Token信息（二元组形式）
+ * @param lines 源代码的换行索引（用于由偏移计算行列号）
+ * @param token Token指针
+ */
+void print_token(LineIndex *lines, Token *token) {
+    int line, column;
+    line_index_position(lines, token->offset, &line, &column);
+    print_token_at(stdout, token, line, column);
+}
+
+/**
+ * 打印Token信息（二元组形式），行列号由调用者给出
+ * @param out 输出流
  * @param token Token指针
+ * @param line 行号
+ * @param column 列号
  */
-void print_token(Token *token) {
-    printf("<%s, %s>", token_type_to_string(token->type), token->lexeme);
+void print_token_at(FILE *out, Token *token, int line, int column) {
+    fprintf(out, "<%s, %.*s>", token_type_to_string(token->type), (int)token->length, token->lexeme);
     
     // 对于常量，额外打印值
     if (token->type == TOKEN_INT_CONST) {
-        printf(" [值: %lld]", token->value.int_value);
+        fprintf(out, " [值: %lld]", token->value.int_value);
     } else if (token->type == TOKEN_DOUBLE_CONST) {
-        printf(" [值: %g]", token->value.double_value);
+        fprintf(out, " [值: %g]", token->value.double_value);
     } else if (token->type == TOKEN_CHAR_CONST) {
-        printf(" [值: '%c']", token->value.char_value);
+        fprintf(out, " [值: '%c']", token->value.char_value);
     }
     
-    printf(" (行: %d, 列: %d)\n", token->line, token->column);
+    fprintf(out, " (行: %d, 列: %d)\n", line, column);
 }
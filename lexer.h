@@ -7,7 +7,13 @@
 #ifndef LEXER_H
 #define LEXER_H
 
+#include <stdint.h>
 #include "token.h"
+#include "scanner.h"
+#include "line_index.h"
+#include "symbol_table.h"
+#include "number_parse.h"
+#include "lazy_dfa.h"
 
 /* 词法分析器状态 */
 typedef enum {
@@ -27,19 +33,117 @@ typedef enum {
 
 /* 词法分析器结构 */
 typedef struct {
-    const char *source;   // 源代码字符串
+    const char *source;   // 源代码（不要求以'\0'结尾）
     size_t pos;           // 当前位置
     size_t length;        // 源代码长度
-    int line;             // 当前行号
-    int column;           // 当前列号
+    LineIndex lines;      // 换行索引（首次查询行列号时建立）
     char current_char;    // 当前字符
+    const ScanTable *table; // 扫描表（非NULL时使用表驱动扫描）
+    bool direct;          // 表驱动扫描时是否由直接编码的扫描器（c0_direct_match）做最长匹配
+    LazyDFA *lazy;        // 非NULL时由惰性DFA（按C0规则的NFA构造）做最长匹配
+    Arena arena;          // Token及错误信息的区域分配器，随词法分析器释放
+    SymbolTable symbols;  // 标识符和字符串常量的符号表（get_next_token返回的Token由此得到符号编号）
 } Lexer;
 
+/* Token流：整个缓冲区的词法分析结果，按列存放（struct-of-arrays）
+ * 第i个Token的各字段分别位于各数组的第i项，最后一项为TOKEN_EOF。
+ * 词素以源代码偏移和长度表示（源代码不超过4GB，source_file_open拒绝更大的文件），行列号不单独保存，
+ * 需要时经换行索引由偏移计算；常量值和错误信息存放在旁表中，由value_index引用。
+ * 标识符和字符串常量在分析时驻留到符号表中，value_index即其符号编号。 */
+typedef struct {
+    const char *source;   // 源代码（必须比Token流存活更久）
+    int count;            // Token数量（包括末尾的EOF）
+    int capacity;         // 各数组容量
+    uint8_t *types;       // Token类型
+    uint32_t *offsets;    // 词素在源代码中的偏移
+    uint32_t *lengths;    // 词素长度
+    int *value_index;     // 常量Token在values中的下标，错误Token在messages中的下标，
+                          // 标识符和字符串常量为符号编号，其余为-1
+    TokenValue *values;   // 常量值旁表
+    int num_values;       // 常量值数量
+    int value_capacity;   // 常量值旁表容量
+    const char **messages; // 错误信息旁表
+    int num_messages;     // 错误信息数量
+    int message_capacity; // 错误信息旁表容量
+    Arena arena;          // 错误信息所在的区域分配器
+    LineIndex lines;      // 换行索引，由偏移计算行列号
+    SymbolTable symbols;  // 标识符和字符串常量的符号表
+    int allocations;      // 各数组的分配次数（含扩容，仅供统计）
+    bool deferred_values; // 数值常量是否延迟到取值时才转换（lex_all_deferred）
+} TokenStream;
+
+/* 分块并行分析中的一块：从块起点推测分析得到的Token流 */
+typedef struct {
+    TokenStream stream;   // 该块的Token流
+    size_t start;         // 块起点
+    size_t end;           // 分析停止的位置（最后一项的结束位置）
+} LexChunk;
+
+/* 对源代码的一次编辑：在offset处删除removed字节，再插入inserted字节 */
+typedef struct {
+    size_t offset;        // 编辑位置
+    size_t removed;       // 删除的字节数（编辑前的源代码中）
+    size_t inserted;      // 插入的字节数（编辑后的源代码中，位于offset处）
+} TokenEdit;
+
+/* 增量分析的结果：Token流中[first, first + new_count)是重新分析得到的Token，
+ * 替换了编辑前的[first, first + old_count)，其后的Token只平移了偏移 */
+typedef struct {
+    int first;            // 第一个重新分析的Token的下标
+    int old_count;        // 被替换的旧Token数量
+    int new_count;        // 重新分析得到的Token数量
+} RelexResult;
+
+#define STREAM_WINDOW_SIZE (64 * 1024)  // 流式分析窗口的初始大小
+
+/* 输入回调：向buffer写入至多capacity字节，返回写入的字节数，0表示输入结束 */
+typedef size_t (*ChunkReader)(void *context, char *buffer, size_t capacity);
+
+/* 流式词法分析器：输入逐块到达，只在窗口中保留尚未识别完的部分。
+ * 跨越块边界的Token、字符串和注释在补充输入后从其起点重新识别，
+ * 窗口大小不小于最长的单个Token或注释。Token中的偏移为全局偏移（超过4GB时回绕），
+ * 行列号由stream_lexer_position随读随算。 */
+typedef struct {
+    ChunkReader read;     // 输入回调
+    void *context;        // 回调参数
+    char *buffer;         // 窗口
+    size_t capacity;      // 窗口容量
+    size_t filled;        // 窗口中的有效字节数
+    size_t base;          // 窗口首字节在整个输入中的偏移
+    bool eof;             // 输入是否已经结束
+    bool done;            // 是否已经返回EOF
+    size_t token_start;   // 最近返回的Token的全局偏移
+    int line;             // 已计数位置的行号
+    size_t line_start;    // 已计数位置所在行的起始偏移
+    size_t counted;       // 换行已统计到的位置
+    Lexer lexer;          // 在窗口上扫描的词法分析器
+} StreamLexer;
+
 /* 词法分析器函数声明 */
-Lexer *create_lexer(const char *source);
+Lexer *create_lexer(const char *source, size_t length);
 void free_lexer(Lexer *lexer);
+void lexer_use_table(Lexer *lexer, const ScanTable *table);
+void lexer_use_direct(Lexer *lexer);
+void lexer_use_lazy(Lexer *lexer, LazyDFA *lazy);
 Token *get_next_token(Lexer *lexer);
-void print_token(Token *token);
+void print_token(LineIndex *lines, Token *token);
+void print_token_at(FILE *out, Token *token, int line, int column);
+void lex_all(const char *source, size_t length, TokenStream *stream);
+void lex_all_deferred(const char *source, size_t length, TokenStream *stream);
+void lex_all_direct(const char *source, size_t length, TokenStream *stream);
+void lex_all_lazy(const char *source, size_t length, LazyDFA *lazy, TokenStream *stream);
+void token_stream_get(const TokenStream *stream, int index, Token *token);
+NumberStatus token_stream_value(const TokenStream *stream, int index, TokenValue *value);
+void free_token_stream(TokenStream *stream);
+void lex_chunk(const char *source, size_t length, size_t start, size_t stop, LexChunk *chunk);
+void lex_chunks_stitch(LexChunk *chunks, int num_chunks, const char *source, size_t length,
+                       TokenStream *stream);
+void token_stream_relex(TokenStream *stream, const char *source, size_t length,
+                        const TokenEdit *edit, RelexResult *result);
+void stream_lexer_init(StreamLexer *stream, ChunkReader read, void *context);
+Token *stream_lexer_next(StreamLexer *stream);
+void stream_lexer_position(StreamLexer *stream, int *line, int *column);
+void free_stream_lexer(StreamLexer *stream);
 
 /* 辅助函数声明 */
 void advance(Lexer *lexer);
@@ -0,0 +1,167 @@
+/**
+ * line_index.c - 行号索引实现
+ *
+ * 列号按字节计数，与逐字节前进时"遇到'\n'则行号加一、列号归一"的规则一致。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "line_index.h"
+#include "simd_scan.h"
+
+/**
+ * 初始化行号索引（不立即扫描源代码）
+ * @param index 行号索引
+ * @param source 源代码
+ * @param length 源代码长度
+ */
+void line_index_init(LineIndex *index, const char *source, size_t length) {
+    index->source = source;
+    index->length = length;
+    index->line_starts = NULL;
+    index->num_lines = 0;
+    index->capacity = 0;
+    index->built = false;
+}
+
+/**
+ * 追加一行的起始偏移
+ * @param index 行号索引
+ * @param start 起始偏移
+ */
+static void add_line(LineIndex *index, size_t start) {
+    if (index->num_lines == index->capacity) {
+        index->capacity = index->capacity ? index->capacity * 2 : 256;
+        size_t *grown = (size_t *)realloc(index->line_starts, sizeof(size_t) * index->capacity);
+        if (!grown) {
+            fprintf(stderr, "内存分配失败: line_index_build\n");
+            exit(1);
+        }
+        index->line_starts = grown;
+    }
+    index->line_starts[index->num_lines++] = start;
+}
+
+/**
+ * 扫描源代码中的所有换行符，建立行号索引
+ * @param index 行号索引
+ */
+static void line_index_build(LineIndex *index) {
+    add_line(index, 0);
+    size_t pos = 0;
+    while (1) {
+        pos = simd_find_newline(index->source, pos, index->length);
+        if (pos == index->length) break;
+        pos++;
+        add_line(index, pos);
+    }
+    index->built = true;
+}
+
+/**
+ * 计算字节偏移对应的行号和列号（均从1开始）
+ * @param index 行号索引（首次查询时建立）
+ * @param offset 字节偏移
+ * @param line 输出：行号
+ * @param column 输出：列号
+ */
+void line_index_position(LineIndex *index, size_t offset, int *line, int *column) {
+    if (!index->built) {
+        line_index_build(index);
+    }
+    
+    // 二分查找最后一个起始偏移不大于offset的行
+    int lo = 0;
+    int hi = index->num_lines - 1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo + 1) / 2;
+        if (index->line_starts[mid] <= offset) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    
+    *line = lo + 1;
+    *column = (int)(offset - index->line_starts[lo]) + 1;
+}
+
+/**
+ * 按编辑更新行号索引：删除被删去区间内的行首，加入插入文本中的换行，
+ * 其后的行首整体平移。尚未建立的索引只更新源代码。
+ * @param index 行号索引
+ * @param source 编辑后的源代码
+ * @param length 编辑后的源代码长度
+ * @param offset 编辑位置
+ * @param removed 删除的字节数
+ * @param inserted 插入的字节数（插入的文本位于source + offset）
+ */
+void line_index_edit(LineIndex *index, const char *source, size_t length, size_t offset,
+                     size_t removed, size_t inserted) {
+    index->source = source;
+    index->length = length;
+    if (!index->built) {
+        return;
+    }
+    
+    // [first, last)为起点落在(offset, offset + removed]中的行，随删除的换行一起消失
+    int lo = 0;
+    int hi = index->num_lines;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (index->line_starts[mid] > offset) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    int first = lo;
+    int last = first;
+    while (last < index->num_lines && index->line_starts[last] <= offset + removed) {
+        last++;
+    }
+    
+    int added = 0;
+    for (size_t p = offset; p < offset + inserted; p++) {
+        added += (source[p] == '\n');
+    }
+    
+    int tail = index->num_lines - last;
+    int num_lines = first + added + tail;
+    if (num_lines > index->capacity) {
+        while (index->capacity < num_lines) {
+            index->capacity *= 2;
+        }
+        size_t *grown = (size_t *)realloc(index->line_starts, sizeof(size_t) * index->capacity);
+        if (!grown) {
+            fprintf(stderr, "内存分配失败: line_index_edit\n");
+            exit(1);
+        }
+        index->line_starts = grown;
+    }
+    
+    memmove(index->line_starts + first + added, index->line_starts + last, sizeof(size_t) * tail);
+    for (int i = first + added; i < num_lines; i++) {
+        index->line_starts[i] = index->line_starts[i] - removed + inserted;
+    }
+    int i = first;
+    for (size_t p = offset; p < offset + inserted; p++) {
+        if (source[p] == '\n') {
+            index->line_starts[i++] = p + 1;
+        }
+    }
+    index->num_lines = num_lines;
+}
+
+/**
+ * 释放行号索引
+ * @param index 行号索引
+ */
+void line_index_free(LineIndex *index) {
+    free(index->line_starts);
+    index->line_starts = NULL;
+    index->num_lines = 0;
+    index->capacity = 0;
+    index->built = false;
+}
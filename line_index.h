@@ -0,0 +1,32 @@
+/**
+ * line_index.h - 行号索引头文件
+ *
+ * 词法分析只记录字节偏移，行号和列号只在报告错误、打印Token时才需要。
+ * 行号索引记录每一行的起始偏移，首次查询时用向量化扫描一次建立，
+ * 之后每次查询二分查找偏移所在的行。
+ */
+
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/* 行号索引 */
+typedef struct {
+    const char *source;     // 源代码
+    size_t length;          // 源代码长度
+    size_t *line_starts;    // 每一行的起始偏移（line_starts[0] = 0）
+    int num_lines;          // 行数
+    int capacity;           // line_starts容量
+    bool built;             // 是否已建立
+} LineIndex;
+
+/* 行号索引函数 */
+void line_index_init(LineIndex *index, const char *source, size_t length);
+void line_index_position(LineIndex *index, size_t offset, int *line, int *column);
+void line_index_edit(LineIndex *index, const char *source, size_t length, size_t offset,
+                     size_t removed, size_t inserted);
+void line_index_free(LineIndex *index);
+
+#endif /* LINE_INDEX_H */
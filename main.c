@@ -5,9 +5,23 @@
  * 
  * 使用方法：
  *   ./c0compiler -l <source_file>          # 词法分析
+ *   ./c0compiler -t [-j N] <source_file>   # 表驱动词法分析（-j时单个文件分块并行）
+ *   ./c0compiler -s <source_file>          # 流式词法分析（边读边分析）
+ *   ./c0compiler -p [-j N] <file>...       # 多文件并行词法分析（@list从列表文件读取文件名）
+ *   ./c0compiler -t --cache=<dir> <file>   # 表驱动词法分析，Token流缓存在dir中
+ *   ./c0compiler -t --direct <file>        # 表驱动词法分析，由直接编码的扫描器做最长匹配
+ *   ./c0compiler -t --lazy[=<bytes>] <file> # 表驱动词法分析，由状态缓存有上限的惰性DFA做最长匹配
+ *   ./c0compiler -t --stats <file>         # 另向标准错误输出各阶段耗时、Token分布和内存统计（-l同样适用）
+ *   （-l、-t、-s可加 --format=tsv|jsonl|binary 输出机器可读的Token序列）
+ *   （<source_file>为"-"时从标准输入读取）
+ *   ./c0compiler --serve [-j N] <socket>   # 常驻词法分析服务：经Unix域套接字接受请求
+ *   ./c0compiler --request <socket> <file>... # 请求服务分析文件，输出二进制Token流
+ *   ./c0compiler --shutdown <socket>       # 停止服务
+ *   ./c0compiler -a <source_file>          # 语法分析：输出抽象语法树
  *   ./c0compiler -n                        # 显示NFA
  *   ./c0compiler -d                        # 显示DFA
  *   ./c0compiler -m                        # 显示最简DFA
+ *   ./c0compiler --emit-tables <out.h>     # 生成静态扫描表头文件
  */
 
 #include <stdio.h>
@@ -16,6 +30,24 @@
 #include "token.h"
 #include "lexer.h"
 #include "nfa_dfa.h"
+#include "lazy_dfa.h"
+#include "source_file.h"
+#include "parallel_lex.h"
+#include "token_output.h"
+#include "token_cache.h"
+#include "lex_stats.h"
+#include "lex_server.h"
+#include "parser.h"
+
+/* 词法分析选项 */
+typedef struct {
+    int num_threads;        // 线程数（-t时大于1则分块并行分析，-p时为工作线程数）
+    OutputFormat format;    // 输出格式
+    const char *cache_dir;  // Token流缓存目录（NULL表示不使用缓存，仅用于-t）
+    bool stats;             // 是否向标准错误输出统计（仅用于-l、-t）
+    bool direct;            // 是否由直接编码的扫描器代替转换表（仅用于单线程的-t）
+    size_t lazy_budget;     // 惰性DFA的状态缓存预算（字节），0表示不使用惰性DFA（仅用于单线程的-t）
+} LexOptions;
 
 /**
  * 打印使用说明
@@ -24,111 +56,448 @@ void print_usage(const char *program_name) {
     printf("C0编译器 - 词法分析和自动机工具\n\n");
     printf("使用方法:\n");
     printf("  %s -l <source_file>    词法分析：输出Token序列\n", program_name);
+    printf("  %s -t <source_file>    表驱动词法分析：由预生成的最简DFA转换表驱动扫描\n", program_name);
+    printf("  %s -t -j N <source_file>  表驱动词法分析，大文件分块后由N个线程并行扫描\n", program_name);
+    printf("  %s -s <source_file>    流式词法分析：逐块读入，不缓存整个文件\n", program_name);
+    printf("  %s -p [-j N] <files>   多文件并行词法分析：N个线程（默认为处理器数），@list从列表文件读取文件名\n", program_name);
+    printf("  %s -t --cache=<dir> <source_file>  表驱动词法分析，源代码未改变时直接读取dir中缓存的Token流\n", program_name);
+    printf("  %s -t --direct <source_file>  表驱动词法分析，最长匹配由直接编码（goto）的扫描器完成，结果相同\n", program_name);
+    printf("  %s -t --lazy[=<bytes>] <source_file>  表驱动词法分析，最长匹配由惰性DFA完成：状态按需构造，缓存不超过预算（默认%d字节）\n", program_name, LAZY_DFA_DEFAULT_BUDGET);
+    printf("  %s -t --stats <source_file>  另向标准错误输出各阶段耗时、吞吐量、Token分布、内存和自动机统计（-l同样适用）\n", program_name);
+    printf("  %s -t --format=<fmt> <source_file>  以tsv、jsonl或binary格式输出Token（-l、-s同样适用）\n", program_name);
+    printf("  %s --serve [-j N] <socket>  常驻词法分析服务：N个工作线程（默认为处理器数）经Unix域套接字接受请求\n", program_name);
+    printf("  %s --request <socket> <files>  请求服务分析文件，输出与 -t --format=binary 相同的Token流\n", program_name);
+    printf("  %s --shutdown <socket>  停止词法分析服务\n", program_name);
+    printf("  %s -a <source_file>    语法分析：输出抽象语法树和语法错误\n", program_name);
     printf("  %s -n                  显示标识符NFA状态转换图\n", program_name);
     printf("  %s -d                  显示标识符DFA状态转换图\n", program_name);
     printf("  %s -m                  显示最简化DFA状态转换图和转换矩阵\n", program_name);
+    printf("  %s --emit-tables <out.h>  由扫描规则生成静态扫描表头文件\n", program_name);
     printf("  %s -h                  显示帮助信息\n\n", program_name);
     printf("示例:\n");
     printf("  %s -l test.c           # 对test.c进行词法分析\n", program_name);
+    printf("  %s -t - < test.c       # 从标准输入读取源代码\n", program_name);
     printf("  %s -n                  # 显示NFA\n", program_name);
     printf("  %s -d                  # 显示DFA\n", program_name);
     printf("  %s -m                  # 显示最简DFA\n\n", program_name);
 }
 
 /**
- * 读取源文件内容
- * @param filename 文件名
- * @return 文件内容字符串（需要调用者释放）
+ * 执行词法分析
+ * @param filename 源文件名（"-"表示标准输入）
+ * @param use_table 是否使用表驱动扫描
+ * @param options 词法分析选项（机器可读格式不回显源代码，也不输出标题和统计）
  */
-char *read_file(const char *filename) {
-    FILE *file = fopen(filename, "r");
-    if (!file) {
-        fprintf(stderr, "错误: 无法打开文件 '%s'\n", filename);
-        return NULL;
+void perform_lexical_analysis(const char *filename, bool use_table, const LexOptions *options) {
+    OutputFormat format = options->format;
+    bool text = format == OUTPUT_TEXT;
+    LexStats stats;
+    lex_stats_init(&stats);
+    if (text) {
+        printf("\n========================================\n");
+        printf("          词法分析结果\n");
+        printf("========================================\n\n");
+        printf("源文件: %s\n\n", filename);
+    }
+    
+    // 读取源文件（普通文件直接映射，词法分析器按长度扫描映射区）
+    double start = lex_stats_now();
+    SourceFile file;
+    if (!source_file_open(&file, filename)) {
+        return;
     }
+    const char *source = file.data;
+    size_t length = file.length;
+    stats.read_seconds = lex_stats_now() - start;
+    stats.bytes = length;
     
-    // 获取文件大小
-    fseek(file, 0, SEEK_END);
-    long file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
+    if (text) {
+        printf("源代码:\n");
+        printf("----------------------------------------\n");
+        // 源代码不以'\0'结尾，长度也可能超出int；按长度写出
+        fwrite(source, 1, length, stdout);
+        printf("\n");
+        printf("----------------------------------------\n\n");
+    }
     
-    // 分配内存并读取文件
-    char *content = (char *)malloc(file_size + 1);
-    if (!content) {
-        fprintf(stderr, "错误: 内存分配失败\n");
-        fclose(file);
-        return NULL;
+    // 表驱动扫描一次分析整个文件得到Token流（缓存命中时直接映射缓存），否则逐个获取Token
+    Lexer *lexer = NULL;
+    NFA *lazy_nfa = NULL;
+    LazyDFA lazy;
+    TokenStream stream;
+    CachedTokens cached;
+    TokenStream *tokens = &stream;
+    bool cache_hit = false;
+    start = lex_stats_now();
+    if (use_table) {
+        uint64_t hash = 0;
+        if (options->cache_dir) {
+            hash = token_cache_hash(source, length);
+            cache_hit = token_cache_lookup(options->cache_dir, hash, source, length, &cached);
+        }
+        if (cache_hit) {
+            tokens = &cached.stream;
+        } else {
+            if (options->num_threads > 1) {
+                lex_all_parallel(source, length, options->num_threads, &stream);
+            } else if (options->direct) {
+                lex_all_direct(source, length, &stream);
+            } else if (options->lazy_budget > 0) {
+                lazy_nfa = create_nfa_for_c0_tokens();
+                lazy_dfa_init(&lazy, lazy_nfa, options->lazy_budget);
+                lex_all_lazy(source, length, &lazy, &stream);
+            } else {
+                lex_all(source, length, &stream);
+            }
+            if (options->cache_dir && !token_cache_store(options->cache_dir, hash, length, &stream)) {
+                fprintf(stderr, "警告: 无法写入Token流缓存目录 '%s'\n", options->cache_dir);
+            }
+        }
+    } else {
+        lexer = create_lexer(source, length);
     }
+    LineIndex *lines = use_table ? &tokens->lines : &lexer->lines;
+    stats.lex_seconds = lex_stats_now() - start;
+    stats.cache_hit = cache_hit;
+    if (use_table && options->stats) {
+        lex_stats_count_stream(&stats, tokens);
+    }
+    double output_start = lex_stats_now();
     
-    size_t bytes_read = fread(content, 1, file_size, file);
-    content[bytes_read] = '\0';
+    TokenWriter writer;
+    if (text) {
+        printf("Token序列（二元组形式）:\n");
+        printf("========================================\n");
+    } else {
+        token_writer_init(&writer, stdout, format);
+    }
+    
+    int token_count = 0;
+    int error_count = 0;
+    
+    // 获取所有Token
+    for (int index = 0; ; index++) {
+        Token stream_token;
+        Token *token = &stream_token;
+        if (use_table) {
+            token_stream_get(tokens, index, &stream_token);
+        } else if (options->stats) {
+            // 手写扫描与输出交替进行，分别计时
+            start = lex_stats_now();
+            token = get_next_token(lexer);
+            stats.lex_seconds += lex_stats_now() - start;
+            lex_stats_count_token(&stats, token->type);
+        } else {
+            token = get_next_token(lexer);
+        }
+        
+        if (!text) {
+            int line, column;
+            line_index_position(lines, token->offset, &line, &column);
+            token_writer_write(&writer, token, line, column);
+            if (token->type == TOKEN_EOF) {
+                break;
+            }
+            continue;
+        }
+        
+        if (token->type == TOKEN_EOF) {
+            int line, column;
+            line_index_position(lines, token->offset, &line, &column);
+            printf("\n<EOF, > (行: %d, 列: %d)\n", line, column);
+            break;
+        }
+        
+        // 打印Token
+        print_token(lines, token);
+        token_count++;
+        
+        if (token->type == TOKEN_ERROR) {
+            error_count++;
+        }
+    }
+    
+    if (text) {
+        printf("\n========================================\n");
+        printf("分析完成！\n");
+        printf("共识别 %d 个Token\n", token_count);
+        if (error_count > 0) {
+            printf("发现 %d 个词法错误\n", error_count);
+        }
+        printf("========================================\n\n");
+    } else {
+        token_writer_free(&writer);
+    }
+    
+    if (options->stats) {
+        fflush(stdout);
+        stats.output_seconds = lex_stats_now() - output_start;
+        if (!use_table) {
+            stats.output_seconds -= stats.lex_seconds;
+            lex_stats_count_arena(&stats, &lexer->arena);
+        }
+        lex_stats_finish(&stats);
+        AutomatonStats automata;
+        automaton_stats_collect(&automata);
+        lex_stats_print(stderr, &stats, &automata);
+        if (lazy_nfa) {
+            lazy_dfa_print_stats(stderr, &lazy);
+        }
+    }
     
-    fclose(file);
-    return content;
+    // 清理（Token随词法分析器一起释放）
+    if (cache_hit) {
+        token_cache_release(&cached);
+    } else if (use_table) {
+        free_token_stream(&stream);
+    } else {
+        free_lexer(lexer);
+    }
+    if (lazy_nfa) {
+        lazy_dfa_free(&lazy);
+        free_nfa(lazy_nfa);
+    }
+    source_file_close(&file);
 }
 
 /**
- * 执行词法分析
- * @param filename 源文件名
+ * 执行流式词法分析：边读入边分析，不保存整个源文件，因而不打印源代码
+ * @param filename 源文件名（"-"表示标准输入）
+ * @param format 输出格式（机器可读格式不输出标题和统计）
  */
-void perform_lexical_analysis(const char *filename) {
-    printf("\n========================================\n");
-    printf("          词法分析结果\n");
-    printf("========================================\n\n");
-    printf("源文件: %s\n\n", filename);
+void perform_stream_analysis(const char *filename, OutputFormat format) {
+    bool text = format == OUTPUT_TEXT;
+    if (text) {
+        printf("\n========================================\n");
+        printf("          词法分析结果\n");
+        printf("========================================\n\n");
+        printf("源文件: %s\n\n", filename);
+    }
     
-    // 读取源文件
-    char *source = read_file(filename);
-    if (!source) {
+    int fd = source_file_open_stream(filename);
+    if (fd < 0) {
         return;
     }
     
-    printf("源代码:\n");
-    printf("----------------------------------------\n");
-    printf("%s\n", source);
-    printf("----------------------------------------\n\n");
+    StreamLexer stream;
+    stream_lexer_init(&stream, source_file_read_chunk, &fd);
     
-    // 创建词法分析器
-    Lexer *lexer = create_lexer(source);
-    
-    printf("Token序列（二元组形式）:\n");
-    printf("========================================\n");
+    TokenWriter writer;
+    if (text) {
+        printf("Token序列（二元组形式）:\n");
+        printf("========================================\n");
+    } else {
+        token_writer_init(&writer, stdout, format);
+    }
     
     int token_count = 0;
     int error_count = 0;
     
-    // 获取所有Token
     while (1) {
-        Token *token = get_next_token(lexer);
+        Token *token = stream_lexer_next(&stream);
+        int line, column;
+        stream_lexer_position(&stream, &line, &column);
+        
+        if (!text) {
+            token_writer_write(&writer, token, line, column);
+            if (token->type == TOKEN_EOF) {
+                break;
+            }
+            continue;
+        }
         
         if (token->type == TOKEN_EOF) {
-            printf("\n<EOF, > (行: %d, 列: %d)\n", token->line, token->column);
-            free_token(token);
+            printf("\n<EOF, > (行: %d, 列: %d)\n", line, column);
             break;
         }
         
-        // 打印Token
-        print_token(token);
+        print_token_at(stdout, token, line, column);
         token_count++;
         
         if (token->type == TOKEN_ERROR) {
             error_count++;
         }
+    }
+    
+    if (text) {
+        printf("\n========================================\n");
+        printf("分析完成！\n");
+        printf("共识别 %d 个Token\n", token_count);
+        if (error_count > 0) {
+            printf("发现 %d 个词法错误\n", error_count);
+        }
+        printf("========================================\n\n");
+    } else {
+        token_writer_free(&writer);
+    }
+    
+    free_stream_lexer(&stream);
+    source_file_close_stream(fd);
+}
+
+/**
+ * 执行语法分析：表驱动扫描得到Token流后分析整个程序，输出抽象语法树
+ * @param filename 源文件名（"-"表示标准输入）
+ * @return 是否没有词法和语法错误
+ */
+bool perform_syntax_analysis(const char *filename) {
+    printf("\n========================================\n");
+    printf("          语法分析结果\n");
+    printf("========================================\n\n");
+    printf("源文件: %s\n\n", filename);
+    
+    SourceFile file;
+    if (!source_file_open(&file, filename)) {
+        return false;
+    }
+    
+    TokenStream stream;
+    lex_all(file.data, file.length, &stream);
+    int lex_errors = 0;
+    for (int i = 0; i < stream.count; i++) {
+        if (stream.types[i] == TOKEN_ERROR) {
+            Token token;
+            token_stream_get(&stream, i, &token);
+            print_token(&stream.lines, &token);
+            lex_errors++;
+        }
+    }
+    
+    Ast ast;
+    bool ok = parse_program(&stream, &ast) && lex_errors == 0;
+    ast_print_errors(stdout, &ast);
+    if (lex_errors > 0 || ast.num_errors > 0) {
+        printf("\n");
+    }
+    
+    printf("抽象语法树:\n");
+    printf("========================================\n");
+    ast_print(stdout, &ast);
+    
+    printf("\n========================================\n");
+    printf("分析完成！\n");
+    printf("共 %d 个Token，%d 个语法树节点\n", stream.count - 1, ast.count);
+    if (lex_errors > 0) {
+        printf("发现 %d 个词法错误\n", lex_errors);
+    }
+    if (ast.num_errors > 0) {
+        printf("发现 %d 个语法错误\n", ast.num_errors);
+    }
+    printf("========================================\n\n");
+    
+    ast_free(&ast);
+    free_token_stream(&stream);
+    source_file_close(&file);
+    return ok;
+}
+
+/**
+ * 向文件名列表追加一个文件名（复制一份）
+ * @param names 文件名数组的地址
+ * @param count 文件名数量的地址
+ * @param capacity 数组容量的地址
+ * @param name 文件名
+ * @param length 文件名长度
+ */
+void add_file_name(char ***names, int *count, int *capacity, const char *name, size_t length) {
+    if (*count == *capacity) {
+        *capacity = *capacity ? *capacity * 2 : 16;
+        *names = (char **)realloc(*names, *capacity * sizeof(char *));
+        if (!*names) {
+            fprintf(stderr, "内存分配失败: add_file_name\n");
+            exit(1);
+        }
+    }
+    char *copy = (char *)malloc(length + 1);
+    if (!copy) {
+        fprintf(stderr, "内存分配失败: add_file_name\n");
+        exit(1);
+    }
+    memcpy(copy, name, length);
+    copy[length] = '\0';
+    (*names)[(*count)++] = copy;
+}
+
+/**
+ * 执行多文件并行词法分析
+ * @param args 文件名参数，"@list"表示从列表文件逐行读取文件名（忽略空行）
+ * @param num_args 参数数量
+ * @param num_threads 工作线程数
+ * @return 是否所有文件都能读取
+ */
+bool perform_parallel_analysis(char **args, int num_args, int num_threads) {
+    char **names = NULL;
+    int count = 0;
+    int capacity = 0;
+    
+    for (int i = 0; i < num_args; i++) {
+        if (args[i][0] != '@') {
+            add_file_name(&names, &count, &capacity, args[i], strlen(args[i]));
+            continue;
+        }
         
-        free_token(token);
+        SourceFile list;
+        if (!source_file_open(&list, args[i] + 1)) {
+            continue;
+        }
+        size_t pos = 0;
+        while (pos < list.length) {
+            size_t end = pos;
+            while (end < list.length && list.data[end] != '\n') {
+                end++;
+            }
+            size_t length = end - pos;
+            if (length > 0 && list.data[pos + length - 1] == '\r') {
+                length--;
+            }
+            if (length > 0) {
+                add_file_name(&names, &count, &capacity, list.data + pos, length);
+            }
+            pos = end + 1;
+        }
+        source_file_close(&list);
     }
     
+    ParallelLexSummary summary;
+    parallel_lex_files((const char *const *)names, count, num_threads, stdout, &summary);
+    
     printf("\n========================================\n");
     printf("分析完成！\n");
-    printf("共识别 %d 个Token\n", token_count);
-    if (error_count > 0) {
-        printf("发现 %d 个词法错误\n", error_count);
+    printf("共分析 %d 个文件（%d 个线程）\n", summary.num_files - summary.failed_files,
+           num_threads < count ? num_threads : count);
+    if (summary.failed_files > 0) {
+        printf("%d 个文件无法读取\n", summary.failed_files);
+    }
+    printf("共识别 %ld 个Token\n", summary.token_count);
+    if (summary.error_count > 0) {
+        printf("发现 %ld 个词法错误\n", summary.error_count);
     }
     printf("========================================\n\n");
     
-    // 清理
-    free_lexer(lexer);
-    free(source);
+    for (int i = 0; i < count; i++) {
+        free(names[i]);
+    }
+    free(names);
+    return summary.failed_files == 0;
+}
+
+/**
+ * 运行常驻词法分析服务，停止后向标准错误输出汇总
+ * @param socket_path 套接字路径
+ * @param num_threads 工作线程数
+ * @return 服务是否成功启动
+ */
+bool perform_server(const char *socket_path, int num_threads) {
+    LexServerSummary summary;
+    if (!lex_server_run(socket_path, num_threads, &summary)) {
+        return false;
+    }
+    fprintf(stderr, "词法分析服务已停止：%ld 个连接，%ld 个请求", summary.connections, summary.requests);
+    if (summary.failed_requests > 0) {
+        fprintf(stderr, "（%ld 个失败）", summary.failed_requests);
+    }
+    fprintf(stderr, "，共返回 %ld 个Token\n", summary.token_count);
+    return true;
 }
 
 /**
@@ -147,10 +516,10 @@ void show_nfa() {
     print_nfa(nfa);
     
     printf("说明:\n");
-    printf("- 状态0: 初始状态\n");
-    printf("- 状态1: 终态（接受状态）\n");
-    printf("- 从状态0到状态1: 必须读取一个字母\n");
-    printf("- 状态1的自环: 可以继续读取字母或数字\n\n");
+    printf("- 由正规式经Thompson构造法生成\n");
+    printf("- 状态0: 初始状态，经ε转换进入正规式片段\n");
+    printf("- 每个字符类对应一对状态，闭包通过ε转换实现\n");
+    printf("- 片段出口为终态（接受状态）\n\n");
     
     free_nfa(nfa);
 }
@@ -205,6 +574,58 @@ void show_minimized_dfa() {
     free_nfa(nfa);
 }
 
+/**
+ * 解析词法分析选项：-j <threads>、--format=<text|tsv|jsonl|binary>、--cache=<dir>、--stats、--direct 和 --lazy[=<bytes>]
+ * @param argc 参数数量
+ * @param argv 参数数组
+ * @param first 第一个待解析参数的下标
+ * @param options 输出：词法分析选项（未给出的选项保持原值）
+ * @return 第一个非选项参数的下标，选项有误时返回-1（已输出错误信息）
+ */
+int parse_lex_options(int argc, char *argv[], int first, LexOptions *options) {
+    while (first < argc) {
+        const char *arg = argv[first];
+        if (strcmp(arg, "-j") == 0 && first + 1 < argc) {
+            options->num_threads = atoi(argv[first + 1]);
+            if (options->num_threads < 1) {
+                fprintf(stderr, "错误: 线程数必须为正整数\n");
+                return -1;
+            }
+            first += 2;
+        } else if (strncmp(arg, "--format=", 9) == 0) {
+            if (!parse_output_format(arg + 9, &options->format)) {
+                fprintf(stderr, "错误: 未知的输出格式 '%s'（可选 text、tsv、jsonl、binary）\n", arg + 9);
+                return -1;
+            }
+            first++;
+        } else if (strncmp(arg, "--cache=", 8) == 0 && arg[8] != '\0') {
+            options->cache_dir = arg + 8;
+            first++;
+        } else if (strcmp(arg, "--stats") == 0) {
+            options->stats = true;
+            first++;
+        } else if (strcmp(arg, "--direct") == 0) {
+            options->direct = true;
+            first++;
+        } else if (strcmp(arg, "--lazy") == 0) {
+            options->lazy_budget = LAZY_DFA_DEFAULT_BUDGET;
+            first++;
+        } else if (strncmp(arg, "--lazy=", 7) == 0) {
+            char *end;
+            unsigned long budget = strtoul(arg + 7, &end, 10);
+            if (arg[7] < '0' || arg[7] > '9' || *end != '\0' || budget == 0) {
+                fprintf(stderr, "错误: 惰性DFA的内存预算必须为正整数（字节）\n");
+                return -1;
+            }
+            options->lazy_budget = budget;
+            first++;
+        } else {
+            break;
+        }
+    }
+    return first;
+}
+
 /**
  * 主函数
  */
@@ -220,14 +641,109 @@ int main(int argc, char *argv[]) {
         print_usage(argv[0]);
         return 0;
     }
-    else if (strcmp(option, "-l") == 0) {
-        // 词法分析
+    else if (strcmp(option, "-l") == 0 || strcmp(option, "-t") == 0 ||
+             strcmp(option, "-s") == 0 || strcmp(option, "-p") == 0) {
+        // 词法分析：-t -j N 分块并行，-s 流式，-p 多文件并行
+        LexOptions options;
+        options.num_threads = strcmp(option, "-p") == 0 ? parallel_lex_default_threads() : 1;
+        options.format = OUTPUT_TEXT;
+        options.cache_dir = NULL;
+        options.stats = false;
+        options.direct = false;
+        options.lazy_budget = 0;
+        int first = parse_lex_options(argc, argv, 2, &options);
+        if (first < 0) {
+            return 1;
+        }
+        if (argc <= first) {
+            fprintf(stderr, "错误: 缺少源文件参数\n");
+            if (strcmp(option, "-p") == 0) {
+                fprintf(stderr, "使用方法: %s -p [-j <threads>] <source_file>... | @<list_file>\n", argv[0]);
+            } else {
+                fprintf(stderr, "使用方法: %s %s <source_file>\n", argv[0], option);
+            }
+            return 1;
+        }
+        
+        if (options.format != OUTPUT_TEXT && strcmp(option, "-p") == 0) {
+            fprintf(stderr, "错误: --format 仅适用于 -l、-t 和 -s\n");
+            return 1;
+        }
+        if (options.cache_dir && strcmp(option, "-t") != 0) {
+            fprintf(stderr, "错误: --cache 仅适用于 -t\n");
+            return 1;
+        }
+        if (options.num_threads > 1 && (strcmp(option, "-l") == 0 || strcmp(option, "-s") == 0)) {
+            fprintf(stderr, "错误: -j 仅适用于 -t 和 -p\n");
+            return 1;
+        }
+        if (options.stats && (strcmp(option, "-p") == 0 || strcmp(option, "-s") == 0)) {
+            fprintf(stderr, "错误: --stats 仅适用于 -l 和 -t\n");
+            return 1;
+        }
+        if (options.direct && (strcmp(option, "-t") != 0 || options.num_threads > 1)) {
+            fprintf(stderr, "错误: --direct 仅适用于单线程的 -t\n");
+            return 1;
+        }
+        if (options.lazy_budget > 0 && (strcmp(option, "-t") != 0 || options.num_threads > 1 ||
+                                        options.direct)) {
+            fprintf(stderr, "错误: --lazy 仅适用于单线程的 -t，且不能与 --direct 同时使用\n");
+            return 1;
+        }
+        
+        if (strcmp(option, "-p") == 0) {
+            return perform_parallel_analysis(argv + first, argc - first, options.num_threads) ? 0 : 1;
+        } else if (strcmp(option, "-s") == 0) {
+            perform_stream_analysis(argv[first], options.format);
+        } else {
+            perform_lexical_analysis(argv[first], strcmp(option, "-t") == 0, &options);
+        }
+    }
+    else if (strcmp(option, "--serve") == 0) {
+        // 常驻词法分析服务：只接受 -j
+        int num_threads = parallel_lex_default_threads();
+        int first = 2;
+        if (first + 1 < argc && strcmp(argv[first], "-j") == 0) {
+            num_threads = atoi(argv[first + 1]);
+            if (num_threads < 1) {
+                fprintf(stderr, "错误: 线程数必须为正整数\n");
+                return 1;
+            }
+            first += 2;
+        }
+        if (argc != first + 1) {
+            fprintf(stderr, "错误: 缺少套接字路径参数\n");
+            fprintf(stderr, "使用方法: %s --serve [-j <threads>] <socket>\n", argv[0]);
+            return 1;
+        }
+        return perform_server(argv[first], num_threads) ? 0 : 1;
+    }
+    else if (strcmp(option, "--request") == 0) {
+        // 请求服务分析文件
+        if (argc < 4) {
+            fprintf(stderr, "错误: 缺少套接字路径或源文件参数\n");
+            fprintf(stderr, "使用方法: %s --request <socket> <source_file>...\n", argv[0]);
+            return 1;
+        }
+        return lex_server_request(argv[2], (const char *const *)(argv + 3), argc - 3, stdout) ? 0 : 1;
+    }
+    else if (strcmp(option, "--shutdown") == 0) {
+        // 停止服务
+        if (argc < 3) {
+            fprintf(stderr, "错误: 缺少套接字路径参数\n");
+            fprintf(stderr, "使用方法: %s --shutdown <socket>\n", argv[0]);
+            return 1;
+        }
+        return lex_server_shutdown(argv[2]) ? 0 : 1;
+    }
+    else if (strcmp(option, "-a") == 0) {
+        // 语法分析
         if (argc < 3) {
             fprintf(stderr, "错误: 缺少源文件参数\n");
-            fprintf(stderr, "使用方法: %s -l <source_file>\n", argv[0]);
+            fprintf(stderr, "使用方法: %s %s <source_file>\n", argv[0], option);
             return 1;
         }
-        perform_lexical_analysis(argv[2]);
+        return perform_syntax_analysis(argv[2]) ? 0 : 1;
     }
     else if (strcmp(option, "-n") == 0) {
         // 显示NFA
@@ -241,6 +757,15 @@ int main(int argc, char *argv[]) {
         // 显示最简DFA
         show_minimized_dfa();
     }
+    else if (strcmp(option, "--emit-tables") == 0) {
+        // 生成静态扫描表
+        if (argc < 3) {
+            fprintf(stderr, "错误: 缺少输出文件参数\n");
+            fprintf(stderr, "使用方法: %s %s <out.h>\n", argv[0], option);
+            return 1;
+        }
+        return emit_c0_scan_table(argv[2]) ? 0 : 1;
+    }
     else {
         fprintf(stderr, "错误: 未知选项 '%s'\n", option);
         print_usage(argv[0]);
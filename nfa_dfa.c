@@ -2,13 +2,306 @@
  * nfa_dfa.c - NFA和DFA算法实现
  * 
  * 实现以下功能：
- * 1. 构造标识符的NFA（字母开头，由字母和数字构成）
+ * 1. 构造标识符的NFA（字母开头，由字母和数字构成，Thompson构造法）
  * 2. NFA到DFA的转换（子集构造法）
- * 3. DFA的最简化（Hopcroft算法）
+ * 3. DFA的最简化（Hopcroft划分细化算法）
  * 4. 状态转换图的输出
+ *
+ * NFA的转换按添加顺序保存，并按起始状态建立CSR出边索引（ε出边与符号出边组分开，
+ * 单状态ε闭包按需计算并缓存）；
+ * DFA按字节等价类建表，每行只有等价类数量那么宽，两者都随状态数按需增长。
  */
 
 #include "nfa_dfa.h"
+#include "regex.h"
+
+/**
+ * 保证动态数组至少能容纳needed个元素，容量不足时按倍数扩充
+ * @param array 数组指针
+ * @param capacity 当前容量（会被更新）
+ * @param needed 需要的元素个数
+ * @param element_size 元素大小
+ * @param caller 调用者名称（用于报错）
+ * @return 扩充后的数组指针
+ */
+static void *grow_array(void *array, int *capacity, int needed, size_t element_size,
+                        const char *caller) {
+    if (needed <= *capacity) {
+        return array;
+    }
+    int new_capacity = *capacity > 0 ? *capacity : 16;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    void *grown = realloc(array, (size_t)new_capacity * element_size);
+    if (!grown) {
+        fprintf(stderr, "内存分配失败: %s\n", caller);
+        exit(1);
+    }
+    *capacity = new_capacity;
+    return grown;
+}
+
+/**
+ * 创建一个空的NFA（只有初始状态0）
+ * @return NFA指针
+ */
+NFA *create_nfa() {
+    NFA *nfa = (NFA *)calloc(1, sizeof(NFA));
+    if (!nfa) {
+        fprintf(stderr, "内存分配失败: create_nfa\n");
+        exit(1);
+    }
+    
+    nfa->start_state = nfa_add_state(nfa);
+    return nfa;
+}
+
+/**
+ * 向NFA添加一个新状态
+ * @param nfa NFA指针
+ * @return 新状态编号
+ */
+int nfa_add_state(NFA *nfa) {
+    int state = nfa->num_states;
+    if (state >= nfa->state_capacity) {
+        nfa->state_capacity = nfa->state_capacity > 0 ? nfa->state_capacity * 2 : 16;
+        nfa->final_states = (bool *)realloc(nfa->final_states,
+                                            sizeof(bool) * nfa->state_capacity);
+        nfa->accept_rule = (int *)realloc(nfa->accept_rule,
+                                          sizeof(int) * nfa->state_capacity);
+        if (!nfa->final_states || !nfa->accept_rule) {
+            fprintf(stderr, "内存分配失败: nfa_add_state\n");
+            exit(1);
+        }
+    }
+    
+    nfa->final_states[state] = false;
+    nfa->accept_rule[state] = NO_RULE;
+    nfa->num_states++;
+    nfa->indexed = false;
+    return state;
+}
+
+/**
+ * 向NFA添加一条转换
+ * @param nfa NFA指针
+ * @param from_state 起始状态
+ * @param to_state 目标状态
+ * @param symbol 转换符号（EPSILON表示ε转换）
+ */
+void nfa_add_transition(NFA *nfa, int from_state, int to_state, int symbol) {
+    nfa->transitions = (NFATransition *)grow_array(nfa->transitions, &nfa->transition_capacity,
+                                                   nfa->num_transitions + 1,
+                                                   sizeof(NFATransition), "nfa_add_transition");
+    NFATransition *t = &nfa->transitions[nfa->num_transitions++];
+    t->from_state = from_state;
+    t->to_state = to_state;
+    t->symbol = symbol;
+    nfa->indexed = false;
+}
+
+/**
+ * 将状态标记为终态
+ * @param nfa NFA指针
+ * @param state 状态
+ * @param rule 该终态识别的规则编号（编号越小优先级越高）
+ */
+void nfa_set_final(NFA *nfa, int state, int rule) {
+    nfa->final_states[state] = true;
+    nfa->accept_rule[state] = rule;
+}
+
+/**
+ * 释放NFA的出边索引和闭包缓存
+ * @param nfa NFA指针
+ */
+static void nfa_free_index(NFA *nfa) {
+    free(nfa->epsilon_offset);
+    free(nfa->epsilon_targets);
+    free(nfa->group_offset);
+    free(nfa->groups);
+    free(nfa->closures);
+    free(nfa->closure_done);
+    free(nfa->closure_stack);
+    nfa->epsilon_offset = NULL;
+    nfa->epsilon_targets = NULL;
+    nfa->group_offset = NULL;
+    nfa->groups = NULL;
+    nfa->closures = NULL;
+    nfa->closure_done = NULL;
+    nfa->closure_stack = NULL;
+    nfa->indexed = false;
+}
+
+/**
+ * 建立按起始状态分组的出边索引（CSR格式）
+ * ε出边和符号出边分开存放；符号出边按目标状态合并为出边组，
+ * Thompson构造中一个字符类只产生一个出边组。
+ * 同时为ε闭包缓存分配空间。转换集合改变后需要重新建立。
+ * @param nfa NFA指针
+ */
+void nfa_build_index(NFA *nfa) {
+    nfa_free_index(nfa);
+    
+    int n = nfa->num_states;
+    nfa->epsilon_offset = (int *)calloc((size_t)n + 1, sizeof(int));
+    nfa->epsilon_targets = (int *)malloc(sizeof(int) * (nfa->num_transitions + 1));
+    nfa->group_offset = (int *)calloc((size_t)n + 1, sizeof(int));
+    nfa->groups = (NFAEdgeGroup *)malloc(sizeof(NFAEdgeGroup) * (nfa->num_transitions + 1));
+    nfa->closure_words = (n + 63) / 64;
+    nfa->closures = (uint64_t *)malloc(sizeof(uint64_t) * ((size_t)n * nfa->closure_words + 1));
+    nfa->closure_done = (bool *)calloc((size_t)n + 1, sizeof(bool));
+    nfa->closure_stack = (int *)malloc(sizeof(int) * (n + 1));
+    int *order = (int *)malloc(sizeof(int) * (nfa->num_transitions + 1));
+    int *fill = (int *)malloc(sizeof(int) * (n + 1));
+    if (!nfa->epsilon_offset || !nfa->epsilon_targets || !nfa->group_offset || !nfa->groups ||
+        !nfa->closures || !nfa->closure_done || !nfa->closure_stack || !order || !fill) {
+        fprintf(stderr, "内存分配失败: nfa_build_index\n");
+        exit(1);
+    }
+    
+    // 计数排序：把所有转换按起始状态排好（行内保持添加顺序）
+    int *edge_offset = nfa->group_offset;   // 暂借作每行的转换计数
+    for (int i = 0; i < nfa->num_transitions; i++) {
+        edge_offset[nfa->transitions[i].from_state + 1]++;
+    }
+    for (int s = 0; s < n; s++) {
+        edge_offset[s + 1] += edge_offset[s];
+    }
+    memcpy(fill, edge_offset, sizeof(int) * n);
+    for (int i = 0; i < nfa->num_transitions; i++) {
+        order[fill[nfa->transitions[i].from_state]++] = i;
+    }
+    
+    // 逐行拆分为ε出边和符号出边组
+    int num_epsilon = 0;
+    int num_groups = 0;
+    for (int s = 0; s < n; s++) {
+        int row_start = edge_offset[s];
+        int row_end = edge_offset[s + 1];
+        int first_group = num_groups;
+        nfa->epsilon_offset[s] = num_epsilon;
+        
+        for (int k = row_start; k < row_end; k++) {
+            NFATransition *t = &nfa->transitions[order[k]];
+            if (t->symbol == EPSILON) {
+                nfa->epsilon_targets[num_epsilon++] = t->to_state;
+                continue;
+            }
+            
+            int g = first_group;
+            while (g < num_groups && nfa->groups[g].to_state != t->to_state) {
+                g++;
+            }
+            if (g == num_groups) {
+                nfa->groups[g].to_state = t->to_state;
+                memset(nfa->groups[g].symbols, 0, sizeof(nfa->groups[g].symbols));
+                num_groups++;
+            }
+            nfa->groups[g].symbols[t->symbol >> 6] |= (uint64_t)1 << (t->symbol & 63);
+        }
+        
+        // 本行已经处理完，可以覆盖为出边组的起始位置
+        edge_offset[s] = first_group;
+    }
+    nfa->epsilon_offset[n] = num_epsilon;
+    nfa->group_offset[n] = num_groups;
+    
+    free(order);
+    free(fill);
+    nfa->indexed = true;
+}
+
+/**
+ * 计算单个状态的ε闭包（带缓存）
+ * 以工作栈做一次深度优先遍历，每个可达状态只访问一次
+ * @param nfa NFA指针（出边索引必须已建立）
+ * @param state 状态
+ * @return 闭包位图（closure_words个字）
+ */
+static const uint64_t *state_closure(NFA *nfa, int state) {
+    uint64_t *bits = nfa->closures + (size_t)state * nfa->closure_words;
+    if (nfa->closure_done[state]) {
+        return bits;
+    }
+    
+    memset(bits, 0, sizeof(uint64_t) * nfa->closure_words);
+    bits[state >> 6] |= (uint64_t)1 << (state & 63);
+    int top = 0;
+    nfa->closure_stack[top++] = state;
+    
+    while (top > 0) {
+        int u = nfa->closure_stack[--top];
+        for (int j = nfa->epsilon_offset[u]; j < nfa->epsilon_offset[u + 1]; j++) {
+            int v = nfa->epsilon_targets[j];
+            uint64_t bit = (uint64_t)1 << (v & 63);
+            if (!(bits[v >> 6] & bit)) {
+                bits[v >> 6] |= bit;
+                nfa->closure_stack[top++] = v;
+            }
+        }
+    }
+    
+    nfa->closure_done[state] = true;
+    return bits;
+}
+
+/**
+ * 计算字节等价类
+ * 在NFA所有符号出边组中归属完全相同的字节互相等价：从"全部字节同类"出发，
+ * 依次用每个出边组的符号集合细分。不属于任何出边组的字节没有转换，记为-1；
+ * 其余等价类按所含最小字节的顺序编号。
+ * 例如标识符的NFA只有两个等价类：[0-9] 和 [A-Za-z_]。
+ * @param nfa NFA指针
+ * @param class_of 输出：每个字节所属的等价类
+ * @return 等价类数量
+ */
+int nfa_byte_classes(NFA *nfa, int class_of[MAX_ALPHABET]) {
+    if (!nfa->indexed) {
+        nfa_build_index(nfa);
+    }
+    
+    int cls[MAX_ALPHABET] = {0};
+    bool used[MAX_ALPHABET] = {false};     // 等价类是否属于某个出边组
+    int num_classes = 1;
+    
+    for (int g = 0; g < nfa->group_offset[nfa->num_states]; g++) {
+        const uint64_t *symbols = nfa->groups[g].symbols;
+        int split[MAX_ALPHABET][2];         // (旧等价类, 是否属于该组) -> 新等价类
+        bool new_used[MAX_ALPHABET];
+        for (int c = 0; c < num_classes; c++) {
+            split[c][0] = split[c][1] = -1;
+        }
+        
+        int count = 0;
+        for (int b = 0; b < MAX_ALPHABET; b++) {
+            int in_group = (symbols[b >> 6] >> (b & 63)) & 1;
+            int *target = &split[cls[b]][in_group];
+            if (*target == -1) {
+                new_used[count] = used[cls[b]] || in_group;
+                *target = count++;
+            }
+            cls[b] = *target;
+        }
+        num_classes = count;
+        memcpy(used, new_used, sizeof(bool) * count);
+    }
+    
+    // 按最小字节的顺序重新编号，没有转换的等价类记为-1
+    int renumber[MAX_ALPHABET];
+    for (int c = 0; c < num_classes; c++) {
+        renumber[c] = -2;
+    }
+    int result = 0;
+    for (int b = 0; b < MAX_ALPHABET; b++) {
+        if (renumber[cls[b]] == -2) {
+            renumber[cls[b]] = used[cls[b]] ? result++ : -1;
+        }
+        class_of[b] = renumber[cls[b]];
+    }
+    return result;
+}
 
 /**
  * 创建标识符的NFA
@@ -16,79 +309,17 @@
  * letter = [a-zA-Z_]
  * digit = [0-9]
  * 
- * 状态设计：
- * 状态0: 初始状态
- * 状态1: 读取了一个字母（也是终态）
+ * 由正规式经Thompson构造法生成，初始状态0经ε转换进入正规式片段，
+ * 片段出口为终态。
  * 
  * @return NFA指针
  */
 NFA *create_nfa_for_identifier() {
-    NFA *nfa = (NFA *)malloc(sizeof(NFA));
-    if (!nfa) {
-        fprintf(stderr, "内存分配失败: create_nfa_for_identifier\n");
+    NFA *nfa = create_nfa();
+    if (!nfa_add_regex(nfa, "[a-zA-Z_][a-zA-Z0-9_]*", 0)) {
+        fprintf(stderr, "无法构造标识符的NFA\n");
         exit(1);
     }
-    
-    // 初始化NFA
-    nfa->num_states = 2;
-    nfa->start_state = 0;
-    nfa->num_transitions = 0;
-    
-    // 初始化终态集合（状态1是终态）
-    for (int i = 0; i < MAX_STATES; i++) {
-        nfa->final_states[i] = false;
-    }
-    nfa->final_states[1] = true;
-    
-    // 添加转换：状态0 -> 状态1（字母）
-    // a-z
-    for (char c = 'a'; c <= 'z'; c++) {
-        nfa->transitions[nfa->num_transitions].from_state = 0;
-        nfa->transitions[nfa->num_transitions].to_state = 1;
-        nfa->transitions[nfa->num_transitions].symbol = c;
-        nfa->num_transitions++;
-    }
-    // A-Z
-    for (char c = 'A'; c <= 'Z'; c++) {
-        nfa->transitions[nfa->num_transitions].from_state = 0;
-        nfa->transitions[nfa->num_transitions].to_state = 1;
-        nfa->transitions[nfa->num_transitions].symbol = c;
-        nfa->num_transitions++;
-    }
-    // 下划线
-    nfa->transitions[nfa->num_transitions].from_state = 0;
-    nfa->transitions[nfa->num_transitions].to_state = 1;
-    nfa->transitions[nfa->num_transitions].symbol = '_';
-    nfa->num_transitions++;
-    
-    // 添加转换：状态1 -> 状态1（字母或数字）
-    // a-z
-    for (char c = 'a'; c <= 'z'; c++) {
-        nfa->transitions[nfa->num_transitions].from_state = 1;
-        nfa->transitions[nfa->num_transitions].to_state = 1;
-        nfa->transitions[nfa->num_transitions].symbol = c;
-        nfa->num_transitions++;
-    }
-    // A-Z
-    for (char c = 'A'; c <= 'Z'; c++) {
-        nfa->transitions[nfa->num_transitions].from_state = 1;
-        nfa->transitions[nfa->num_transitions].to_state = 1;
-        nfa->transitions[nfa->num_transitions].symbol = c;
-        nfa->num_transitions++;
-    }
-    // 0-9
-    for (char c = '0'; c <= '9'; c++) {
-        nfa->transitions[nfa->num_transitions].from_state = 1;
-        nfa->transitions[nfa->num_transitions].to_state = 1;
-        nfa->transitions[nfa->num_transitions].symbol = c;
-        nfa->num_transitions++;
-    }
-    // 下划线
-    nfa->transitions[nfa->num_transitions].from_state = 1;
-    nfa->transitions[nfa->num_transitions].to_state = 1;
-    nfa->transitions[nfa->num_transitions].symbol = '_';
-    nfa->num_transitions++;
-    
     return nfa;
 }
 
@@ -136,23 +367,57 @@ void print_nfa(NFA *nfa) {
  */
 void free_nfa(NFA *nfa) {
     if (nfa) {
+        free(nfa->final_states);
+        free(nfa->accept_rule);
+        free(nfa->transitions);
+        nfa_free_index(nfa);
         free(nfa);
     }
 }
 
+/**
+ * 初始化一个空的状态集合
+ * @param set 状态集合
+ * @param num_states 集合可容纳的状态数（NFA状态数）
+ */
+void state_set_init(StateSet *set, int num_states) {
+    set->num_words = (num_states + 63) / 64;
+    set->words = (uint64_t *)calloc(set->num_words > 0 ? set->num_words : 1, sizeof(uint64_t));
+    if (!set->words) {
+        fprintf(stderr, "内存分配失败: state_set_init\n");
+        exit(1);
+    }
+    set->count = 0;
+}
+
+/**
+ * 释放状态集合占用的内存
+ * @param set 状态集合
+ */
+void state_set_free(StateSet *set) {
+    free(set->words);
+    set->words = NULL;
+    set->num_words = 0;
+    set->count = 0;
+}
+
+/**
+ * 清空状态集合
+ * @param set 状态集合
+ */
+void state_set_clear(StateSet *set) {
+    memset(set->words, 0, sizeof(uint64_t) * set->num_words);
+    set->count = 0;
+}
+
 /**
  * 检查状态集合是否包含某个状态
  * @param set 状态集合
  * @param state 状态
  * @return 是否包含
  */
-bool state_set_contains(StateSet *set, int state) {
-    for (int i = 0; i < set->count; i++) {
-        if (set->states[i] == state) {
-            return true;
-        }
-    }
-    return false;
+bool state_set_contains(const StateSet *set, int state) {
+    return (set->words[state >> 6] >> (state & 63)) & 1;
 }
 
 /**
@@ -161,316 +426,658 @@ bool state_set_contains(StateSet *set, int state) {
  * @param state 要添加的状态
  */
 void state_set_add(StateSet *set, int state) {
-    if (!state_set_contains(set, state) && set->count < MAX_STATES) {
-        set->states[set->count++] = state;
+    uint64_t bit = (uint64_t)1 << (state & 63);
+    if (!(set->words[state >> 6] & bit)) {
+        set->words[state >> 6] |= bit;
+        set->count++;
     }
 }
 
 /**
- * 比较两个状态集合是否相等
+ * 按编号顺序遍历状态集合
+ * 用法：for (int s = state_set_next(set, 0); s >= 0; s = state_set_next(set, s + 1))
+ * @param set 状态集合
+ * @param state 起始编号
+ * @return 集合中不小于state的最小状态（没有则返回-1）
+ */
+int state_set_next(const StateSet *set, int state) {
+    int w = state >> 6;
+    if (w >= set->num_words) {
+        return -1;
+    }
+    uint64_t word = set->words[w] & (~(uint64_t)0 << (state & 63));
+    while (word == 0) {
+        if (++w >= set->num_words) {
+            return -1;
+        }
+        word = set->words[w];
+    }
+    return w * 64 + __builtin_ctzll(word);
+}
+
+/**
+ * 比较两个状态集合是否相等（与添加顺序无关）
  * @param a 状态集合a
  * @param b 状态集合b
  * @return 是否相等
  */
-bool state_set_equal(StateSet *a, StateSet *b) {
-    if (a->count != b->count) {
-        return false;
+bool state_set_equal(const StateSet *a, const StateSet *b) {
+    return a->count == b->count && a->num_words == b->num_words &&
+           memcmp(a->words, b->words, sizeof(uint64_t) * a->num_words) == 0;
+}
+
+/**
+ * 计算状态集合的散列值
+ * @param set 状态集合
+ * @return 散列值
+ */
+uint64_t state_set_hash(const StateSet *set) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (int i = 0; i < set->num_words; i++) {
+        h ^= set->words[i];
+        h *= 0x9e3779b97f4a7c15ULL;
+        h ^= h >> 29;
     }
-    
-    for (int i = 0; i < a->count; i++) {
-        if (!state_set_contains(b, a->states[i])) {
-            return false;
+    return h;
+}
+
+/**
+ * 初始化状态集合散列表
+ * @param map 散列表
+ */
+void state_set_map_init(StateSetMap *map) {
+    map->capacity = 64;
+    map->count = 0;
+    map->slots = (int *)malloc(sizeof(int) * map->capacity);
+    if (!map->slots) {
+        fprintf(stderr, "内存分配失败: state_set_map_init\n");
+        exit(1);
+    }
+    for (int i = 0; i < map->capacity; i++) {
+        map->slots[i] = -1;
+    }
+}
+
+/**
+ * 释放状态集合散列表
+ * @param map 散列表
+ */
+void state_set_map_free(StateSetMap *map) {
+    free(map->slots);
+    map->slots = NULL;
+    map->capacity = 0;
+    map->count = 0;
+}
+
+/**
+ * 在散列表中查找状态集合
+ * @param map 散列表
+ * @param sets 状态集合列表（散列表中的下标指向此列表）
+ * @param target 目标集合
+ * @return 集合在列表中的下标（找不到返回-1）
+ */
+int state_set_map_find(const StateSetMap *map, const StateSet *sets, const StateSet *target) {
+    int mask = map->capacity - 1;
+    int slot = (int)(state_set_hash(target) & (uint64_t)mask);
+    while (map->slots[slot] != -1) {
+        if (state_set_equal(&sets[map->slots[slot]], target)) {
+            return map->slots[slot];
         }
+        slot = (slot + 1) & mask;
     }
-    return true;
+    return -1;
 }
 
 /**
- * 计算ε闭包
- * @param nfa NFA指针
- * @param states 状态集合
- * @return ε闭包后的状态集合
+ * 把列表中的一个状态集合加入散列表（调用者保证集合尚不存在）
+ * 装填因子超过1/2时容量翻倍并重新散列
+ * @param map 散列表
+ * @param sets 状态集合列表
+ * @param index 集合在列表中的下标
  */
-StateSet epsilon_closure(NFA *nfa, StateSet states) {
-    StateSet closure = states;
-    bool changed = true;
-    
-    // 迭代添加通过ε转换可达的状态
-    while (changed) {
-        changed = false;
-        int old_count = closure.count;
-        
-        for (int i = 0; i < closure.count; i++) {
-            int state = closure.states[i];
-            
-            // 查找从当前状态出发的ε转换
-            for (int j = 0; j < nfa->num_transitions; j++) {
-                if (nfa->transitions[j].from_state == state &&
-                    nfa->transitions[j].symbol == EPSILON) {
-                    state_set_add(&closure, nfa->transitions[j].to_state);
-                }
-            }
+void state_set_map_insert(StateSetMap *map, const StateSet *sets, int index) {
+    if ((map->count + 1) * 2 > map->capacity) {
+        int *old_slots = map->slots;
+        int old_capacity = map->capacity;
+        map->capacity *= 2;
+        map->slots = (int *)malloc(sizeof(int) * map->capacity);
+        if (!map->slots) {
+            fprintf(stderr, "内存分配失败: state_set_map_insert\n");
+            exit(1);
         }
-        
-        if (closure.count > old_count) {
-            changed = true;
+        for (int i = 0; i < map->capacity; i++) {
+            map->slots[i] = -1;
         }
+        map->count = 0;
+        for (int i = 0; i < old_capacity; i++) {
+            if (old_slots[i] != -1) {
+                state_set_map_insert(map, sets, old_slots[i]);
+            }
+        }
+        free(old_slots);
     }
     
-    return closure;
+    int mask = map->capacity - 1;
+    int slot = (int)(state_set_hash(&sets[index]) & (uint64_t)mask);
+    while (map->slots[slot] != -1) {
+        slot = (slot + 1) & mask;
+    }
+    map->slots[slot] = index;
+    map->count++;
 }
 
 /**
- * 计算move操作
- * 从状态集合出发，经过某个符号到达的状态集合
+ * 计算ε闭包（原地扩充）
+ * 结果为集合中各状态的单状态闭包之并；单状态闭包已缓存，
+ * 新并入的状态其闭包必然是已并入部分的子集。
  * @param nfa NFA指针
- * @param states 状态集合
- * @param symbol 转换符号
- * @return 目标状态集合
+ * @param states 状态集合，返回时为其ε闭包
  */
-StateSet move(NFA *nfa, StateSet states, int symbol) {
-    StateSet result;
-    result.count = 0;
+void epsilon_closure(NFA *nfa, StateSet *states) {
+    if (!nfa->indexed) {
+        nfa_build_index(nfa);
+    }
     
-    for (int i = 0; i < states.count; i++) {
-        int state = states.states[i];
-        
-        // 查找从当前状态出发，经过symbol的转换
-        for (int j = 0; j < nfa->num_transitions; j++) {
-            if (nfa->transitions[j].from_state == state &&
-                nfa->transitions[j].symbol == symbol) {
-                state_set_add(&result, nfa->transitions[j].to_state);
-            }
+    for (int state = state_set_next(states, 0); state >= 0;
+         state = state_set_next(states, state + 1)) {
+        const uint64_t *closure = state_closure(nfa, state);
+        for (int w = 0; w < states->num_words; w++) {
+            states->words[w] |= closure[w];
         }
     }
     
-    return result;
+    states->count = 0;
+    for (int w = 0; w < states->num_words; w++) {
+        states->count += __builtin_popcountll(states->words[w]);
+    }
 }
 
 /**
- * 在状态集合列表中查找某个状态集合
- * @param sets 状态集合列表
- * @param num_sets 集合数量
- * @param target 目标集合
- * @return 索引（找不到返回-1）
+ * 计算move操作
+ * 从状态集合出发，经过某个符号到达的状态集合
+ * @param nfa NFA指针
+ * @param states 状态集合
+ * @param symbol 转换符号
+ * @param result 输出：目标状态集合（原有内容被清空）
  */
-int find_state_set_index(StateSet *sets, int num_sets, StateSet *target) {
-    for (int i = 0; i < num_sets; i++) {
-        if (state_set_equal(&sets[i], target)) {
-            return i;
+void move(NFA *nfa, const StateSet *states, int symbol, StateSet *result) {
+    if (!nfa->indexed) {
+        nfa_build_index(nfa);
+    }
+    
+    state_set_clear(result);
+    uint64_t bit = (uint64_t)1 << (symbol & 63);
+    
+    for (int state = state_set_next(states, 0); state >= 0;
+         state = state_set_next(states, state + 1)) {
+        // 只检查当前状态的符号出边组
+        for (int g = nfa->group_offset[state]; g < nfa->group_offset[state + 1]; g++) {
+            if (nfa->groups[g].symbols[symbol >> 6] & bit) {
+                state_set_add(result, nfa->groups[g].to_state);
+            }
         }
     }
-    return -1;
 }
 
 /**
- * NFA到DFA的转换（子集构造法）
- * @param nfa NFA指针
+ * 创建一个没有状态的DFA
+ * @param class_of 每个字节所属的等价类（-1表示没有转换）
+ * @param num_classes 等价类数量，即转换表每行的宽度
  * @return DFA指针
  */
-DFA *nfa_to_dfa(NFA *nfa) {
-    DFA *dfa = (DFA *)malloc(sizeof(DFA));
+DFA *create_dfa(const int class_of[MAX_ALPHABET], int num_classes) {
+    DFA *dfa = (DFA *)calloc(1, sizeof(DFA));
     if (!dfa) {
-        fprintf(stderr, "内存分配失败: nfa_to_dfa\n");
+        fprintf(stderr, "内存分配失败: create_dfa\n");
         exit(1);
     }
     
-    // 初始化DFA
-    for (int i = 0; i < MAX_STATES; i++) {
-        for (int j = 0; j < MAX_ALPHABET; j++) {
-            dfa->transition[i][j] = -1; // -1表示没有转换
+    dfa->start_state = 0;
+    dfa->alphabet_size = num_classes;
+    for (int c = MAX_ALPHABET - 1; c >= 0; c--) {
+        dfa->symbol_index[c] = class_of[c];
+        if (class_of[c] >= 0) {
+            dfa->alphabet[class_of[c]] = (unsigned char)c;    // 最终为最小字节
         }
-        dfa->final_states[i] = false;
     }
     
-    // 构建字母表（字母和数字、下划线）
-    dfa->alphabet_size = 0;
-    for (char c = 'a'; c <= 'z'; c++) {
-        dfa->alphabet[dfa->alphabet_size++] = c;
+    return dfa;
+}
+
+/**
+ * 向DFA添加一个新状态（没有任何转换的非终态）
+ * @param dfa DFA指针
+ * @return 新状态编号
+ */
+int dfa_add_state(DFA *dfa) {
+    int state = dfa->num_states;
+    if (state >= dfa->state_capacity) {
+        dfa->state_capacity = dfa->state_capacity > 0 ? dfa->state_capacity * 2 : 16;
+        dfa->final_states = (bool *)realloc(dfa->final_states,
+                                            sizeof(bool) * dfa->state_capacity);
+        dfa->accept_rule = (int *)realloc(dfa->accept_rule,
+                                          sizeof(int) * dfa->state_capacity);
+        // 行宽至少为1，避免字母表为空时分配0字节
+        size_t row_width = dfa->alphabet_size > 0 ? (size_t)dfa->alphabet_size : 1;
+        dfa->transition = (int *)realloc(dfa->transition,
+                                         sizeof(int) * row_width * dfa->state_capacity);
+        if (!dfa->final_states || !dfa->accept_rule || !dfa->transition) {
+            fprintf(stderr, "内存分配失败: dfa_add_state\n");
+            exit(1);
+        }
     }
-    for (char c = 'A'; c <= 'Z'; c++) {
-        dfa->alphabet[dfa->alphabet_size++] = c;
+    
+    for (int i = 0; i < dfa->alphabet_size; i++) {
+        dfa->transition[state * dfa->alphabet_size + i] = -1; // -1表示没有转换
     }
-    for (char c = '0'; c <= '9'; c++) {
-        dfa->alphabet[dfa->alphabet_size++] = c;
+    dfa->final_states[state] = false;
+    dfa->accept_rule[state] = NO_RULE;
+    dfa->num_states++;
+    return state;
+}
+
+/**
+ * 查询DFA转换
+ * @param dfa DFA指针
+ * @param state 当前状态
+ * @param symbol 输入符号
+ * @return 目标状态（-1表示没有转换）
+ */
+int dfa_next(const DFA *dfa, int state, int symbol) {
+    int index = dfa->symbol_index[symbol];
+    if (index < 0) {
+        return -1;
     }
-    dfa->alphabet[dfa->alphabet_size++] = '_';
+    return dfa->transition[state * dfa->alphabet_size + index];
+}
+
+/**
+ * 设置DFA转换
+ * @param dfa DFA指针
+ * @param state 当前状态
+ * @param symbol 输入符号（必须在字母表中）
+ * @param next_state 目标状态
+ */
+void dfa_set_next(DFA *dfa, int state, int symbol, int next_state) {
+    dfa->transition[state * dfa->alphabet_size + dfa->symbol_index[symbol]] = next_state;
+}
+
+/**
+ * NFA到DFA的转换（子集构造法）
+ * @param nfa NFA指针
+ * @return DFA指针
+ */
+DFA *nfa_to_dfa(NFA *nfa) {
+    // 字母表：字节等价类，同一等价类的字节转换完全相同，只需用代表字节计算一次
+    int class_of[MAX_ALPHABET];
+    int num_classes = nfa_byte_classes(nfa, class_of);
+    DFA *dfa = create_dfa(class_of, num_classes);
     
-    // 状态集合列表（DFA的每个状态对应NFA的一个状态集合）
-    StateSet dfa_states[MAX_STATES];
+    // 状态集合列表（DFA的每个状态对应NFA的一个状态集合），由散列表索引
+    StateSet *dfa_states = NULL;
+    int dfa_states_capacity = 0;
     int num_dfa_states = 0;
+    StateSetMap map;
+    state_set_map_init(&map);
     
     // 计算初始状态的ε闭包
-    StateSet initial_set;
-    initial_set.count = 1;
-    initial_set.states[0] = nfa->start_state;
-    initial_set = epsilon_closure(nfa, initial_set);
-    
-    dfa_states[num_dfa_states++] = initial_set;
-    dfa->start_state = 0;
+    dfa_states = (StateSet *)grow_array(dfa_states, &dfa_states_capacity, 1,
+                                        sizeof(StateSet), "nfa_to_dfa");
+    state_set_init(&dfa_states[0], nfa->num_states);
+    state_set_add(&dfa_states[0], nfa->start_state);
+    epsilon_closure(nfa, &dfa_states[0]);
+    num_dfa_states = 1;
+    state_set_map_insert(&map, dfa_states, 0);
+    dfa->start_state = dfa_add_state(dfa);
     
-    // 工作队列
-    int unmarked[MAX_STATES];
+    // 工作队列（每个DFA状态恰好入队一次）
+    int *unmarked = NULL;
+    int unmarked_capacity = 0;
+    unmarked = (int *)grow_array(unmarked, &unmarked_capacity, 1, sizeof(int), "nfa_to_dfa");
     int unmarked_count = 1;
     unmarked[0] = 0;
     
+    StateSet next_set;
+    state_set_init(&next_set, nfa->num_states);
+    
     // 子集构造算法
     while (unmarked_count > 0) {
         // 取出一个未标记的状态
         int current_dfa_state = unmarked[--unmarked_count];
-        StateSet current_set = dfa_states[current_dfa_state];
         
-        // 对字母表中的每个符号
+        // 对每个等价类（取其代表字节）
         for (int i = 0; i < dfa->alphabet_size; i++) {
-            char symbol = dfa->alphabet[i];
+            int symbol = dfa->alphabet[i];
             
             // 计算move和ε闭包
-            StateSet next_set = move(nfa, current_set, symbol);
+            move(nfa, &dfa_states[current_dfa_state], symbol, &next_set);
             if (next_set.count > 0) {
-                next_set = epsilon_closure(nfa, next_set);
+                epsilon_closure(nfa, &next_set);
                 
                 // 查找或创建新的DFA状态
-                int next_dfa_state = find_state_set_index(dfa_states, num_dfa_states, &next_set);
+                int next_dfa_state = state_set_map_find(&map, dfa_states, &next_set);
                 if (next_dfa_state == -1) {
-                    // 新状态
-                    next_dfa_state = num_dfa_states;
-                    dfa_states[num_dfa_states++] = next_set;
+                    // 新状态：集合的所有权转移到列表中
+                    dfa_states = (StateSet *)grow_array(dfa_states, &dfa_states_capacity,
+                                                        num_dfa_states + 1, sizeof(StateSet),
+                                                        "nfa_to_dfa");
+                    unmarked = (int *)grow_array(unmarked, &unmarked_capacity,
+                                                 unmarked_count + 1, sizeof(int), "nfa_to_dfa");
+                    next_dfa_state = dfa_add_state(dfa);
+                    dfa_states[num_dfa_states] = next_set;
+                    state_set_map_insert(&map, dfa_states, num_dfa_states);
+                    num_dfa_states++;
+                    state_set_init(&next_set, nfa->num_states);
                     unmarked[unmarked_count++] = next_dfa_state;
                 }
                 
                 // 添加转换
-                dfa->transition[current_dfa_state][(int)symbol] = next_dfa_state;
+                dfa_set_next(dfa, current_dfa_state, symbol, next_dfa_state);
             }
         }
     }
     
-    dfa->num_states = num_dfa_states;
-    
-    // 确定终态（包含NFA终态的DFA状态）
+    // 确定终态（包含NFA终态的DFA状态），多个规则同时接受时取编号最小者
     for (int i = 0; i < num_dfa_states; i++) {
-        for (int j = 0; j < dfa_states[i].count; j++) {
-            if (nfa->final_states[dfa_states[i].states[j]]) {
+        for (int nfa_state = state_set_next(&dfa_states[i], 0); nfa_state >= 0;
+             nfa_state = state_set_next(&dfa_states[i], nfa_state + 1)) {
+            if (nfa->final_states[nfa_state]) {
+                int rule = nfa->accept_rule[nfa_state];
                 dfa->final_states[i] = true;
-                break;
+                if (dfa->accept_rule[i] == NO_RULE || rule < dfa->accept_rule[i]) {
+                    dfa->accept_rule[i] = rule;
+                }
             }
         }
     }
     
+    for (int i = 0; i < num_dfa_states; i++) {
+        state_set_free(&dfa_states[i]);
+    }
+    state_set_free(&next_set);
+    state_set_map_free(&map);
+    free(dfa_states);
+    free(unmarked);
+    
     return dfa;
 }
 
 /**
- * DFA的最简化（状态等价类划分）
- * 使用Hopcroft算法的简化版本
+ * DFA的最简化（Hopcroft划分细化算法）
+ * 
+ * 1. 补上一个死状态使DFA完全，初始划分按识别的规则分组（非终态与死状态同组）
+ * 2. 为每个符号建立逆转换表：pred[a][t] = {p | δ(p, a) = t}
+ * 3. 以(块, 符号)为分裂器维护工作表；取出分裂器(B, a)时，
+ *    把经a可到达B的所有状态X找出来，用X分裂与之相交的每个块Y
+ * 4. Y被分成Y∩X和Y\X后，若(Y, c)已在工作表中则把新块也加入，
+ *    否则只加入较小的一半，总复杂度为O(k·n·log n)，k为字母表大小
+ * 5. 与死状态同块的状态不可能到达终态，在最简DFA中删除
+ * 
+ * 块用"可细化划分"表示：所有状态存放在elements数组中，
+ * 每个块占据一段连续区间，被标记的状态交换到区间前部。
  * @param dfa 原DFA
  * @return 最简化的DFA
  */
 DFA *minimize_dfa(DFA *dfa) {
-    // 简化实现：将终态和非终态作为初始划分
-    int partition[MAX_STATES];     // 每个状态所属的划分
-    int num_partitions = 2;        // 划分数量
+    int n = dfa->num_states + 1;        // 最后一个状态为补上的死状态
+    int dead = n - 1;
+    int k = dfa->alphabet_size;
     
-    // 初始划分：0 - 非终态，1 - 终态
-    for (int i = 0; i < dfa->num_states; i++) {
-        partition[i] = dfa->final_states[i] ? 1 : 0;
+    int *elements = (int *)malloc(sizeof(int) * n);     // 按块排列的状态
+    int *location = (int *)malloc(sizeof(int) * n);     // 状态在elements中的位置
+    int *block_of = (int *)malloc(sizeof(int) * n);     // 状态所属的块
+    int *block_start = (int *)malloc(sizeof(int) * n);  // 块区间 [start, end)
+    int *block_end = (int *)malloc(sizeof(int) * n);
+    int *marked = (int *)calloc(n, sizeof(int));        // 块中已标记的状态数
+    int *touched = (int *)malloc(sizeof(int) * n);      // 本轮被标记过的块
+    int *preds = (int *)malloc(sizeof(int) * n);        // 本轮找到的前驱状态
+    int *pred_offset = (int *)calloc((size_t)k * n + 1, sizeof(int));
+    int *pred_states = (int *)malloc(sizeof(int) * ((size_t)k * n + 1));
+    int *worklist = (int *)malloc(sizeof(int) * ((size_t)k * n + 1));
+    bool *in_worklist = (bool *)calloc((size_t)k * n + 1, sizeof(bool));
+    int *new_id = (int *)malloc(sizeof(int) * n);
+    if (!elements || !location || !block_of || !block_start || !block_end || !marked ||
+        !touched || !preds || !pred_offset || !pred_states || !worklist || !in_worklist ||
+        !new_id) {
+        fprintf(stderr, "内存分配失败: minimize_dfa\n");
+        exit(1);
     }
     
-    // 迭代细化划分
-    bool changed = true;
-    while (changed) {
-        changed = false;
-        int new_partition[MAX_STATES];
-        memcpy(new_partition, partition, sizeof(partition));
-        int next_partition_id = num_partitions;
+    // 建立逆转换表（CSR格式，按(符号, 目标状态)分组）
+    for (int p = 0; p < n; p++) {
+        for (int a = 0; a < k; a++) {
+            int t = p == dead ? -1 : dfa->transition[p * k + a];
+            if (t == -1) t = dead;
+            pred_offset[a * n + t + 1]++;
+        }
+    }
+    for (int i = 0; i < k * n; i++) {
+        pred_offset[i + 1] += pred_offset[i];
+    }
+    int *fill = new_id;     // 暂借作填充位置
+    for (int a = 0; a < k; a++) {
+        for (int t = 0; t < n; t++) {
+            fill[t] = pred_offset[a * n + t];
+        }
+        for (int p = 0; p < n; p++) {
+            int t = p == dead ? -1 : dfa->transition[p * k + a];
+            if (t == -1) t = dead;
+            pred_states[fill[t]++] = p;
+        }
+    }
+    
+    // 初始划分：识别同一规则的终态归入同一块，非终态和死状态归入一块
+    int num_blocks = 0;
+    int *block_rule = touched;  // 暂借作各初始块对应的规则编号
+    for (int s = 0; s < n; s++) {
+        int rule = s == dead ? NO_RULE : dfa->accept_rule[s];
+        int b = 0;
+        while (b < num_blocks && block_rule[b] != rule) {
+            b++;
+        }
+        if (b == num_blocks) {
+            block_rule[num_blocks++] = rule;
+        }
+        block_of[s] = b;
+    }
+    // 按块计数排序，使每个块占据连续区间
+    int *block_size = marked;   // 暂借作块大小计数
+    for (int s = 0; s < n; s++) block_size[block_of[s]]++;
+    int offset = 0;
+    for (int b = 0; b < num_blocks; b++) {
+        block_start[b] = block_end[b] = offset;
+        offset += block_size[b];
+        block_size[b] = 0;
+    }
+    for (int s = 0; s < n; s++) {
+        int b = block_of[s];
+        elements[block_end[b]] = s;
+        location[s] = block_end[b]++;
+    }
+    
+    // 初始工作表：所有(块, 符号)
+    int worklist_count = 0;
+    for (int b = 0; b < num_blocks; b++) {
+        for (int a = 0; a < k; a++) {
+            worklist[worklist_count++] = b * k + a;
+            in_worklist[b * k + a] = true;
+        }
+    }
+    
+    while (worklist_count > 0) {
+        int splitter = worklist[--worklist_count];
+        in_worklist[splitter] = false;
+        int splitter_block = splitter / k;
+        int a = splitter % k;
         
-        // 对每个划分
-        for (int p = 0; p < num_partitions; p++) {
-            // 收集该划分中的状态
-            int states_in_partition[MAX_STATES];
-            int count = 0;
-            for (int i = 0; i < dfa->num_states; i++) {
-                if (partition[i] == p) {
-                    states_in_partition[count++] = i;
-                }
+        // 找出经符号a进入分裂块的所有状态
+        int num_preds = 0;
+        for (int i = block_start[splitter_block]; i < block_end[splitter_block]; i++) {
+            int t = elements[i];
+            for (int j = pred_offset[a * n + t]; j < pred_offset[a * n + t + 1]; j++) {
+                preds[num_preds++] = pred_states[j];
+            }
+        }
+        
+        // 标记：把被标记的状态交换到所在块的前部
+        int num_touched = 0;
+        for (int i = 0; i < num_preds; i++) {
+            int p = preds[i];
+            int b = block_of[p];
+            if (marked[b] == 0) {
+                touched[num_touched++] = b;
+            }
+            int target = block_start[b] + marked[b];
+            int other = elements[target];
+            elements[location[p]] = other;
+            location[other] = location[p];
+            elements[target] = p;
+            location[p] = target;
+            marked[b]++;
+        }
+        
+        // 分裂每个被部分标记的块
+        for (int i = 0; i < num_touched; i++) {
+            int y = touched[i];
+            int size = block_end[y] - block_start[y];
+            int num_marked = marked[y];
+            marked[y] = 0;
+            if (num_marked == size) {
+                continue;
             }
             
-            if (count <= 1) continue;
+            // 较小的一半成为新块z并重新标注
+            int z = num_blocks++;
+            if (num_marked <= size - num_marked) {
+                block_start[z] = block_start[y];
+                block_end[z] = block_start[y] + num_marked;
+                block_start[y] = block_end[z];
+            } else {
+                block_start[z] = block_start[y] + num_marked;
+                block_end[z] = block_end[y];
+                block_end[y] = block_start[z];
+            }
+            for (int j = block_start[z]; j < block_end[z]; j++) {
+                block_of[elements[j]] = z;
+            }
             
-            // 检查这些状态是否可区分
-            for (int i = 1; i < count; i++) {
-                int s1 = states_in_partition[0];
-                int s2 = states_in_partition[i];
-                bool distinguishable = false;
-                
-                // 检查所有输入符号
-                for (int j = 0; j < dfa->alphabet_size; j++) {
-                    char symbol = dfa->alphabet[j];
-                    int next1 = dfa->transition[s1][(int)symbol];
-                    int next2 = dfa->transition[s2][(int)symbol];
-                    
-                    if ((next1 == -1) != (next2 == -1)) {
-                        distinguishable = true;
-                        break;
-                    }
-                    
-                    if (next1 != -1 && next2 != -1 && 
-                        partition[next1] != partition[next2]) {
-                        distinguishable = true;
-                        break;
-                    }
-                }
-                
-                if (distinguishable) {
-                    new_partition[s2] = next_partition_id++;
-                    changed = true;
+            // 更新工作表：(y, c)待处理时(z, c)也需处理，否则只需加入较小的一半，
+            // z总是较小的一半，因此两种情况都是加入(z, c)
+            for (int c = 0; c < k; c++) {
+                if (!in_worklist[z * k + c]) {
+                    worklist[worklist_count++] = z * k + c;
+                    in_worklist[z * k + c] = true;
                 }
             }
         }
-        
-        memcpy(partition, new_partition, sizeof(partition));
-        num_partitions = next_partition_id;
     }
     
-    // 构造最简DFA
-    DFA *min_dfa = (DFA *)malloc(sizeof(DFA));
-    if (!min_dfa) {
-        fprintf(stderr, "内存分配失败: minimize_dfa\n");
-        exit(1);
+    // 构造最简DFA：按原状态编号顺序为块编号，删除死状态所在的块
+    for (int b = 0; b < num_blocks; b++) {
+        new_id[b] = -1;
     }
-    
-    // 初始化
-    for (int i = 0; i < MAX_STATES; i++) {
-        for (int j = 0; j < MAX_ALPHABET; j++) {
-            min_dfa->transition[i][j] = -1;
+    int num_min_states = 0;
+    for (int s = 0; s < dfa->num_states; s++) {
+        int b = block_of[s];
+        if (b != block_of[dead] && new_id[b] == -1) {
+            new_id[b] = num_min_states++;
         }
-        min_dfa->final_states[i] = false;
     }
     
-    min_dfa->num_states = num_partitions;
-    min_dfa->start_state = partition[dfa->start_state];
-    min_dfa->alphabet_size = dfa->alphabet_size;
-    memcpy(min_dfa->alphabet, dfa->alphabet, dfa->alphabet_size);
+    DFA *min_dfa = create_dfa(dfa->symbol_index, dfa->alphabet_size);
+    for (int i = 0; i < num_min_states; i++) {
+        dfa_add_state(min_dfa);
+    }
+    min_dfa->start_state = new_id[block_of[dfa->start_state]];
+    if (min_dfa->start_state == -1) {
+        // 整个DFA不接受任何串：保留一个没有转换的初始状态
+        min_dfa->start_state = dfa_add_state(min_dfa);
+    }
     
     // 建立转换
     for (int i = 0; i < dfa->num_states; i++) {
-        int p = partition[i];
+        int p = new_id[block_of[i]];
+        if (p == -1) continue;
         
         if (dfa->final_states[i]) {
             min_dfa->final_states[p] = true;
+            min_dfa->accept_rule[p] = dfa->accept_rule[i];
         }
         
-        for (int j = 0; j < dfa->alphabet_size; j++) {
-            char symbol = dfa->alphabet[j];
-            int next = dfa->transition[i][(int)symbol];
-            if (next != -1) {
-                min_dfa->transition[p][(int)symbol] = partition[next];
+        for (int j = 0; j < k; j++) {
+            int next = dfa->transition[i * k + j];
+            if (next != -1 && new_id[block_of[next]] != -1) {
+                min_dfa->transition[p * k + j] = new_id[block_of[next]];
             }
         }
     }
     
+    free(elements);
+    free(location);
+    free(block_of);
+    free(block_start);
+    free(block_end);
+    free(marked);
+    free(touched);
+    free(preds);
+    free(pred_offset);
+    free(pred_states);
+    free(worklist);
+    free(in_worklist);
+    free(new_id);
+    
     return min_dfa;
 }
 
+/**
+ * 打印一个字节：可打印字符原样输出，其余输出为\xHH
+ * @param c 字节
+ */
+static void print_class_byte(int c) {
+    if (c >= 33 && c <= 126 && c != '\\' && c != '-' && c != ']') {
+        printf("%c", c);
+    } else {
+        printf("\\x%02X", c);
+    }
+}
+
+/**
+ * 打印一个等价类包含的字节，单个字节形如['a']，多个字节按区间形如[0-9A-F]
+ * @param dfa DFA指针
+ * @param cls 等价类
+ */
+static void print_symbol_class(const DFA *dfa, int cls) {
+    int count = 0;
+    for (int c = 0; c < MAX_ALPHABET; c++) {
+        if (dfa->symbol_index[c] == cls) count++;
+    }
+    if (count == 1) {
+        int c = dfa->alphabet[cls];
+        if (c >= 32 && c <= 126) {
+            printf("['%c']", c);
+        } else {
+            printf("[ASCII:%d]", c);
+        }
+        return;
+    }
+    
+    printf("[");
+    for (int c = 0; c < MAX_ALPHABET; c++) {
+        if (dfa->symbol_index[c] != cls) continue;
+        int end = c;
+        while (end + 1 < MAX_ALPHABET && dfa->symbol_index[end + 1] == cls) end++;
+        print_class_byte(c);
+        if (end > c + 1) {
+            printf("-");
+        }
+        if (end > c) {
+            print_class_byte(end);
+        }
+        c = end;
+    }
+    printf("]");
+}
+
 /**
  * 打印DFA状态转换图
  * @param dfa DFA指针
@@ -497,10 +1104,11 @@ void print_dfa(DFA *dfa) {
     
     for (int i = 0; i < dfa->num_states; i++) {
         for (int j = 0; j < dfa->alphabet_size; j++) {
-            char symbol = dfa->alphabet[j];
-            int next = dfa->transition[i][(int)symbol];
+            int next = dfa->transition[i * dfa->alphabet_size + j];
             if (next != -1) {
-                printf("    %d    ->    %d     ['%c']\n", i, next, symbol);
+                printf("    %d    ->    %d     ", i, next);
+                print_symbol_class(dfa, j);
+                printf("\n");
             }
         }
     }
@@ -537,7 +1145,7 @@ void print_dfa_transition_matrix(DFA *dfa) {
         printf("    %d     |", i);
         char test_symbols[] = {'a', 'z', 'A', 'Z', '0', '9', '_'};
         for (int j = 0; j < 7; j++) {
-            int next = dfa->transition[i][(int)test_symbols[j]];
+            int next = dfa_next(dfa, i, (unsigned char)test_symbols[j]);
             if (next != -1) {
                 printf("  %d  |", next);
             } else {
@@ -555,6 +1163,9 @@ void print_dfa_transition_matrix(DFA *dfa) {
  */
 void free_dfa(DFA *dfa) {
     if (dfa) {
+        free(dfa->transition);
+        free(dfa->final_states);
+        free(dfa->accept_rule);
         free(dfa);
     }
 }
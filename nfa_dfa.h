@@ -1,7 +1,9 @@
 /**
  * nfa_dfa.h - NFA和DFA数据结构和算法头文件
- * 
+ *
  * 实现正规式到NFA的转换、NFA到DFA的确定化、DFA的最简化
+ *
+ * 状态和转换均存放在按需增长的堆内存中，内存占用与自动机的实际规模成正比
  */
 
 #ifndef NFA_DFA_H
@@ -11,10 +13,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 
-#define MAX_STATES 100      // 最大状态数
-#define MAX_ALPHABET 128    // 字母表最大大小
+#define MAX_ALPHABET 256    // 字母表最大大小（按字节）
 #define EPSILON -1          // ε转换标记
+#define NO_RULE -1          // 非终态的规则编号
 
 /* NFA状态转换结构 */
 typedef struct {
@@ -23,39 +26,80 @@ typedef struct {
     int symbol;             // 转换符号（EPSILON表示ε转换）
 } NFATransition;
 
+/* NFA符号出边组：从同一状态到同一目标的所有符号合并为一个字节集合 */
+typedef struct {
+    int to_state;           // 目标状态
+    uint64_t symbols[MAX_ALPHABET / 64]; // 符号集合位图
+} NFAEdgeGroup;
+
 /* NFA结构 */
 typedef struct {
     int num_states;         // 状态数量
+    int state_capacity;     // 状态数组容量
     int start_state;        // 初始状态
-    bool final_states[MAX_STATES]; // 终态集合
-    NFATransition transitions[MAX_STATES * MAX_ALPHABET]; // 转换集合
+    bool *final_states;     // 终态集合
+    int *accept_rule;       // 终态识别的规则编号（编号小者优先）
+    NFATransition *transitions; // 转换集合（按添加顺序）
     int num_transitions;    // 转换数量
+    int transition_capacity; // 转换数组容量
+
+    /* 按起始状态分组的出边索引（CSR格式），由nfa_build_index生成 */
+    int *epsilon_offset;    // 状态s的ε出边为 epsilon_targets[epsilon_offset[s] .. epsilon_offset[s+1])
+    int *epsilon_targets;   // ε出边的目标状态
+    int *group_offset;      // 状态s的符号出边组为 groups[group_offset[s] .. group_offset[s+1])
+    NFAEdgeGroup *groups;   // 符号出边组
+    uint64_t *closures;     // 各状态的ε闭包位图（每个状态closure_words个字，按需计算）
+    bool *closure_done;     // 各状态的ε闭包是否已计算
+    int *closure_stack;     // 计算闭包用的工作栈
+    int closure_words;      // 闭包位图的字数
+    bool indexed;           // 出边索引是否与转换集合一致
 } NFA;
 
-/* DFA状态转换表 */
+/* DFA状态转换表（按字节等价类建表，每行只保存各等价类一项） */
 typedef struct {
-    int transition[MAX_STATES][MAX_ALPHABET]; // 转换表：[状态][符号] -> 目标状态
+    int *transition;        // 转换表：transition[状态 * alphabet_size + 等价类] -> 目标状态
     int num_states;         // 状态数量
+    int state_capacity;     // 状态数组容量
     int start_state;        // 初始状态
-    bool final_states[MAX_STATES]; // 终态集合
-    int alphabet_size;      // 字母表大小
-    char alphabet[MAX_ALPHABET]; // 字母表
+    bool *final_states;     // 终态集合
+    int *accept_rule;       // 终态识别的规则编号（NO_RULE表示非终态）
+    int alphabet_size;      // 字母表大小（字节等价类数量）
+    unsigned char alphabet[MAX_ALPHABET]; // 每个等价类的代表字节
+    int symbol_index[MAX_ALPHABET]; // 字节 -> 等价类（-1表示该字节上没有任何转换）
 } DFA;
 
-/* 状态集合（用于子集构造法） */
+/* 状态集合（用于子集构造法）：固定宽度位图，第s位表示是否包含NFA状态s */
 typedef struct {
-    int states[MAX_STATES]; // 状态列表
+    uint64_t *words;        // 位图
+    int num_words;          // 位图字数（由NFA状态数决定）
     int count;              // 状态数量
 } StateSet;
 
+/* 状态集合散列表：状态集合 -> DFA状态编号（开放定址，线性探测） */
+typedef struct {
+    int *slots;             // 槽中存放集合在列表中的下标，-1表示空槽
+    int capacity;           // 槽数（2的幂）
+    int count;              // 已存放的集合数量
+} StateSetMap;
+
 /* NFA操作函数 */
+NFA *create_nfa();
+int nfa_add_state(NFA *nfa);
+void nfa_add_transition(NFA *nfa, int from_state, int to_state, int symbol);
+void nfa_set_final(NFA *nfa, int state, int rule);
+void nfa_build_index(NFA *nfa);
+int nfa_byte_classes(NFA *nfa, int class_of[MAX_ALPHABET]);
 NFA *create_nfa_for_identifier();
 void print_nfa(NFA *nfa);
 void free_nfa(NFA *nfa);
-StateSet epsilon_closure(NFA *nfa, StateSet states);
-StateSet move(NFA *nfa, StateSet states, int symbol);
+void epsilon_closure(NFA *nfa, StateSet *states);
+void move(NFA *nfa, const StateSet *states, int symbol, StateSet *result);
 
 /* DFA操作函数 */
+DFA *create_dfa(const int class_of[MAX_ALPHABET], int num_classes);
+int dfa_add_state(DFA *dfa);
+int dfa_next(const DFA *dfa, int state, int symbol);
+void dfa_set_next(DFA *dfa, int state, int symbol, int next_state);
 DFA *nfa_to_dfa(NFA *nfa);
 DFA *minimize_dfa(DFA *dfa);
 void print_dfa(DFA *dfa);
@@ -63,9 +107,17 @@ void print_dfa_transition_matrix(DFA *dfa);
 void free_dfa(DFA *dfa);
 
 /* 辅助函数 */
-bool state_set_contains(StateSet *set, int state);
+void state_set_init(StateSet *set, int num_states);
+void state_set_free(StateSet *set);
+void state_set_clear(StateSet *set);
+bool state_set_contains(const StateSet *set, int state);
 void state_set_add(StateSet *set, int state);
-bool state_set_equal(StateSet *a, StateSet *b);
-int find_state_set_index(StateSet *sets, int num_sets, StateSet *target);
+int state_set_next(const StateSet *set, int state);
+bool state_set_equal(const StateSet *a, const StateSet *b);
+uint64_t state_set_hash(const StateSet *set);
+void state_set_map_init(StateSetMap *map);
+void state_set_map_free(StateSetMap *map);
+int state_set_map_find(const StateSetMap *map, const StateSet *sets, const StateSet *target);
+void state_set_map_insert(StateSetMap *map, const StateSet *sets, int index);
 
 #endif /* NFA_DFA_H */
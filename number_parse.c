@@ -0,0 +1,277 @@
+/**
+ * number_parse.c - 数值常量转换实现
+ *
+ * 浮点数的转换按Lemire的Eisel-Lemire算法：19位以内的10进制尾数w与10^q的
+ * 128位近似值相乘，乘积的高位即双精度尾数；近似误差可能影响舍入时放弃，
+ * 改用strtod。结果与strtod（即atof）完全相同。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <float.h>
+#include <math.h>
+#include "number_parse.h"
+#include "power_tables.h"
+
+#define MAX_FAST_DIGITS 19      // uint64_t一定能容纳的10进制位数
+#define MAX_EXPONENT 100000     // 指数的绝对值超过它时结果一定是0或无穷大
+
+/**
+ * 判断词素是否为16进制整数（0x或0X开头）
+ */
+static bool is_hex_literal(const char *text, size_t length) {
+    return length >= 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X');
+}
+
+/**
+ * 16进制数字的值
+ * @return 0-15，不是16进制数字时返回-1
+ */
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * 转换整型常量（10进制，或0x开头的16进制）
+ * 在第一个不是数字的字符处停止；溢出时结果取LLONG_MAX，与strtoll一致。
+ * @param text 词素起始地址（无需以'\0'结尾）
+ * @param length 词素长度
+ * @param value 输出：常量值
+ * @return NUMBER_OK，或超出long long范围时返回NUMBER_OVERFLOW
+ */
+NumberStatus parse_int_literal(const char *text, size_t length, long long *value) {
+    unsigned long long result = 0;
+    size_t i = 0;
+    
+    if (is_hex_literal(text, length)) {
+        for (i = 2; i < length; i++) {
+            int digit = hex_digit(text[i]);
+            if (digit < 0) break;
+            if (result > (unsigned long long)LLONG_MAX >> 4) {
+                *value = LLONG_MAX;
+                return NUMBER_OVERFLOW;
+            }
+            result = (result << 4) | (unsigned)digit;
+        }
+        *value = (long long)result;
+        return NUMBER_OK;
+    }
+    
+    // 前18位不可能溢出，不必逐位检查
+    size_t safe = length < MAX_FAST_DIGITS - 1 ? length : MAX_FAST_DIGITS - 1;
+    for (; i < safe && text[i] >= '0' && text[i] <= '9'; i++) {
+        result = result * 10 + (unsigned)(text[i] - '0');
+    }
+    for (; i < length && text[i] >= '0' && text[i] <= '9'; i++) {
+        unsigned digit = (unsigned)(text[i] - '0');
+        if (result > ((unsigned long long)LLONG_MAX - digit) / 10) {
+            *value = LLONG_MAX;
+            return NUMBER_OVERFLOW;
+        }
+        result = result * 10 + digit;
+    }
+    *value = (long long)result;
+    return NUMBER_OK;
+}
+
+/**
+ * 64位乘64位，得到128位乘积
+ * @param a 乘数
+ * @param b 乘数
+ * @param low 输出：乘积的低64位
+ * @return 乘积的高64位
+ */
+static uint64_t multiply_128(uint64_t a, uint64_t b, uint64_t *low) {
+#if defined(__SIZEOF_INT128__)
+    __extension__ unsigned __int128 product = (unsigned __int128)a * b;
+    *low = (uint64_t)product;
+    return (uint64_t)(product >> 64);
+#else
+    uint64_t a_lo = a & 0xFFFFFFFFu, a_hi = a >> 32;
+    uint64_t b_lo = b & 0xFFFFFFFFu, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+    *low = (cross << 32) | (lo_lo & 0xFFFFFFFFu);
+    return (hi_lo >> 32) + (cross >> 32) + hi_hi;
+#endif
+}
+
+/**
+ * 前导0的个数
+ * @param x 非0的64位整数
+ */
+static int leading_zeros(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    while (!(x >> 63)) {
+        x <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/**
+ * Eisel-Lemire算法：求w * 10^exp10最接近的双精度数
+ * @param w 10进制尾数（非0）
+ * @param exp10 10的次幂（位于幂表范围内）
+ * @param value 输出：结果
+ * @return 能否确定正确舍入的结果（否则应交给strtod）
+ */
+static bool eisel_lemire(uint64_t w, int exp10, double *value) {
+    int shift = leading_zeros(w);
+    w <<= shift;
+    // 217706 / 2^16 ≈ log2(10)：10^exp10的2进制指数
+    int64_t exp2 = (((int64_t)217706 * exp10) >> 16) + 64 + 1023 - shift;
+    
+    const uint64_t *power = power_table[exp10 - POWER_TABLE_MIN_EXP10];
+    uint64_t low;
+    uint64_t high = multiply_128(w, power[0], &low);
+    
+    // 高位的低9位全为1时截断误差可能进位，再乘上幂的低64位
+    if ((high & 0x1FF) == 0x1FF && low + w < w) {
+        uint64_t extra_low;
+        uint64_t extra_high = multiply_128(w, power[1], &extra_low);
+        uint64_t merged_low = low + extra_high;
+        uint64_t merged_high = high + (merged_low < low);
+        if ((merged_high & 0x1FF) == 0x1FF && merged_low + 1 == 0 && extra_low + w < w) {
+            return false;
+        }
+        high = merged_high;
+        low = merged_low;
+    }
+    
+    // 取高54位（多一位用于舍入）
+    uint64_t top = high >> 63;
+    uint64_t mantissa = high >> (top + 9);
+    exp2 -= 1 ^ top;
+    
+    // 恰好在两个双精度数正中间：近似值无法判断向偶数舍入的方向
+    if (low == 0 && (high & 0x1FF) == 0 && (mantissa & 3) == 1) {
+        return false;
+    }
+    
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >> 53) {
+        mantissa >>= 1;
+        exp2++;
+    }
+    
+    // 非规格化数、无穷大交给strtod
+    if (exp2 <= 0 || exp2 >= 0x7FF) {
+        return false;
+    }
+    
+    uint64_t bits = ((uint64_t)exp2 << 52) | (mantissa & 0x000FFFFFFFFFFFFFULL);
+    memcpy(value, &bits, sizeof(double));
+    return true;
+}
+
+/**
+ * 用strtod转换（词素先复制为以'\0'结尾的字符串）
+ */
+static double parse_double_slow(const char *text, size_t length) {
+    char buffer[64];
+    char *copy = buffer;
+    if (length >= sizeof(buffer)) {
+        copy = (char *)malloc(length + 1);
+        if (!copy) {
+            fprintf(stderr, "内存分配失败: parse_double_literal\n");
+            exit(1);
+        }
+    }
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    double value = strtod(copy, NULL);
+    if (copy != buffer) {
+        free(copy);
+    }
+    return value;
+}
+
+/**
+ * 转换浮点常量：数字[.数字][e|E[+|-]数字]（指数的数字可以为空，与atof一致）
+ * @param text 词素起始地址（无需以'\0'结尾）
+ * @param length 词素长度
+ * @param value 输出：正确舍入的常量值
+ * @return NUMBER_OK，或超出double范围（结果为无穷大）时返回NUMBER_OVERFLOW
+ */
+NumberStatus parse_double_literal(const char *text, size_t length, double *value) {
+    static const double EXACT_POWERS[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    
+    uint64_t w = 0;
+    int digits = 0;         // w中的有效数字位数（不含前导0）
+    int exp10 = 0;
+    bool truncated = false;
+    size_t i = 0;
+    
+    for (; i < length && text[i] >= '0' && text[i] <= '9'; i++) {
+        if (digits < MAX_FAST_DIGITS) {
+            w = w * 10 + (uint64_t)(text[i] - '0');
+            digits += (w != 0);
+        } else {
+            exp10++;
+            truncated |= (text[i] != '0');
+        }
+    }
+    if (i < length && text[i] == '.') {
+        for (i++; i < length && text[i] >= '0' && text[i] <= '9'; i++) {
+            if (digits < MAX_FAST_DIGITS) {
+                w = w * 10 + (uint64_t)(text[i] - '0');
+                digits += (w != 0);
+                exp10--;
+            } else {
+                truncated |= (text[i] != '0');
+            }
+        }
+    }
+    if (i < length && (text[i] == 'e' || text[i] == 'E')) {
+        bool negative = false;
+        i++;
+        if (i < length && (text[i] == '+' || text[i] == '-')) {
+            negative = (text[i] == '-');
+            i++;
+        }
+        int exponent = 0;
+        for (; i < length && text[i] >= '0' && text[i] <= '9'; i++) {
+            if (exponent < MAX_EXPONENT) {
+                exponent = exponent * 10 + (text[i] - '0');
+            }
+        }
+        exp10 += negative ? -exponent : exponent;
+    }
+    
+    double result;
+    if (w == 0 && !truncated) {
+        result = 0.0;
+    } else if (truncated) {
+        result = parse_double_slow(text, length);   // 超过19位有效数字
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    } else if (w <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22) {
+        // w和10^|exp10|都能精确表示，一次乘除即正确舍入
+        result = exp10 >= 0 ? (double)w * EXACT_POWERS[exp10] : (double)w / EXACT_POWERS[-exp10];
+#endif
+    } else if (exp10 < POWER_TABLE_MIN_EXP10 || exp10 > POWER_TABLE_MAX_EXP10 ||
+               !eisel_lemire(w, exp10, &result)) {
+        result = parse_double_slow(text, length);
+    }
+    
+    *value = result;
+    return isinf(result) ? NUMBER_OVERFLOW : NUMBER_OK;
+}
@@ -0,0 +1,25 @@
+/**
+ * number_parse.h - 数值常量转换头文件
+ *
+ * 直接在源代码中的词素上转换整型和浮点常量，不复制词素、不要求以'\0'结尾。
+ * 整数（10进制和16进制）逐位累加并检查溢出；浮点数先走精确的快速路径
+ * （尾数不超过2^53且10的次幂不超过22），再用Eisel-Lemire算法由预生成的
+ * 10的幂表（power_tables.h）求出正确舍入的结果，两者都无法确定时才交给strtod。
+ */
+
+#ifndef NUMBER_PARSE_H
+#define NUMBER_PARSE_H
+
+#include <stddef.h>
+
+/* 数值常量的转换结果 */
+typedef enum {
+    NUMBER_OK,          // 转换成功
+    NUMBER_OVERFLOW     // 超出表示范围（整数取LLONG_MAX，浮点数为无穷大）
+} NumberStatus;
+
+/* 数值转换函数 */
+NumberStatus parse_int_literal(const char *text, size_t length, long long *value);
+NumberStatus parse_double_literal(const char *text, size_t length, double *value);
+
+#endif /* NUMBER_PARSE_H */
@@ -0,0 +1,344 @@
+/**
+ * parallel_lex.c - 多文件并行词法分析实现
+ *
+ * 线程之间只共享任务区间（各有一把锁）和完成标志；扫描表、关键字表都是只读的，
+ * 每个文件的Token流、区域分配器和输出缓冲区只由处理它的线程访问。
+ * 单个大文件可以分块推测分析后拼接（lex_all_parallel）。
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "parallel_lex.h"
+#include "lexer.h"
+#include "source_file.h"
+#include "simd_scan.h"
+
+/* 单个文件的分析任务 */
+typedef struct {
+    const char *filename;   // 文件名
+    char *output;           // 该文件的输出（由open_memstream分配）
+    size_t output_size;     // 输出长度
+    int token_count;        // Token数量（不含EOF）
+    int error_count;        // 词法错误数量
+    bool failed;            // 文件是否无法读取
+    bool done;              // 是否已完成（受done_lock保护）
+} LexJob;
+
+/* 一个工作线程的任务区间 [lo, hi)：本线程从lo端取，其他线程从hi端窃取 */
+typedef struct {
+    pthread_mutex_t lock;   // 保护lo和hi
+    int lo;                 // 下一个由本线程处理的任务
+    int hi;                 // 区间末尾（不含）
+} JobRange;
+
+/* 线程池共享状态 */
+typedef struct {
+    LexJob *jobs;           // 全部任务（按文件顺序）
+    JobRange *ranges;       // 各线程的任务区间
+    int num_threads;        // 工作线程数量
+    pthread_mutex_t done_lock; // 保护各任务的done标志
+    pthread_cond_t done_cond;  // 有任务完成时广播
+} LexPool;
+
+/* 工作线程参数 */
+typedef struct {
+    LexPool *pool;          // 线程池
+    int id;                 // 线程编号（即自己的任务区间下标）
+} LexWorker;
+
+/**
+ * 取出下一个任务：先取自己区间的头部，区间为空时依次从其他线程区间的尾部窃取
+ * @param pool 线程池
+ * @param id 线程编号
+ * @return 任务下标，全部任务已分完时返回-1
+ */
+static int take_job(LexPool *pool, int id) {
+    for (int k = 0; k < pool->num_threads; k++) {
+        JobRange *range = &pool->ranges[(id + k) % pool->num_threads];
+        int job = -1;
+        pthread_mutex_lock(&range->lock);
+        if (range->lo < range->hi) {
+            job = (k == 0) ? range->lo++ : --range->hi;
+        }
+        pthread_mutex_unlock(&range->lock);
+        if (job >= 0) {
+            return job;
+        }
+    }
+    return -1;
+}
+
+/**
+ * 分析一个文件，输出写入任务自己的缓冲区
+ * 输出格式与-l的Token序列相同，不回显源代码
+ * @param job 任务
+ */
+static void lex_one_file(LexJob *job) {
+    SourceFile file;
+    if (!source_file_open(&file, job->filename)) {
+        job->failed = true;
+        return;
+    }
+    
+    FILE *out = open_memstream(&job->output, &job->output_size);
+    if (!out) {
+        fprintf(stderr, "内存分配失败: lex_one_file\n");
+        exit(1);
+    }
+    
+    TokenStream stream;
+    lex_all(file.data, file.length, &stream);
+    
+    fprintf(out, "\n========================================\n");
+    fprintf(out, "源文件: %s\n", job->filename);
+    fprintf(out, "========================================\n");
+    
+    for (int index = 0; ; index++) {
+        Token token;
+        int line, column;
+        token_stream_get(&stream, index, &token);
+        line_index_position(&stream.lines, token.offset, &line, &column);
+        
+        if (token.type == TOKEN_EOF) {
+            fprintf(out, "\n<EOF, > (行: %d, 列: %d)\n", line, column);
+            break;
+        }
+        
+        print_token_at(out, &token, line, column);
+        job->token_count++;
+        if (token.type == TOKEN_ERROR) {
+            job->error_count++;
+        }
+    }
+    
+    fprintf(out, "共识别 %d 个Token", job->token_count);
+    if (job->error_count > 0) {
+        fprintf(out, "，发现 %d 个词法错误", job->error_count);
+    }
+    fprintf(out, "\n");
+    
+    fclose(out);
+    free_token_stream(&stream);
+    source_file_close(&file);
+}
+
+/**
+ * 工作线程：不断取任务分析，直到全部任务分完
+ * @param arg 工作线程参数（LexWorker）
+ * @return NULL
+ */
+static void *lex_worker(void *arg) {
+    LexWorker *worker = (LexWorker *)arg;
+    LexPool *pool = worker->pool;
+    
+    int job;
+    while ((job = take_job(pool, worker->id)) >= 0) {
+        lex_one_file(&pool->jobs[job]);
+        
+        pthread_mutex_lock(&pool->done_lock);
+        pool->jobs[job].done = true;
+        pthread_cond_broadcast(&pool->done_cond);
+        pthread_mutex_unlock(&pool->done_lock);
+    }
+    return NULL;
+}
+
+/* 单文件分块分析的一个线程参数 */
+typedef struct {
+    const char *source;     // 源代码
+    size_t length;          // 源代码长度
+    size_t stop;            // 下一块的起点
+    LexChunk *chunk;        // 输出：该块的结果（chunk->start为块起点）
+} ChunkWorker;
+
+/**
+ * 分块分析线程：推测分析一块
+ * @param arg 线程参数（ChunkWorker）
+ * @return NULL
+ */
+static void *chunk_worker(void *arg) {
+    ChunkWorker *worker = (ChunkWorker *)arg;
+    lex_chunk(worker->source, worker->length, worker->chunk->start, worker->stop, worker->chunk);
+    return NULL;
+}
+
+/**
+ * 单个大文件的并行词法分析，结果与lex_all完全相同
+ * 缓冲区按字节数均分为若干块，块起点后移到下一行行首（Token很少跨行，
+ * 推测的起点因而几乎总是正确的）。各块由不同线程推测分析，
+ * 再由lex_chunks_stitch从前往后校正并拼接。
+ * @param source 源代码（无需以'\0'结尾）
+ * @param length 源代码长度
+ * @param num_threads 线程数（每块不小于PARALLEL_CHUNK_MIN字节，块数不足2时直接调用lex_all）
+ * @param stream 输出：Token流（用free_token_stream释放）
+ */
+void lex_all_parallel(const char *source, size_t length, int num_threads, TokenStream *stream) {
+    const char *nul = (const char *)memchr(source, '\0', length);
+    if (nul) {
+        length = (size_t)(nul - source);
+    }
+    
+    size_t max_chunks = length / PARALLEL_CHUNK_MIN;
+    int num_chunks = num_threads > MAX_LEX_THREADS ? MAX_LEX_THREADS : num_threads;
+    if ((size_t)num_chunks > max_chunks) {
+        num_chunks = (int)max_chunks;
+    }
+    if (num_chunks < 2) {
+        lex_all(source, length, stream);
+        return;
+    }
+    
+    LexChunk *chunks = (LexChunk *)malloc(num_chunks * sizeof(LexChunk));
+    ChunkWorker *workers = (ChunkWorker *)malloc(num_chunks * sizeof(ChunkWorker));
+    pthread_t *threads = (pthread_t *)malloc(num_chunks * sizeof(pthread_t));
+    if (!chunks || !workers || !threads) {
+        fprintf(stderr, "内存分配失败: lex_all_parallel\n");
+        exit(1);
+    }
+    
+    // 确定块起点：均分后后移到行首，后移越过下一块的起点时舍弃该块
+    int count = 0;
+    for (int c = 0; c < num_chunks; c++) {
+        size_t start = 0;
+        if (c > 0) {
+            start = simd_find_newline(source, (size_t)((double)length * c / num_chunks), length);
+            if (start < length) {
+                start++;
+            }
+            if (start <= chunks[count - 1].start || start >= length) {
+                continue;
+            }
+        }
+        chunks[count++].start = start;
+    }
+    
+    // 第0块由调用线程分析
+    for (int c = 0; c < count; c++) {
+        workers[c].source = source;
+        workers[c].length = length;
+        workers[c].stop = (c + 1 < count) ? chunks[c + 1].start : length;
+        workers[c].chunk = &chunks[c];
+        if (c > 0 && pthread_create(&threads[c], NULL, chunk_worker, &workers[c]) != 0) {
+            fprintf(stderr, "错误: 无法创建工作线程\n");
+            exit(1);
+        }
+    }
+    chunk_worker(&workers[0]);
+    for (int c = 1; c < count; c++) {
+        pthread_join(threads[c], NULL);
+    }
+    
+    lex_chunks_stitch(chunks, count, source, length, stream);
+    
+    free(threads);
+    free(workers);
+    free(chunks);
+}
+
+/**
+ * 默认线程数：在线的处理器数量
+ * @return 线程数
+ */
+int parallel_lex_default_threads() {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) {
+        return 1;
+    }
+    return n > MAX_LEX_THREADS ? MAX_LEX_THREADS : (int)n;
+}
+
+/**
+ * 并行分析多个文件
+ * 调用线程按文件顺序等待各文件完成并写出其输出，因此输出顺序与线程数无关
+ * @param filenames 文件名数组
+ * @param num_files 文件数量
+ * @param num_threads 工作线程数（会被限制在1到文件数量之间）
+ * @param out 输出流
+ * @param summary 输出：汇总结果
+ */
+void parallel_lex_files(const char *const *filenames, int num_files, int num_threads,
+                        FILE *out, ParallelLexSummary *summary) {
+    memset(summary, 0, sizeof(ParallelLexSummary));
+    summary->num_files = num_files;
+    if (num_files <= 0) {
+        return;
+    }
+    if (num_threads > num_files) {
+        num_threads = num_files;
+    }
+    if (num_threads > MAX_LEX_THREADS) {
+        num_threads = MAX_LEX_THREADS;
+    }
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+    
+    LexPool pool;
+    pool.num_threads = num_threads;
+    pool.jobs = (LexJob *)calloc(num_files, sizeof(LexJob));
+    pool.ranges = (JobRange *)malloc(num_threads * sizeof(JobRange));
+    pthread_t *threads = (pthread_t *)malloc(num_threads * sizeof(pthread_t));
+    LexWorker *workers = (LexWorker *)malloc(num_threads * sizeof(LexWorker));
+    if (!pool.jobs || !pool.ranges || !threads || !workers) {
+        fprintf(stderr, "内存分配失败: parallel_lex_files\n");
+        exit(1);
+    }
+    pthread_mutex_init(&pool.done_lock, NULL);
+    pthread_cond_init(&pool.done_cond, NULL);
+    
+    // 文件按下标均分为连续区间
+    for (int i = 0; i < num_files; i++) {
+        pool.jobs[i].filename = filenames[i];
+    }
+    for (int t = 0; t < num_threads; t++) {
+        pthread_mutex_init(&pool.ranges[t].lock, NULL);
+        pool.ranges[t].lo = (int)((long)num_files * t / num_threads);
+        pool.ranges[t].hi = (int)((long)num_files * (t + 1) / num_threads);
+    }
+    
+    for (int t = 0; t < num_threads; t++) {
+        workers[t].pool = &pool;
+        workers[t].id = t;
+        if (pthread_create(&threads[t], NULL, lex_worker, &workers[t]) != 0) {
+            fprintf(stderr, "错误: 无法创建工作线程\n");
+            exit(1);
+        }
+    }
+    
+    // 按文件顺序写出输出，写完即释放
+    for (int i = 0; i < num_files; i++) {
+        LexJob *job = &pool.jobs[i];
+        pthread_mutex_lock(&pool.done_lock);
+        while (!job->done) {
+            pthread_cond_wait(&pool.done_cond, &pool.done_lock);
+        }
+        pthread_mutex_unlock(&pool.done_lock);
+        
+        if (job->failed) {
+            summary->failed_files++;
+            continue;
+        }
+        fwrite(job->output, 1, job->output_size, out);
+        free(job->output);
+        summary->token_count += job->token_count;
+        summary->error_count += job->error_count;
+    }
+    
+    for (int t = 0; t < num_threads; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    for (int t = 0; t < num_threads; t++) {
+        pthread_mutex_destroy(&pool.ranges[t].lock);
+    }
+    pthread_cond_destroy(&pool.done_cond);
+    pthread_mutex_destroy(&pool.done_lock);
+    free(workers);
+    free(threads);
+    free(pool.ranges);
+    free(pool.jobs);
+}
@@ -0,0 +1,36 @@
+/**
+ * parallel_lex.h - 多文件并行词法分析头文件
+ *
+ * 多个源文件由固定数量的工作线程并行分析。文件按下标分成连续区间分给各线程，
+ * 线程从自己区间的头部取文件，区间取空后从其他线程区间的尾部窃取。
+ * 每个文件有自己的Token流（含区域分配器）和输出缓冲区，
+ * 调用线程按文件顺序依次写出已完成的输出。
+ *
+ * 单个大文件则按字节数分块，各块从块起点推测分析，再从前往后校正拼接。
+ */
+
+#ifndef PARALLEL_LEX_H
+#define PARALLEL_LEX_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "lexer.h"
+
+#define MAX_LEX_THREADS 256     // 工作线程数上限
+#define PARALLEL_CHUNK_MIN (256 * 1024) // 单文件分块分析时每块的最小字节数
+
+/* 并行词法分析的汇总结果 */
+typedef struct {
+    int num_files;          // 文件数量
+    int failed_files;       // 无法读取的文件数量
+    long token_count;       // Token总数（不含EOF）
+    long error_count;       // 词法错误总数
+} ParallelLexSummary;
+
+/* 并行词法分析函数 */
+int parallel_lex_default_threads();
+void parallel_lex_files(const char *const *filenames, int num_files, int num_threads,
+                        FILE *out, ParallelLexSummary *summary);
+void lex_all_parallel(const char *source, size_t length, int num_threads, TokenStream *stream);
+
+#endif /* PARALLEL_LEX_H */
@@ -0,0 +1,808 @@
+/**
+ * parser.c - 语法分析器实现
+ *
+ * 文法（{}表示重复，[]表示可选）：
+ *   program     = { struct_def | function | declaration }
+ *   struct_def  = "struct" IDENT "{" { declaration } "}" ";"
+ *   function    = type { "*" } IDENT "(" [ "void" | param { "," param } ] ")" ( block | ";" )
+ *   param       = type { "*" } IDENT [ "[" "]" ]
+ *   declaration = type declarator { "," { "*" } declarator } ";"
+ *   declarator  = IDENT [ "[" [ expr ] "]" ] [ "=" ( expr | init_list ) ]
+ *   type        = [ "const" ] ( "int" | "double" | "char" | "void" | "struct" IDENT )
+ *   statement   = block | if | while | for | return | break | continue | ";" | declaration | expr ";"
+ *   expr        = 按绑定强度由低到高：= （右结合）、||、&&、== !=、< <= > >=、+ -、* / %、
+ *                 前缀 - + ! *、后缀调用和下标
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include "parser.h"
+
+/* 运算符的绑定强度（0表示不是中缀运算符） */
+enum {
+    PREC_NONE,
+    PREC_ASSIGN,          // =
+    PREC_OR,              // ||
+    PREC_AND,             // &&
+    PREC_EQUALITY,        // == !=
+    PREC_RELATIONAL,      // < <= > >=
+    PREC_ADDITIVE,        // + -
+    PREC_MULTIPLICATIVE,  // * / %
+    PREC_UNARY,           // 前缀 - + ! *
+    PREC_POSTFIX          // 调用 ()、下标 []
+};
+
+/* 语法分析器状态 */
+typedef struct {
+    TokenStream *tokens;  // Token流
+    Ast *ast;             // 输出的语法树
+    int pos;              // 当前Token的下标（跳过了错误Token）
+    int eof;              // EOF Token的下标
+    int depth;            // 当前嵌套层数
+    bool panic;           // 是否处于错误恢复中（此时不报告新错误）
+    int32_t *scratch;     // 构造子节点列表的栈（嵌套的列表依次压在上面）
+    int scratch_count;    // 栈中的项数
+    int scratch_capacity; // 栈容量
+} Parser;
+
+static int parse_expression(Parser *p);
+static int parse_statement(Parser *p);
+static int parse_block(Parser *p);
+
+/**
+ * 取当前Token的类型
+ */
+static TokenType peek_type(const Parser *p) {
+    return (TokenType)p->tokens->types[p->pos];
+}
+
+/**
+ * 跳过从index起的错误Token
+ * @return 第一个不是错误Token的下标（至多为EOF）
+ */
+static int skip_errors(const Parser *p, int index) {
+    while (index < p->eof && p->tokens->types[index] == TOKEN_ERROR) {
+        index++;
+    }
+    return index;
+}
+
+/**
+ * 取当前Token之后第n个Token的类型（不计错误Token）
+ */
+static TokenType peek_ahead(const Parser *p, int n) {
+    int index = p->pos;
+    for (int i = 0; i < n && index < p->eof; i++) {
+        index = skip_errors(p, index + 1);
+    }
+    return (TokenType)p->tokens->types[index];
+}
+
+/**
+ * 前进到下一个Token
+ * @return 原来的当前Token的下标
+ */
+static int next_token(Parser *p) {
+    int token = p->pos;
+    if (p->pos < p->eof) {
+        p->pos = skip_errors(p, p->pos + 1);
+    }
+    return token;
+}
+
+/**
+ * 报告语法错误并进入错误恢复；错误恢复中不报告，错误过多时跳到EOF停止分析
+ * @param p 语法分析器
+ * @param token 出错处的Token下标
+ * @param format 错误信息格式
+ */
+static void parser_error(Parser *p, int token, const char *format, ...) {
+    if (p->panic) {
+        return;
+    }
+    p->panic = true;
+    
+    char message[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    ast_add_error(p->ast, token, message);
+    
+    if (p->ast->num_errors >= PARSER_MAX_ERRORS) {
+        ast_add_error(p->ast, token, "错误过多，停止语法分析");
+        p->pos = p->eof;
+    }
+}
+
+/**
+ * 报告当前Token不是期望的Token
+ * @param p 语法分析器
+ * @param expected 期望的内容（用于错误信息）
+ */
+static void error_unexpected(Parser *p, const char *expected) {
+    if (p->pos == p->eof) {
+        parser_error(p, p->pos, "期望%s，遇到文件结尾", expected);
+        return;
+    }
+    int length = (int)p->tokens->lengths[p->pos];
+    parser_error(p, p->pos, "期望%s，遇到'%.*s'%s", expected, length > 32 ? 32 : length,
+                 p->tokens->source + p->tokens->offsets[p->pos], length > 32 ? "..." : "");
+}
+
+/**
+ * 当前Token为指定类型时前进，否则报告错误
+ * @param p 语法分析器
+ * @param type 期望的Token类型
+ * @param expected 期望的内容（用于错误信息）
+ * @return 该Token的下标，不匹配时返回-1
+ */
+static int expect(Parser *p, TokenType type, const char *expected) {
+    if (peek_type(p) == type) {
+        return next_token(p);
+    }
+    error_unexpected(p, expected);
+    return -1;
+}
+
+/**
+ * 压入一个子节点
+ */
+static void push_node(Parser *p, int node) {
+    if (p->scratch_count == p->scratch_capacity) {
+        p->scratch_capacity = p->scratch_capacity ? p->scratch_capacity * 2 : 64;
+        p->scratch = (int32_t *)realloc(p->scratch, p->scratch_capacity * sizeof(int32_t));
+        if (!p->scratch) {
+            fprintf(stderr, "内存分配失败: push_node\n");
+            exit(1);
+        }
+    }
+    p->scratch[p->scratch_count++] = node;
+}
+
+/**
+ * 把栈中base以上的子节点弹出，存为列表
+ * @param p 语法分析器
+ * @param base 列表开始时的栈深度
+ * @return 列表下标
+ */
+static int pop_list(Parser *p, int base) {
+    int list = ast_add_list(p->ast, p->scratch + base, p->scratch_count - base);
+    p->scratch_count = base;
+    return list;
+}
+
+/**
+ * 进入一层嵌套，超过最大层数时报告错误
+ * @return 是否可以继续分析
+ */
+static bool enter_nested(Parser *p) {
+    if (p->depth >= PARSER_MAX_DEPTH) {
+        parser_error(p, p->pos, "嵌套层数超过%d", PARSER_MAX_DEPTH);
+        return false;
+    }
+    p->depth++;
+    return true;
+}
+
+static bool is_type_start(TokenType type) {
+    return type == TOKEN_CONST || type == TOKEN_INT || type == TOKEN_DOUBLE ||
+           type == TOKEN_CHAR || type == TOKEN_VOID || type == TOKEN_STRUCT;
+}
+
+static bool is_statement_start(TokenType type) {
+    return is_type_start(type) || type == TOKEN_LBRACE || type == TOKEN_IF ||
+           type == TOKEN_WHILE || type == TOKEN_FOR || type == TOKEN_RETURN ||
+           type == TOKEN_BREAK || type == TOKEN_CONTINUE;
+}
+
+/**
+ * 错误恢复：跳过Token直到分号之后、右花括号或下一条语句（声明）的开始
+ * @param p 语法分析器
+ * @param in_block 是否在语句块中（是则右花括号留给语句块，否则一并跳过）
+ */
+static void synchronize(Parser *p, bool in_block) {
+    p->panic = false;
+    while (p->pos < p->eof) {
+        TokenType type = peek_type(p);
+        if (type == TOKEN_SEMICOLON) {
+            next_token(p);
+            return;
+        }
+        if (type == TOKEN_RBRACE) {
+            if (!in_block) {
+                next_token(p);
+            }
+            return;
+        }
+        if (in_block ? is_statement_start(type) : is_type_start(type)) {
+            return;
+        }
+        next_token(p);
+    }
+}
+
+/* ========== 表达式 ========== */
+
+/**
+ * 取中缀运算符的绑定强度
+ */
+static int infix_precedence(TokenType type) {
+    switch (type) {
+        case TOKEN_ASSIGN:   return PREC_ASSIGN;
+        case TOKEN_OR:       return PREC_OR;
+        case TOKEN_AND:      return PREC_AND;
+        case TOKEN_EQ:
+        case TOKEN_NE:       return PREC_EQUALITY;
+        case TOKEN_LT:
+        case TOKEN_LE:
+        case TOKEN_GT:
+        case TOKEN_GE:       return PREC_RELATIONAL;
+        case TOKEN_PLUS:
+        case TOKEN_MINUS:    return PREC_ADDITIVE;
+        case TOKEN_MULTIPLY:
+        case TOKEN_DIVIDE:
+        case TOKEN_MODULO:   return PREC_MULTIPLICATIVE;
+        default:             return PREC_NONE;
+    }
+}
+
+/**
+ * 判断节点能否作为赋值的左值（变量、下标或解引用）
+ */
+static bool is_lvalue(const Parser *p, int node) {
+    const Ast *ast = p->ast;
+    switch ((AstKind)ast->kinds[node]) {
+        case AST_IDENTIFIER:
+        case AST_INDEX:
+            return true;
+        case AST_UNARY:
+            return p->tokens->types[ast->main_tokens[node]] == TOKEN_MULTIPLY;
+        default:
+            return false;
+    }
+}
+
+static int parse_binary(Parser *p, int min_precedence);
+
+/**
+ * 分析前缀部分：常量、标识符、括号表达式或前缀运算
+ * @return 节点下标（缺少表达式时为ERROR节点，不消耗Token）
+ */
+static int parse_prefix(Parser *p) {
+    int token = p->pos;
+    switch (peek_type(p)) {
+        case TOKEN_IDENTIFIER:
+            next_token(p);
+            return ast_add_node(p->ast, AST_IDENTIFIER, token, AST_NONE, AST_NONE);
+        case TOKEN_INT_CONST:
+            next_token(p);
+            return ast_add_node(p->ast, AST_INT_LITERAL, token, AST_NONE, AST_NONE);
+        case TOKEN_DOUBLE_CONST:
+            next_token(p);
+            return ast_add_node(p->ast, AST_DOUBLE_LITERAL, token, AST_NONE, AST_NONE);
+        case TOKEN_CHAR_CONST:
+            next_token(p);
+            return ast_add_node(p->ast, AST_CHAR_LITERAL, token, AST_NONE, AST_NONE);
+        case TOKEN_STRING_CONST:
+            next_token(p);
+            return ast_add_node(p->ast, AST_STRING_LITERAL, token, AST_NONE, AST_NONE);
+        case TOKEN_LPAREN: {
+            next_token(p);
+            int inner = parse_expression(p);
+            expect(p, TOKEN_RPAREN, "')'");
+            return inner;
+        }
+        case TOKEN_MINUS:
+        case TOKEN_PLUS:
+        case TOKEN_NOT:
+        case TOKEN_MULTIPLY: {
+            next_token(p);
+            int operand = parse_binary(p, PREC_UNARY);
+            return ast_add_node(p->ast, AST_UNARY, token, operand, AST_NONE);
+        }
+        default:
+            error_unexpected(p, "表达式");
+            return ast_add_node(p->ast, AST_ERROR, token, AST_NONE, AST_NONE);
+    }
+}
+
+/**
+ * 分析后缀运算：函数调用的实参表或下标
+ * @param p 语法分析器（当前Token为'('或'['）
+ * @param left 被调用或被取下标的表达式
+ * @return 节点下标
+ */
+static int parse_postfix(Parser *p, int left) {
+    int token = next_token(p);
+    if (p->tokens->types[token] == TOKEN_LBRACKET) {
+        int index = parse_expression(p);
+        expect(p, TOKEN_RBRACKET, "']'");
+        return ast_add_node(p->ast, AST_INDEX, token, left, index);
+    }
+    
+    int base = p->scratch_count;
+    if (peek_type(p) != TOKEN_RPAREN) {
+        push_node(p, parse_expression(p));
+        while (peek_type(p) == TOKEN_COMMA) {
+            next_token(p);
+            push_node(p, parse_expression(p));
+        }
+    }
+    expect(p, TOKEN_RPAREN, "')'");
+    return ast_add_node(p->ast, AST_CALL, token, left, pop_list(p, base));
+}
+
+/**
+ * Pratt分析：分析绑定强度不低于min_precedence的运算构成的表达式
+ * 赋值右结合，其余二元运算左结合；后缀运算绑定最紧
+ * @param p 语法分析器
+ * @param min_precedence 最低绑定强度
+ * @return 节点下标
+ */
+static int parse_binary(Parser *p, int min_precedence) {
+    if (!enter_nested(p)) {
+        return ast_add_node(p->ast, AST_ERROR, p->pos, AST_NONE, AST_NONE);
+    }
+    
+    int left = parse_prefix(p);
+    while (1) {
+        TokenType type = peek_type(p);
+        if (type == TOKEN_LPAREN || type == TOKEN_LBRACKET) {
+            left = parse_postfix(p, left);
+            continue;
+        }
+        
+        int precedence = infix_precedence(type);
+        if (precedence == PREC_NONE || precedence < min_precedence) {
+            break;
+        }
+        int op = next_token(p);
+        if (type == TOKEN_ASSIGN) {
+            if (!is_lvalue(p, left) && !p->panic) {
+                ast_add_error(p->ast, op, "赋值号左边不是左值");
+            }
+            int right = parse_binary(p, PREC_ASSIGN);
+            left = ast_add_node(p->ast, AST_ASSIGN, op, left, right);
+        } else {
+            int right = parse_binary(p, precedence + 1);
+            left = ast_add_node(p->ast, AST_BINARY, op, left, right);
+        }
+    }
+    
+    p->depth--;
+    return left;
+}
+
+/**
+ * 分析完整的表达式
+ * @return 节点下标
+ */
+static int parse_expression(Parser *p) {
+    return parse_binary(p, PREC_ASSIGN);
+}
+
+/* ========== 声明 ========== */
+
+/**
+ * 分析类型（不含指针的'*'）
+ * @return TYPE节点下标，不是类型时返回AST_NONE（已报告错误）
+ */
+static int parse_type(Parser *p) {
+    bool is_const = false;
+    if (peek_type(p) == TOKEN_CONST) {
+        next_token(p);
+        is_const = true;
+    }
+    
+    int token;
+    switch (peek_type(p)) {
+        case TOKEN_INT:
+        case TOKEN_DOUBLE:
+        case TOKEN_CHAR:
+        case TOKEN_VOID:
+            token = next_token(p);
+            break;
+        case TOKEN_STRUCT:
+            next_token(p);
+            token = expect(p, TOKEN_IDENTIFIER, "结构名");
+            if (token < 0) {
+                return AST_NONE;
+            }
+            break;
+        default:
+            error_unexpected(p, "类型名");
+            return AST_NONE;
+    }
+    return ast_add_node(p->ast, AST_TYPE, token, 0, is_const);
+}
+
+/**
+ * 分析声明符前的'*'：有'*'时复制基本类型并记录指针层数
+ * @param p 语法分析器
+ * @param base 基本类型（TYPE节点）
+ * @return 声明符的类型节点
+ */
+static int parse_pointers(Parser *p, int base) {
+    int depth = 0;
+    while (peek_type(p) == TOKEN_MULTIPLY) {
+        next_token(p);
+        depth++;
+    }
+    if (depth == 0) {
+        return base;
+    }
+    return ast_add_node(p->ast, AST_TYPE, p->ast->main_tokens[base], depth, p->ast->rhs[base]);
+}
+
+/**
+ * 分析初值列表：{ 元素 { , 元素 } [ , ] }，元素为表达式或嵌套的初值列表
+ * @return INIT_LIST节点下标
+ */
+static int parse_init_list(Parser *p) {
+    int token = next_token(p);
+    if (!enter_nested(p)) {
+        return ast_add_node(p->ast, AST_ERROR, token, AST_NONE, AST_NONE);
+    }
+    
+    int base = p->scratch_count;
+    while (peek_type(p) != TOKEN_RBRACE && p->pos < p->eof) {
+        push_node(p, peek_type(p) == TOKEN_LBRACE ? parse_init_list(p) : parse_expression(p));
+        if (peek_type(p) != TOKEN_COMMA) {
+            break;
+        }
+        next_token(p);
+    }
+    expect(p, TOKEN_RBRACE, "'}'");
+    
+    p->depth--;
+    return ast_add_node(p->ast, AST_INIT_LIST, token, pop_list(p, base), AST_NONE);
+}
+
+/**
+ * 分析声明符名字之后的部分：数组长度和初值
+ * @param p 语法分析器
+ * @param type 变量类型
+ * @param name 变量名Token的下标
+ * @return VAR_DECL节点下标
+ */
+static int parse_declarator_rest(Parser *p, int type, int name) {
+    int32_t parts[2] = {AST_NONE, AST_NONE};
+    if (peek_type(p) == TOKEN_LBRACKET) {
+        next_token(p);
+        if (peek_type(p) != TOKEN_RBRACKET) {
+            parts[0] = parse_expression(p);
+        }
+        expect(p, TOKEN_RBRACKET, "']'");
+    }
+    if (peek_type(p) == TOKEN_ASSIGN) {
+        next_token(p);
+        parts[1] = peek_type(p) == TOKEN_LBRACE ? parse_init_list(p) : parse_expression(p);
+    }
+    return ast_add_node(p->ast, AST_VAR_DECL, name, type, ast_add_extra(p->ast, parts, 2));
+}
+
+/**
+ * 分析第一个声明符的名字之后的部分：其余声明符和末尾的分号
+ * @param p 语法分析器
+ * @param first 声明语句的第一个Token的下标
+ * @param base 基本类型
+ * @param type 第一个声明符的类型
+ * @param name 第一个声明符的名字Token的下标
+ * @return 只有一个声明符时为VAR_DECL节点，否则为DECL_LIST节点
+ */
+static int parse_declaration_rest(Parser *p, int first, int base, int type, int name) {
+    int stack_base = p->scratch_count;
+    push_node(p, parse_declarator_rest(p, type, name));
+    while (peek_type(p) == TOKEN_COMMA) {
+        next_token(p);
+        type = parse_pointers(p, base);
+        name = expect(p, TOKEN_IDENTIFIER, "变量名");
+        if (name < 0) {
+            break;
+        }
+        push_node(p, parse_declarator_rest(p, type, name));
+    }
+    expect(p, TOKEN_SEMICOLON, "';'");
+    
+    if (p->scratch_count - stack_base == 1) {
+        return p->scratch[--p->scratch_count];
+    }
+    return ast_add_node(p->ast, AST_DECL_LIST, first, pop_list(p, stack_base), AST_NONE);
+}
+
+/**
+ * 分析变量声明语句
+ * @return 节点下标（VAR_DECL或DECL_LIST；类型有误时为ERROR节点）
+ */
+static int parse_declaration(Parser *p) {
+    int first = p->pos;
+    int base = parse_type(p);
+    if (base == AST_NONE) {
+        return ast_add_node(p->ast, AST_ERROR, first, AST_NONE, AST_NONE);
+    }
+    int type = parse_pointers(p, base);
+    int name = expect(p, TOKEN_IDENTIFIER, "变量名");
+    if (name < 0) {
+        return ast_add_node(p->ast, AST_ERROR, first, AST_NONE, AST_NONE);
+    }
+    return parse_declaration_rest(p, first, base, type, name);
+}
+
+/**
+ * 分析结构定义：struct 名字 { 成员声明 } ;
+ * @return STRUCT节点下标
+ */
+static int parse_struct(Parser *p) {
+    next_token(p);
+    int name = next_token(p);
+    next_token(p);
+    
+    int base = p->scratch_count;
+    while (peek_type(p) != TOKEN_RBRACE && p->pos < p->eof) {
+        int start = p->pos;
+        push_node(p, parse_declaration(p));
+        if (p->panic) {
+            synchronize(p, true);
+            if (p->pos == start && peek_type(p) != TOKEN_RBRACE) {
+                next_token(p);
+            }
+        }
+    }
+    expect(p, TOKEN_RBRACE, "'}'");
+    expect(p, TOKEN_SEMICOLON, "';'");
+    return ast_add_node(p->ast, AST_STRUCT, name, pop_list(p, base), AST_NONE);
+}
+
+/**
+ * 分析函数名之后的部分：参数表和函数体（或原型末尾的分号）
+ * @param p 语法分析器（当前Token为'('）
+ * @param type 返回类型
+ * @param name 函数名Token的下标
+ * @return FUNCTION节点下标
+ */
+static int parse_function(Parser *p, int type, int name) {
+    next_token(p);
+    int base = p->scratch_count;
+    if (peek_type(p) == TOKEN_VOID && peek_ahead(p, 1) == TOKEN_RPAREN) {
+        next_token(p);
+    } else if (peek_type(p) != TOKEN_RPAREN) {
+        while (1) {
+            int param_type = parse_type(p);
+            if (param_type == AST_NONE) {
+                break;
+            }
+            param_type = parse_pointers(p, param_type);
+            int param_name = expect(p, TOKEN_IDENTIFIER, "参数名");
+            if (param_name < 0) {
+                break;
+            }
+            int is_array = 0;
+            if (peek_type(p) == TOKEN_LBRACKET) {
+                next_token(p);
+                expect(p, TOKEN_RBRACKET, "']'");
+                is_array = 1;
+            }
+            push_node(p, ast_add_node(p->ast, AST_PARAM, param_name, param_type, is_array));
+            if (peek_type(p) != TOKEN_COMMA) {
+                break;
+            }
+            next_token(p);
+        }
+    }
+    expect(p, TOKEN_RPAREN, "')'");
+    
+    int32_t body = AST_NONE;
+    if (peek_type(p) == TOKEN_LBRACE) {
+        body = parse_block(p);
+    } else {
+        expect(p, TOKEN_SEMICOLON, "'{'或';'");
+    }
+    
+    int32_t fields[2] = {body, pop_list(p, base)};
+    int extra = ast_add_extra(p->ast, fields, 2);
+    return ast_add_node(p->ast, AST_FUNCTION, name, type, extra);
+}
+
+/**
+ * 分析一个顶层声明：结构定义、函数或全局变量声明
+ * @return 节点下标，不是声明时返回AST_NONE（已报告错误）
+ */
+static int parse_external(Parser *p) {
+    if (peek_type(p) == TOKEN_STRUCT && peek_ahead(p, 1) == TOKEN_IDENTIFIER &&
+        peek_ahead(p, 2) == TOKEN_LBRACE) {
+        return parse_struct(p);
+    }
+    
+    int first = p->pos;
+    int base = parse_type(p);
+    if (base == AST_NONE) {
+        return AST_NONE;
+    }
+    int type = parse_pointers(p, base);
+    int name = expect(p, TOKEN_IDENTIFIER, "名字");
+    if (name < 0) {
+        return AST_NONE;
+    }
+    if (peek_type(p) == TOKEN_LPAREN) {
+        return parse_function(p, type, name);
+    }
+    return parse_declaration_rest(p, first, base, type, name);
+}
+
+/* ========== 语句 ========== */
+
+/**
+ * 分析语句块：{ 语句 }
+ * @return BLOCK节点下标
+ */
+static int parse_block(Parser *p) {
+    int token = expect(p, TOKEN_LBRACE, "'{'");
+    if (token < 0) {
+        return ast_add_node(p->ast, AST_ERROR, p->pos, AST_NONE, AST_NONE);
+    }
+    
+    int base = p->scratch_count;
+    while (peek_type(p) != TOKEN_RBRACE && p->pos < p->eof) {
+        int start = p->pos;
+        push_node(p, parse_statement(p));
+        if (p->panic) {
+            synchronize(p, true);
+            if (p->pos == start && peek_type(p) != TOKEN_RBRACE) {
+                next_token(p);
+            }
+        }
+    }
+    expect(p, TOKEN_RBRACE, "'}'");
+    return ast_add_node(p->ast, AST_BLOCK, token, pop_list(p, base), AST_NONE);
+}
+
+/**
+ * 分析括号中的条件：( 表达式 )
+ * @return 条件表达式的节点下标
+ */
+static int parse_condition(Parser *p) {
+    expect(p, TOKEN_LPAREN, "'('");
+    int condition = parse_expression(p);
+    expect(p, TOKEN_RPAREN, "')'");
+    return condition;
+}
+
+/**
+ * 分析for语句：for ( [初始化] ; [条件] ; [步进] ) 语句
+ * 初始化可以是声明（连同分号）或表达式
+ * @return FOR节点下标
+ */
+static int parse_for(Parser *p) {
+    int token = next_token(p);
+    int32_t parts[4] = {AST_NONE, AST_NONE, AST_NONE, AST_NONE};
+    expect(p, TOKEN_LPAREN, "'('");
+    if (is_type_start(peek_type(p))) {
+        parts[0] = parse_declaration(p);
+    } else {
+        if (peek_type(p) != TOKEN_SEMICOLON) {
+            parts[0] = parse_expression(p);
+        }
+        expect(p, TOKEN_SEMICOLON, "';'");
+    }
+    if (peek_type(p) != TOKEN_SEMICOLON) {
+        parts[1] = parse_expression(p);
+    }
+    expect(p, TOKEN_SEMICOLON, "';'");
+    if (peek_type(p) != TOKEN_RPAREN) {
+        parts[2] = parse_expression(p);
+    }
+    expect(p, TOKEN_RPAREN, "')'");
+    parts[3] = parse_statement(p);
+    return ast_add_node(p->ast, AST_FOR, token, AST_NONE, ast_add_extra(p->ast, parts, 4));
+}
+
+/**
+ * 分析一条语句
+ * @return 节点下标
+ */
+static int parse_statement(Parser *p) {
+    if (!enter_nested(p)) {
+        return ast_add_node(p->ast, AST_ERROR, p->pos, AST_NONE, AST_NONE);
+    }
+    
+    int token = p->pos;
+    int node;
+    switch (peek_type(p)) {
+        case TOKEN_LBRACE:
+            node = parse_block(p);
+            break;
+        case TOKEN_IF: {
+            next_token(p);
+            int condition = parse_condition(p);
+            int32_t branches[2] = {AST_NONE, AST_NONE};
+            branches[0] = parse_statement(p);
+            if (peek_type(p) == TOKEN_ELSE) {
+                next_token(p);
+                branches[1] = parse_statement(p);
+            }
+            node = ast_add_node(p->ast, AST_IF, token, condition, ast_add_extra(p->ast, branches, 2));
+            break;
+        }
+        case TOKEN_WHILE: {
+            next_token(p);
+            int condition = parse_condition(p);
+            node = ast_add_node(p->ast, AST_WHILE, token, condition, parse_statement(p));
+            break;
+        }
+        case TOKEN_FOR:
+            node = parse_for(p);
+            break;
+        case TOKEN_RETURN: {
+            next_token(p);
+            int value = peek_type(p) != TOKEN_SEMICOLON ? parse_expression(p) : AST_NONE;
+            expect(p, TOKEN_SEMICOLON, "';'");
+            node = ast_add_node(p->ast, AST_RETURN, token, value, AST_NONE);
+            break;
+        }
+        case TOKEN_BREAK:
+        case TOKEN_CONTINUE:
+            next_token(p);
+            expect(p, TOKEN_SEMICOLON, "';'");
+            node = ast_add_node(p->ast, p->tokens->types[token] == TOKEN_BREAK ? AST_BREAK : AST_CONTINUE,
+                                token, AST_NONE, AST_NONE);
+            break;
+        case TOKEN_SEMICOLON:
+            next_token(p);
+            node = ast_add_node(p->ast, AST_EMPTY, token, AST_NONE, AST_NONE);
+            break;
+        default:
+            if (is_type_start(peek_type(p))) {
+                node = parse_declaration(p);
+                break;
+            }
+            node = parse_expression(p);
+            expect(p, TOKEN_SEMICOLON, "';'");
+            node = ast_add_node(p->ast, AST_EXPR_STMT, token, node, AST_NONE);
+            break;
+    }
+    
+    p->depth--;
+    return node;
+}
+
+/**
+ * 分析整个程序，得到语法树
+ * @param tokens Token流（lex_all的结果，必须比语法树存活更久）
+ * @param ast 输出：语法树（用ast_free释放），根节点为PROGRAM
+ * @return 是否没有语法错误
+ */
+bool parse_program(TokenStream *tokens, Ast *ast) {
+    ast_init(ast, tokens, tokens->count);
+    
+    Parser p;
+    memset(&p, 0, sizeof(Parser));
+    p.tokens = tokens;
+    p.ast = ast;
+    p.eof = tokens->count - 1;
+    p.pos = skip_errors(&p, 0);
+    
+    while (p.pos < p.eof) {
+        int start = p.pos;
+        if (!is_type_start(peek_type(&p))) {
+            error_unexpected(&p, "声明");
+        } else {
+            int node = parse_external(&p);
+            if (node != AST_NONE) {
+                push_node(&p, node);
+            }
+        }
+        if (p.panic) {
+            synchronize(&p, false);
+            if (p.pos == start) {
+                next_token(&p);
+            }
+        }
+    }
+    ast->root = ast_add_node(ast, AST_PROGRAM, 0, pop_list(&p, 0), AST_NONE);
+    
+    free(p.scratch);
+    return ast->num_errors == 0;
+}
@@ -0,0 +1,23 @@
+/**
+ * parser.h - 语法分析器头文件
+ *
+ * 递归下降分析C0程序，表达式用Pratt算法（按运算符的绑定强度）分析。
+ * 输入为lex_all得到的整个Token流，输出按列存放的抽象语法树（见ast.h）。
+ * 词法错误Token被跳过（已由词法分析报告）；遇到语法错误时记录错误，
+ * 跳过Token直到语句或声明的边界后继续分析，一次报告多处错误。
+ */
+
+#ifndef PARSER_H
+#define PARSER_H
+
+#include <stdbool.h>
+#include "ast.h"
+#include "lexer.h"
+
+#define PARSER_MAX_DEPTH 512    // 表达式和语句的最大嵌套层数（限制递归深度）
+#define PARSER_MAX_ERRORS 100   // 报告的语法错误达到此数时停止分析
+
+/* 语法分析函数 */
+bool parse_program(TokenStream *tokens, Ast *ast);
+
+#endif /* PARSER_H */
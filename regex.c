@@ -0,0 +1,285 @@
+/**
+ * regex.c - 正规式解析与Thompson构造实现
+ *
+ * 递归下降解析正规式，边解析边生成NFA片段：
+ *   选择   alt    := concat ('|' concat)*
+ *   连接   concat := repeat*
+ *   重复   repeat := atom ('*' | '+' | '?')*
+ *   原子   atom   := '(' alt ')' | '[' class ']' | '.' | '\' escape | char
+ * 语法错误时输出错误位置并返回失败。
+ */
+
+#include <ctype.h>
+#include "regex.h"
+
+/* 正规式解析器状态 */
+typedef struct {
+    const char *pattern;    // 完整正规式（用于报错）
+    const char *p;          // 当前解析位置
+    NFA *nfa;               // 输出的NFA
+    bool failed;            // 是否出现语法错误
+} RegexParser;
+
+static NFAFragment parse_alt(RegexParser *parser);
+
+/**
+ * 报告语法错误
+ * @param parser 解析器
+ * @param message 错误信息
+ */
+static void regex_error(RegexParser *parser, const char *message) {
+    if (!parser->failed) {
+        fprintf(stderr, "正规式错误: %s (位置 %d): %s\n", message,
+                (int)(parser->p - parser->pattern), parser->pattern);
+        parser->failed = true;
+    }
+}
+
+/**
+ * 创建在字节集合上转换的片段
+ * @param parser 解析器
+ * @param set 字节集合（字节0被忽略）
+ * @return NFA片段
+ */
+static NFAFragment set_fragment(RegexParser *parser, const bool set[256]) {
+    NFAFragment f;
+    f.start = nfa_add_state(parser->nfa);
+    f.accept = nfa_add_state(parser->nfa);
+    for (int c = 1; c < MAX_ALPHABET; c++) {
+        if (set[c]) {
+            nfa_add_transition(parser->nfa, f.start, f.accept, c);
+        }
+    }
+    return f;
+}
+
+/**
+ * 解析转义序列（'\'之后），返回对应字节
+ * @param parser 解析器
+ * @return 字节值
+ */
+static int parse_escape(RegexParser *parser) {
+    char c = *parser->p;
+    if (c == '\0') {
+        regex_error(parser, "转义符后缺少字符");
+        return 0;
+    }
+    parser->p++;
+    switch (c) {
+        case 'n': return '\n';
+        case 't': return '\t';
+        case 'r': return '\r';
+        case 'v': return '\v';
+        case 'f': return '\f';
+        case 'x': {
+            int value = 0;
+            for (int i = 0; i < 2; i++) {
+                char h = *parser->p;
+                if (!isxdigit((unsigned char)h)) {
+                    regex_error(parser, "\\x后需要两位16进制数字");
+                    return 0;
+                }
+                value = value * 16 + (isdigit((unsigned char)h) ? h - '0' : tolower((unsigned char)h) - 'a' + 10);
+                parser->p++;
+            }
+            return value;
+        }
+        default: return (unsigned char)c;
+    }
+}
+
+/**
+ * 解析字符类 [...] 或 [^...]（'['之后）
+ * @param parser 解析器
+ * @return NFA片段
+ */
+static NFAFragment parse_class(RegexParser *parser) {
+    bool set[256] = {false};
+    bool negate = false;
+    
+    if (*parser->p == '^') {
+        negate = true;
+        parser->p++;
+    }
+    
+    while (*parser->p != ']') {
+        if (*parser->p == '\0') {
+            regex_error(parser, "字符类缺少 ']'");
+            return set_fragment(parser, set);
+        }
+        
+        int lo = (unsigned char)*parser->p++;
+        if (lo == '\\') {
+            lo = parse_escape(parser);
+        }
+        int hi = lo;
+        if (parser->p[0] == '-' && parser->p[1] != ']' && parser->p[1] != '\0') {
+            parser->p++;
+            hi = (unsigned char)*parser->p++;
+            if (hi == '\\') {
+                hi = parse_escape(parser);
+            }
+            if (hi < lo) {
+                regex_error(parser, "字符类区间上界小于下界");
+            }
+        }
+        for (int c = lo; c <= hi; c++) {
+            set[c] = true;
+        }
+    }
+    parser->p++; // 跳过 ']'
+    
+    if (negate) {
+        for (int c = 0; c < 256; c++) {
+            set[c] = !set[c];
+        }
+    }
+    return set_fragment(parser, set);
+}
+
+/**
+ * 解析原子
+ * @param parser 解析器
+ * @return NFA片段
+ */
+static NFAFragment parse_atom(RegexParser *parser) {
+    bool set[256] = {false};
+    char c = *parser->p++;
+    
+    switch (c) {
+        case '(': {
+            NFAFragment f = parse_alt(parser);
+            if (*parser->p != ')') {
+                regex_error(parser, "缺少 ')'");
+            } else {
+                parser->p++;
+            }
+            return f;
+        }
+        case '[':
+            return parse_class(parser);
+        case '.':
+            for (int i = 0; i < 256; i++) {
+                set[i] = (i != '\n');
+            }
+            return set_fragment(parser, set);
+        case '\\':
+            set[parse_escape(parser)] = true;
+            return set_fragment(parser, set);
+        case '*':
+        case '+':
+        case '?':
+            regex_error(parser, "重复运算符前缺少操作数");
+            return set_fragment(parser, set);
+        default:
+            set[(unsigned char)c] = true;
+            return set_fragment(parser, set);
+    }
+}
+
+/**
+ * 解析重复：atom之后的 * + ?
+ * @param parser 解析器
+ * @return NFA片段
+ */
+static NFAFragment parse_repeat(RegexParser *parser) {
+    NFAFragment f = parse_atom(parser);
+    NFA *nfa = parser->nfa;
+    
+    while (*parser->p == '*' || *parser->p == '+' || *parser->p == '?') {
+        char op = *parser->p++;
+        NFAFragment r;
+        r.start = nfa_add_state(nfa);
+        r.accept = nfa_add_state(nfa);
+        nfa_add_transition(nfa, r.start, f.start, EPSILON);
+        nfa_add_transition(nfa, f.accept, r.accept, EPSILON);
+        if (op != '+') {
+            nfa_add_transition(nfa, r.start, r.accept, EPSILON);   // 可以跳过
+        }
+        if (op != '?') {
+            nfa_add_transition(nfa, f.accept, f.start, EPSILON);   // 可以重复
+        }
+        f = r;
+    }
+    return f;
+}
+
+/**
+ * 解析连接
+ * @param parser 解析器
+ * @return NFA片段（空连接为只含一个状态的ε片段）
+ */
+static NFAFragment parse_concat(RegexParser *parser) {
+    NFAFragment f;
+    f.start = nfa_add_state(parser->nfa);
+    f.accept = f.start;
+    
+    while (*parser->p != '\0' && *parser->p != '|' && *parser->p != ')' && !parser->failed) {
+        NFAFragment next = parse_repeat(parser);
+        nfa_add_transition(parser->nfa, f.accept, next.start, EPSILON);
+        f.accept = next.accept;
+    }
+    return f;
+}
+
+/**
+ * 解析选择
+ * @param parser 解析器
+ * @return NFA片段
+ */
+static NFAFragment parse_alt(RegexParser *parser) {
+    NFAFragment f = parse_concat(parser);
+    
+    while (*parser->p == '|' && !parser->failed) {
+        parser->p++;
+        NFAFragment other = parse_concat(parser);
+        NFAFragment r;
+        r.start = nfa_add_state(parser->nfa);
+        r.accept = nfa_add_state(parser->nfa);
+        nfa_add_transition(parser->nfa, r.start, f.start, EPSILON);
+        nfa_add_transition(parser->nfa, r.start, other.start, EPSILON);
+        nfa_add_transition(parser->nfa, f.accept, r.accept, EPSILON);
+        nfa_add_transition(parser->nfa, other.accept, r.accept, EPSILON);
+        f = r;
+    }
+    return f;
+}
+
+/**
+ * 将正规式编译为NFA片段（Thompson构造法）
+ * @param nfa 输出的NFA，片段的状态和转换追加到其中
+ * @param pattern 正规式
+ * @param fragment 输出：片段的入口和出口状态
+ * @return 是否成功（语法错误时返回false）
+ */
+bool regex_to_fragment(NFA *nfa, const char *pattern, NFAFragment *fragment) {
+    RegexParser parser;
+    parser.pattern = pattern;
+    parser.p = pattern;
+    parser.nfa = nfa;
+    parser.failed = false;
+    
+    *fragment = parse_alt(&parser);
+    if (!parser.failed && *parser.p != '\0') {
+        regex_error(&parser, "多余的 ')'");
+    }
+    return !parser.failed;
+}
+
+/**
+ * 将正规式作为一条规则加入组合NFA
+ * 初始状态经ε转换到片段入口，片段出口成为识别该规则的终态
+ * @param nfa NFA指针
+ * @param pattern 正规式
+ * @param rule 规则编号（编号越小优先级越高）
+ * @return 是否成功
+ */
+bool nfa_add_regex(NFA *nfa, const char *pattern, int rule) {
+    NFAFragment fragment;
+    if (!regex_to_fragment(nfa, pattern, &fragment)) {
+        return false;
+    }
+    nfa_add_transition(nfa, nfa->start_state, fragment.start, EPSILON);
+    nfa_set_final(nfa, fragment.accept, rule);
+    return true;
+}
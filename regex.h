@@ -0,0 +1,29 @@
+/**
+ * regex.h - 正规式解析与Thompson构造头文件
+ *
+ * 将正规式解析为语法并用Thompson构造法生成NFA片段
+ *
+ * 支持的语法：
+ *   c        字面字符        \c       转义（\n \t \r \v \f \xHH，其余为字面字符）
+ *   [...]    字符类          [^...]   补集（不含字节0）
+ *   .        除换行外任意字节
+ *   (r)      分组            r|s      选择
+ *   r*  r+  r?               闭包、正闭包、可选
+ */
+
+#ifndef REGEX_H
+#define REGEX_H
+
+#include "nfa_dfa.h"
+
+/* NFA片段：Thompson构造的中间结果，只有一个入口和一个出口 */
+typedef struct {
+    int start;              // 入口状态
+    int accept;             // 出口状态
+} NFAFragment;
+
+/* 正规式函数 */
+bool regex_to_fragment(NFA *nfa, const char *pattern, NFAFragment *fragment);
+bool nfa_add_regex(NFA *nfa, const char *pattern, int rule);
+
+#endif /* REGEX_H */
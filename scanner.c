@@ -0,0 +1,583 @@
+/**
+ * scanner.c - 表驱动扫描器实现
+ *
+ * 实现以下功能：
+ * 1. 以正规式规则表描述C0全部Token类别（关键字、标识符、常量、注释、运算符）
+ * 2. 由规则表构造组合NFA（每个终态标注规则编号）
+ * 3. 经子集构造和最简化得到DFA后，压缩为扁平转换表
+ * 4. 按列等价性计算256项的字节等价类映射
+ * 5. 将扫描表输出为static const的C头文件（c0_tables.h），编译期即可得到转换表
+ * 6. 将最简DFA输出为直接编码的扫描函数（c0_direct.h），每个状态一个标号
+ *
+ * 修改词法规则只需编辑规则表，make会自动重新生成c0_tables.h。
+ */
+
+#include "scanner.h"
+#include "regex.h"
+
+/*
+ * C0规则表：规则编号即优先级，同一词素被多条规则接受时编号小者优先
+ * （关键字先于标识符，10进制整数先于浮点数）。
+ * 各规则与手写扫描函数的接受范围保持一致；空白和注释只丢弃。
+ */
+const ScanRule c0_rules[] = {
+    {"[ \\t\\n\\v\\f\\r]+", TOKEN_EOF, NULL, true},                 // 空白
+    {"//[^\\n]*\\n?", TOKEN_EOF, NULL, true},                      // 单行注释
+    {"/\\*([^*]|\\*+[^*/])*\\*+/", TOKEN_EOF, NULL, true},          // 多行注释
+    {"const", TOKEN_CONST, "const", false},
+    {"int", TOKEN_INT, "int", false},
+    {"double", TOKEN_DOUBLE, "double", false},
+    {"char", TOKEN_CHAR, "char", false},
+    {"void", TOKEN_VOID, "void", false},
+    {"if", TOKEN_IF, "if", false},
+    {"else", TOKEN_ELSE, "else", false},
+    {"while", TOKEN_WHILE, "while", false},
+    {"for", TOKEN_FOR, "for", false},
+    {"return", TOKEN_RETURN, "return", false},
+    {"break", TOKEN_BREAK, "break", false},
+    {"continue", TOKEN_CONTINUE, "continue", false},
+    {"struct", TOKEN_STRUCT, "struct", false},
+    {"[a-zA-Z_][a-zA-Z0-9_]*", TOKEN_IDENTIFIER, NULL, false},
+    {"[0-9]+", TOKEN_INT_CONST, NULL, false},                   // 10进制整数
+    {"0[xX][0-9a-fA-F]*", TOKEN_INT_CONST, NULL, false},        // 16进制整数
+    {"[0-9]+(\\.[0-9]+|(\\.[0-9]+)?[eE][+-]?[0-9]*)", TOKEN_DOUBLE_CONST, NULL, false},
+    {"'([^'\\\\]|\\\\(.|\\n))?'", TOKEN_CHAR_CONST, NULL, false},
+    {"\"([^\"\\\\]|\\\\(.|\\n))*\"", TOKEN_STRING_CONST, NULL, false},
+    {"==", TOKEN_EQ, "==", false},
+    {"!=", TOKEN_NE, "!=", false},
+    {"<=", TOKEN_LE, "<=", false},
+    {">=", TOKEN_GE, ">=", false},
+    {"&&", TOKEN_AND, "&&", false},
+    {"\\|\\|", TOKEN_OR, "||", false},
+    {"\\+", TOKEN_PLUS, "+", false},
+    {"-", TOKEN_MINUS, "-", false},
+    {"\\*", TOKEN_MULTIPLY, "*", false},
+    {"/", TOKEN_DIVIDE, "/", false},
+    {"%", TOKEN_MODULO, "%", false},
+    {"=", TOKEN_ASSIGN, "=", false},
+    {"<", TOKEN_LT, "<", false},
+    {">", TOKEN_GT, ">", false},
+    {"!", TOKEN_NOT, "!", false},
+    {";", TOKEN_SEMICOLON, ";", false},
+    {",", TOKEN_COMMA, ",", false},
+    {"\\(", TOKEN_LPAREN, "(", false},
+    {"\\)", TOKEN_RPAREN, ")", false},
+    {"\\{", TOKEN_LBRACE, "{", false},
+    {"\\}", TOKEN_RBRACE, "}", false},
+    {"\\[", TOKEN_LBRACKET, "[", false},
+    {"\\]", TOKEN_RBRACKET, "]", false},
+};
+
+#define NUM_C0_RULES ((int)(sizeof(c0_rules) / sizeof(c0_rules[0])))
+
+/**
+ * 由规则表构造组合NFA
+ * 每条规则的正规式经Thompson构造生成一个片段，初始状态经ε转换到
+ * 各片段入口，片段出口标注规则编号。
+ * @param rules 规则表
+ * @param num_rules 规则数量
+ * @return NFA指针
+ */
+NFA *create_nfa_for_rules(const ScanRule *rules, int num_rules) {
+    NFA *nfa = create_nfa();
+    for (int i = 0; i < num_rules; i++) {
+        if (!nfa_add_regex(nfa, rules[i].pattern, i)) {
+            fprintf(stderr, "无法编译第 %d 条扫描规则\n", i);
+            exit(1);
+        }
+    }
+    return nfa;
+}
+
+/**
+ * 创建覆盖C0全部Token类别的组合NFA
+ * @return NFA指针
+ */
+NFA *create_nfa_for_c0_tokens() {
+    return create_nfa_for_rules(c0_rules, NUM_C0_RULES);
+}
+
+/**
+ * 由DFA生成扁平转换表
+ * 沿用DFA的字节等价类，并合并最简化后列完全相同的等价类；
+ * 没有任何转换的字节（包括0）都落入无转换的等价类。
+ * @param dfa DFA指针（通常为最简DFA）
+ * @param rules 规则表
+ * @param num_rules 规则数量
+ * @return 扫描表指针
+ */
+ScanTable *build_scan_table(DFA *dfa, const ScanRule *rules, int num_rules) {
+    ScanTable *table = (ScanTable *)malloc(sizeof(ScanTable));
+    if (!table) {
+        fprintf(stderr, "内存分配失败: build_scan_table\n");
+        exit(1);
+    }
+    
+    // DFA已按NFA的字节等价类建表；最简化后部分等价类的列可能变得相同，再合并一次。
+    // 没有任何转换的字节单独归入一个全为-1的等价类
+    int representative[MAX_ALPHABET];  // 每个扫描表等价类对应的DFA列（-1表示无转换）
+    int column_class[MAX_ALPHABET];    // DFA列 -> 扫描表等价类
+    table->num_classes = 0;
+    for (int col = 0; col < dfa->alphabet_size; col++) {
+        int cls;
+        for (cls = 0; cls < table->num_classes; cls++) {
+            int r = representative[cls];
+            bool same = true;
+            for (int s = 0; s < dfa->num_states && same; s++) {
+                same = (dfa->transition[s * dfa->alphabet_size + col] ==
+                        dfa->transition[s * dfa->alphabet_size + r]);
+            }
+            if (same) break;
+        }
+        if (cls == table->num_classes) {
+            representative[table->num_classes++] = col;
+        }
+        column_class[col] = cls;
+    }
+    
+    int dead_class = -1;
+    for (int c = 0; c < MAX_ALPHABET; c++) {
+        int col = dfa->symbol_index[c];
+        if (col < 0) {
+            if (dead_class < 0) {
+                dead_class = table->num_classes;
+                representative[table->num_classes++] = -1;
+            }
+            table->class_map[c] = (unsigned char)dead_class;
+        } else {
+            table->class_map[c] = (unsigned char)column_class[col];
+        }
+    }
+    
+    table->num_states = dfa->num_states;
+    table->start_state = dfa->start_state;
+    int *next = (int *)malloc(sizeof(int) * table->num_states * table->num_classes);
+    int *accept = (int *)malloc(sizeof(int) * table->num_states);
+    if (!next || !accept) {
+        fprintf(stderr, "内存分配失败: build_scan_table\n");
+        exit(1);
+    }
+    
+    for (int s = 0; s < table->num_states; s++) {
+        for (int cls = 0; cls < table->num_classes; cls++) {
+            int col = representative[cls];
+            next[s * table->num_classes + cls] =
+                (col < 0) ? -1 : dfa->transition[s * dfa->alphabet_size + col];
+        }
+        accept[s] = dfa->accept_rule[s];
+    }
+    
+    table->next = next;
+    table->accept = accept;
+    table->rules = rules;
+    table->num_rules = num_rules;
+    table->lookahead = scan_table_lookahead(table);
+    return table;
+}
+
+/**
+ * 创建C0词法分析用的扫描表
+ * 组合NFA -> 子集构造 -> 最简化 -> 扁平转换表
+ * @return 扫描表指针
+ */
+ScanTable *create_c0_scan_table() {
+    NFA *nfa = create_nfa_for_c0_tokens();
+    DFA *dfa = nfa_to_dfa(nfa);
+    DFA *min_dfa = minimize_dfa(dfa);
+    
+    ScanTable *table = build_scan_table(min_dfa, c0_rules, NUM_C0_RULES);
+    
+    free_dfa(min_dfa);
+    free_dfa(dfa);
+    free_nfa(nfa);
+    return table;
+}
+
+/**
+ * 释放扫描表内存
+ * @param table 扫描表指针
+ */
+void free_scan_table(ScanTable *table) {
+    if (table) {
+        free((void *)table->next);
+        free((void *)table->accept);
+        free(table);
+    }
+}
+
+/**
+ * 从非终态state出发、只经过非终态直到进入死状态，最多还要读入的字节数
+ * @param table 扫描表
+ * @param state 非终态
+ * @param text_class 等价类是否含有'\0'以外的字节
+ * @param dies 每个非终态能否不经终态进入死状态
+ * @param depth 已求出的结果（0表示未求出，-1表示正在求）
+ * @return 字节数，-1表示经过环路、没有上界
+ */
+static int lookahead_from(const ScanTable *table, int state, const bool *text_class,
+                          const bool *dies, int *depth) {
+    if (depth[state] != 0) {
+        return depth[state];    // 已求出，或-1：回到了正在求的状态
+    }
+    depth[state] = -1;
+    
+    int longest = 0;
+    for (int cls = 0; cls < table->num_classes; cls++) {
+        if (!text_class[cls]) continue;
+        int next = table->next[state * table->num_classes + cls];
+        int reads = 0;
+        if (next < 0) {
+            reads = 1;
+        } else if (table->accept[next] == NO_RULE && dies[next]) {
+            int rest = lookahead_from(table, next, text_class, dies, depth);
+            if (rest < 0) {
+                return -1;
+            }
+            reads = 1 + rest;
+        }
+        if (reads > longest) longest = reads;
+    }
+    
+    depth[state] = longest;
+    return longest;
+}
+
+/**
+ * 计算扫描器的最大预读：最长匹配在位置end结束时，扫描过程读过的字节
+ * 都位于end + 预读之前。增量分析据此判断编辑之前的哪些Token不受影响。
+ * 不经终态就读到文件末尾的扫描交给手写扫描，不计入（源代码不含'\0'）。
+ * @param table 扫描表
+ * @return 最大预读字节数，-1表示没有上界
+ */
+int scan_table_lookahead(const ScanTable *table) {
+    bool text_class[256] = { false };
+    for (int c = 1; c < 256; c++) {
+        text_class[table->class_map[c]] = true;
+    }
+    
+    // 能否只经过非终态进入死状态：反复传播直到不再变化
+    bool *dies = (bool *)calloc(table->num_states, sizeof(bool));
+    int *depth = (int *)calloc(table->num_states, sizeof(int));
+    if (!dies || !depth) {
+        fprintf(stderr, "内存分配失败: scan_table_lookahead\n");
+        exit(1);
+    }
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int s = 0; s < table->num_states; s++) {
+            if (dies[s] || table->accept[s] != NO_RULE) continue;
+            for (int cls = 0; cls < table->num_classes; cls++) {
+                if (!text_class[cls]) continue;
+                int next = table->next[s * table->num_classes + cls];
+                if (next < 0 || (table->accept[next] == NO_RULE && dies[next])) {
+                    dies[s] = true;
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+    
+    // 从每个终态出发：进入死状态读1字节，进入非终态则再加上其后的最长路径
+    int longest = 0;
+    for (int s = 0; s < table->num_states && longest >= 0; s++) {
+        if (table->accept[s] == NO_RULE) continue;
+        for (int cls = 0; cls < table->num_classes; cls++) {
+            if (!text_class[cls]) continue;
+            int next = table->next[s * table->num_classes + cls];
+            int reads = 0;
+            if (next < 0) {
+                reads = 1;
+            } else if (table->accept[next] == NO_RULE && dies[next]) {
+                int rest = lookahead_from(table, next, text_class, dies, depth);
+                if (rest < 0) {
+                    longest = -1;
+                    break;
+                }
+                reads = 1 + rest;
+            }
+            if (reads > longest) longest = reads;
+        }
+    }
+    
+    free(dies);
+    free(depth);
+    return longest;
+}
+
+/**
+ * 输出一个int数组的初始化列表，每行16项
+ * @param out 输出文件
+ * @param values 数组
+ * @param count 项数
+ * @param indent 行首缩进
+ */
+static void emit_int_array(FILE *out, const int *values, int count, const char *indent) {
+    for (int i = 0; i < count; i++) {
+        if (i % 16 == 0) {
+            fprintf(out, "%s", indent);
+        }
+        fprintf(out, "%d,", values[i]);
+        fprintf(out, (i % 16 == 15 || i == count - 1) ? "\n" : " ");
+    }
+}
+
+/**
+ * 将扫描表输出为C头文件
+ * 等价类映射、转换表和终态规则都输出为static const数组，并定义一个
+ * 引用它们的ScanTable常量，编译后位于只读数据段，运行时无需构造自动机。
+ * @param table 扫描表
+ * @param name 生成的ScanTable常量名（数组名以其为前缀）
+ * @param rules_name 规则表的变量名，规则表本身不输出
+ * @param out 输出文件
+ * @return 是否成功
+ */
+bool emit_scan_table(const ScanTable *table, const char *name, const char *rules_name, FILE *out) {
+    char guard[128];
+    int n = 0;
+    for (const char *p = name; *p && n < (int)sizeof(guard) - 3; p++) {
+        guard[n++] = (*p >= 'a' && *p <= 'z') ? *p - 'a' + 'A' : *p;
+    }
+    strcpy(guard + n, "_H");
+    
+    fprintf(out, "/**\n");
+    fprintf(out, " * 预生成的扫描表：%d 个状态，%d 个字节等价类，%d 条规则\n",
+            table->num_states, table->num_classes, table->num_rules);
+    fprintf(out, " *\n");
+    fprintf(out, " * 由 c0compiler --emit-tables 自动生成，请勿手工修改；\n");
+    fprintf(out, " * 修改scanner.c中的规则表后执行make即可重新生成\n");
+    fprintf(out, " */\n\n");
+    fprintf(out, "#ifndef %s\n#define %s\n\n", guard, guard);
+    fprintf(out, "#include \"scanner.h\"\n\n");
+    
+    fprintf(out, "static const int %s_next[%d] = {\n", name, table->num_states * table->num_classes);
+    emit_int_array(out, table->next, table->num_states * table->num_classes, "    ");
+    fprintf(out, "};\n\n");
+    
+    fprintf(out, "static const int %s_accept[%d] = {\n", name, table->num_states);
+    emit_int_array(out, table->accept, table->num_states, "    ");
+    fprintf(out, "};\n\n");
+    
+    int class_map[256];
+    for (int c = 0; c < 256; c++) {
+        class_map[c] = table->class_map[c];
+    }
+    fprintf(out, "static const ScanTable %s = {\n", name);
+    fprintf(out, "    .class_map = {\n");
+    emit_int_array(out, class_map, 256, "        ");
+    fprintf(out, "    },\n");
+    fprintf(out, "    .num_classes = %d,\n", table->num_classes);
+    fprintf(out, "    .num_states = %d,\n", table->num_states);
+    fprintf(out, "    .start_state = %d,\n", table->start_state);
+    fprintf(out, "    .next = %s_next,\n", name);
+    fprintf(out, "    .accept = %s_accept,\n", name);
+    fprintf(out, "    .rules = %s,\n", rules_name);
+    fprintf(out, "    .num_rules = %d,\n", table->num_rules);
+    fprintf(out, "    .lookahead = %d,\n", table->lookahead);
+    fprintf(out, "};\n\n");
+    fprintf(out, "#endif /* %s */\n", guard);
+    
+    return !ferror(out);
+}
+
+/**
+ * 构造C0扫描表并输出为C头文件
+ * @param filename 输出文件名
+ * @return 是否成功
+ */
+bool emit_c0_scan_table(const char *filename) {
+    FILE *out = fopen(filename, "w");
+    if (!out) {
+        fprintf(stderr, "错误: 无法创建文件 '%s'\n", filename);
+        return false;
+    }
+    
+    ScanTable *table = create_c0_scan_table();
+    bool ok = emit_scan_table(table, "c0_scan_table", "c0_rules", out);
+    free_scan_table(table);
+    
+    if (fclose(out) != 0 || !ok) {
+        fprintf(stderr, "错误: 写入文件 '%s' 失败\n", filename);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 输出一个状态的直接编码：终态记录规则和结束位置，再按下一字节的等价类跳转
+ * 出现次数最多的目标（通常为死状态）作为default分支，其余目标各自列出等价类
+ * @param table 扫描表
+ * @param name 扫描函数名（等价类映射数组名以其为前缀）
+ * @param state 状态编号
+ * @param labeled 是否输出标号（只为被跳转到的状态输出，否则会有未使用标号的警告）
+ * @param targets 工作区：每个等价类的目标状态（num_classes项）
+ * @param out 输出文件
+ */
+static void emit_direct_state(const ScanTable *table, const char *name, int state,
+                              bool labeled, int *targets, FILE *out) {
+    int rule = table->accept[state];
+    if (labeled) {
+        fprintf(out, "state_%d:\n", state);
+    }
+    if (rule != NO_RULE) {
+        fprintf(out, "    rule = %d;\n", rule);
+        fprintf(out, "    *end = pos;\n");
+    }
+    
+    // 各目标出现的次数，取最多的作为default
+    int num_classes = table->num_classes;
+    int default_target = -1;
+    int default_count = 0;
+    for (int cls = 0; cls < num_classes; cls++) {
+        targets[cls] = table->next[state * num_classes + cls];
+    }
+    for (int cls = 0; cls < num_classes; cls++) {
+        int count = 0;
+        for (int other = 0; other < num_classes; other++) {
+            count += targets[other] == targets[cls];
+        }
+        if (count > default_count) {
+            default_count = count;
+            default_target = targets[cls];
+        }
+    }
+    if (default_count == num_classes && default_target < 0) {
+        fprintf(out, "    goto done;\n");
+        return;
+    }
+    
+    fprintf(out, "    if (pos == length) goto %s;\n", rule != NO_RULE ? "done" : "incomplete");
+    fprintf(out, "    switch (%s_class[source[pos]]) {\n", name);
+    for (int cls = 0; cls < num_classes; cls++) {
+        int target = targets[cls];
+        bool listed = false;
+        for (int prev = 0; prev < cls && !listed; prev++) {
+            listed = targets[prev] == target;
+        }
+        if (target == default_target || listed) {
+            continue;
+        }
+        fprintf(out, "       ");
+        for (int other = cls; other < num_classes; other++) {
+            if (targets[other] == target) {
+                fprintf(out, " case %d:", other);
+            }
+        }
+        fprintf(out, "\n");
+        if (target < 0) {
+            fprintf(out, "            goto done;\n");
+        } else {
+            fprintf(out, "            pos++;\n");
+            fprintf(out, "            goto state_%d;\n", target);
+        }
+    }
+    fprintf(out, "        default:\n");
+    if (default_target < 0) {
+        fprintf(out, "            goto done;\n");
+    } else {
+        fprintf(out, "            pos++;\n");
+        fprintf(out, "            goto state_%d;\n", default_target);
+    }
+    fprintf(out, "    }\n");
+}
+
+/**
+ * 将扫描表输出为直接编码的扫描函数（C头文件）
+ * 每个状态对应一个标号，按下一字节的等价类switch后goto到目标状态，
+ * 扫描时不再按状态和等价类查转换表。生成的函数为
+ *   static int <name>(const unsigned char *source, size_t length, size_t start,
+ *                     size_t *end, size_t *stop)
+ * 与按表最长匹配的语义相同：返回识别出的规则编号，在文件结束处停在非终态时返回NO_RULE。
+ * @param table 扫描表
+ * @param name 生成的扫描函数名
+ * @param out 输出文件
+ * @return 是否成功
+ */
+bool emit_direct_scanner(const ScanTable *table, const char *name, FILE *out) {
+    char guard[128];
+    int n = 0;
+    for (const char *p = name; *p && n < (int)sizeof(guard) - 3; p++) {
+        guard[n++] = (*p >= 'a' && *p <= 'z') ? *p - 'a' + 'A' : *p;
+    }
+    strcpy(guard + n, "_H");
+    
+    // 被跳转到的状态；初始状态排在最前，从函数入口直接进入
+    bool *used = (bool *)calloc(table->num_states, sizeof(bool));
+    int *targets = (int *)malloc(sizeof(int) * table->num_classes);
+    if (!used || !targets) {
+        fprintf(stderr, "内存分配失败: emit_direct_scanner\n");
+        exit(1);
+    }
+    for (int i = 0; i < table->num_states * table->num_classes; i++) {
+        if (table->next[i] >= 0) {
+            used[table->next[i]] = true;
+        }
+    }
+    
+    fprintf(out, "/**\n");
+    fprintf(out, " * 预生成的直接编码扫描器：%d 个状态，%d 个字节等价类，%d 条规则\n",
+            table->num_states, table->num_classes, table->num_rules);
+    fprintf(out, " *\n");
+    fprintf(out, " * 由 tablegen --direct 自动生成，请勿手工修改；\n");
+    fprintf(out, " * 修改scanner.c中的规则表后执行make即可重新生成\n");
+    fprintf(out, " */\n\n");
+    fprintf(out, "#ifndef %s\n#define %s\n\n", guard, guard);
+    fprintf(out, "#include <stddef.h>\n");
+    fprintf(out, "#include \"scanner.h\"\n\n");
+    
+    int class_map[256];
+    for (int c = 0; c < 256; c++) {
+        class_map[c] = table->class_map[c];
+    }
+    fprintf(out, "static const unsigned char %s_class[256] = {\n", name);
+    emit_int_array(out, class_map, 256, "    ");
+    fprintf(out, "};\n\n");
+    
+    fprintf(out, "static int %s(const unsigned char *source, size_t length, size_t start,\n", name);
+    fprintf(out, "%*ssize_t *end, size_t *stop) {\n", (int)strlen(name) + 12, "");
+    fprintf(out, "    size_t pos = start;\n");
+    fprintf(out, "    int rule = NO_RULE;\n\n");
+    emit_direct_state(table, name, table->start_state, used[table->start_state], targets, out);
+    for (int s = 0; s < table->num_states; s++) {
+        if (s != table->start_state && used[s]) {
+            fprintf(out, "\n");
+            emit_direct_state(table, name, s, true, targets, out);
+        }
+    }
+    fprintf(out, "\nincomplete:\n");
+    fprintf(out, "    *stop = pos;\n");
+    fprintf(out, "    return NO_RULE;\n");
+    fprintf(out, "done:\n");
+    fprintf(out, "    *stop = pos;\n");
+    fprintf(out, "    return rule;\n");
+    fprintf(out, "}\n\n");
+    fprintf(out, "#endif /* %s */\n", guard);
+    
+    free(used);
+    free(targets);
+    return !ferror(out);
+}
+
+/**
+ * 构造C0扫描表并输出为直接编码的扫描函数
+ * @param filename 输出文件名
+ * @return 是否成功
+ */
+bool emit_c0_direct_scanner(const char *filename) {
+    FILE *out = fopen(filename, "w");
+    if (!out) {
+        fprintf(stderr, "错误: 无法创建文件 '%s'\n", filename);
+        return false;
+    }
+    
+    ScanTable *table = create_c0_scan_table();
+    bool ok = emit_direct_scanner(table, "c0_direct_scanner", out);
+    free_scan_table(table);
+    
+    if (fclose(out) != 0 || !ok) {
+        fprintf(stderr, "错误: 写入文件 '%s' 失败\n", filename);
+        return false;
+    }
+    return true;
+}
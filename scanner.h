@@ -0,0 +1,58 @@
+/**
+ * scanner.h - 表驱动扫描器头文件
+ *
+ * 以正规式描述C0全部Token类别，经组合NFA和最简DFA生成扁平转换表，
+ * 供词法分析器按表扫描
+ */
+
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include "token.h"
+#include "nfa_dfa.h"
+
+/* 扫描规则：一条正规式及其识别的Token类别 */
+typedef struct {
+    const char *pattern;    // 正规式
+    TokenType type;         // 识别出的Token类型
+    const char *lexeme;     // 固定词素（运算符、分隔符），可变词素为NULL
+    bool skip;              // 是否丢弃（空白和注释）
+} ScanRule;
+
+/* 扁平DFA转换表 */
+typedef struct {
+    unsigned char class_map[256]; // 字节 -> 等价类编号
+    int num_classes;        // 等价类数量
+    int num_states;         // 状态数量
+    int start_state;        // 初始状态
+    const int *next;        // 转换表：next[状态 * num_classes + 等价类]，-1表示无转换
+    const int *accept;      // 每个状态识别的规则编号（NO_RULE表示非终态）
+    const ScanRule *rules;  // 规则表（按规则编号索引）
+    int num_rules;          // 规则数量
+    int lookahead;          // 最大预读字节数（见scan_table_lookahead，-1表示没有上界）
+} ScanTable;
+
+/* C0规则表（定义于scanner.c） */
+extern const ScanRule c0_rules[];
+
+/* 扫描表操作函数 */
+NFA *create_nfa_for_rules(const ScanRule *rules, int num_rules);
+NFA *create_nfa_for_c0_tokens();
+ScanTable *build_scan_table(DFA *dfa, const ScanRule *rules, int num_rules);
+ScanTable *create_c0_scan_table();
+void free_scan_table(ScanTable *table);
+int scan_table_lookahead(const ScanTable *table);
+bool emit_scan_table(const ScanTable *table, const char *name, const char *rules_name, FILE *out);
+bool emit_c0_scan_table(const char *filename);
+bool emit_direct_scanner(const ScanTable *table, const char *name, FILE *out);
+bool emit_c0_direct_scanner(const char *filename);
+
+/* 预生成的C0扫描表（定义于c0_tables.c，数据由emit_c0_scan_table生成） */
+const ScanTable *get_c0_scan_table();
+
+/* 直接编码的C0扫描器（定义于c0_direct.c，代码由emit_c0_direct_scanner生成）：
+ * 与按预生成扫描表最长匹配的结果相同，规则编号即c0_rules的下标 */
+int c0_direct_match(const unsigned char *source, size_t length, size_t start,
+                    size_t *end, size_t *stop);
+
+#endif /* SCANNER_H */
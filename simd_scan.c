@@ -0,0 +1,276 @@
+/**
+ * simd_scan.c - 向量化扫描函数实现
+ *
+ * 每个平台只需提供少量16字节块操作（加载、按字节比较、区间判断、
+ * 取掩码），各扫描函数在此之上编写一次：整块比较得到掩码，掩码非零时
+ * 取最低位即为第一个命中的字节；不足16字节的尾部逐字节处理。
+ */
+
+#include <stdint.h>
+#include "simd_scan.h"
+
+#if !defined(C0_NO_SIMD) && defined(__SSE2__)
+
+#include <emmintrin.h>
+
+#define SIMD_ENABLED
+#define SIMD_MASK_BITS 1        // 掩码中每个字节占的位数
+
+typedef __m128i simd_vec;
+typedef uint64_t simd_mask;
+
+static inline simd_vec simd_load(const char *p) {
+    return _mm_loadu_si128((const __m128i *)p);
+}
+
+static inline simd_vec simd_splat(unsigned char c) {
+    return _mm_set1_epi8((char)c);
+}
+
+static inline simd_vec simd_eq(simd_vec v, unsigned char c) {
+    return _mm_cmpeq_epi8(v, _mm_set1_epi8((char)c));
+}
+
+/* 字节是否在 [lo, lo + span] 内：减去lo后做无符号饱和减法，结果为0即在区间内 */
+static inline simd_vec simd_in_range(simd_vec v, unsigned char lo, unsigned char span) {
+    simd_vec d = _mm_sub_epi8(v, _mm_set1_epi8((char)lo));
+    return _mm_cmpeq_epi8(_mm_subs_epu8(d, _mm_set1_epi8((char)span)), _mm_setzero_si128());
+}
+
+static inline simd_vec simd_or(simd_vec a, simd_vec b) {
+    return _mm_or_si128(a, b);
+}
+
+static inline simd_vec simd_and(simd_vec a, simd_vec b) {
+    return _mm_and_si128(a, b);
+}
+
+static inline simd_mask simd_movemask(simd_vec v) {
+    return (simd_mask)_mm_movemask_epi8(v);
+}
+
+static inline simd_mask simd_invert(simd_mask m) {
+    return ~m & 0xFFFF;
+}
+
+#elif !defined(C0_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+
+#include <arm_neon.h>
+
+#define SIMD_ENABLED
+#define SIMD_MASK_BITS 4        // 窄化移位后每个字节占4位
+
+typedef uint8x16_t simd_vec;
+typedef uint64_t simd_mask;
+
+static inline simd_vec simd_load(const char *p) {
+    return vld1q_u8((const uint8_t *)p);
+}
+
+static inline simd_vec simd_splat(unsigned char c) {
+    return vdupq_n_u8(c);
+}
+
+static inline simd_vec simd_eq(simd_vec v, unsigned char c) {
+    return vceqq_u8(v, vdupq_n_u8(c));
+}
+
+static inline simd_vec simd_in_range(simd_vec v, unsigned char lo, unsigned char span) {
+    return vcleq_u8(vsubq_u8(v, vdupq_n_u8(lo)), vdupq_n_u8(span));
+}
+
+static inline simd_vec simd_or(simd_vec a, simd_vec b) {
+    return vorrq_u8(a, b);
+}
+
+static inline simd_vec simd_and(simd_vec a, simd_vec b) {
+    return vandq_u8(a, b);
+}
+
+/* NEON没有movemask：每16位右移4位后窄化为8位，得到每字节4位的64位掩码 */
+static inline simd_mask simd_movemask(simd_vec v) {
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(v), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+static inline simd_mask simd_invert(simd_mask m) {
+    return ~m;
+}
+
+#endif
+
+#ifdef SIMD_ENABLED
+
+#define SIMD_WIDTH 16
+
+/* 掩码中第一个命中字节的下标 */
+static inline size_t simd_first(simd_mask m) {
+    return (size_t)__builtin_ctzll(m) / SIMD_MASK_BITS;
+}
+
+/* 空白字符：' ' 以及 \t \n \v \f \r（9..13） */
+static inline simd_vec simd_is_space(simd_vec v) {
+    return simd_or(simd_in_range(v, 9, 4), simd_eq(v, ' '));
+}
+
+/* 标识符字符：[0-9A-Za-z_]，大小写字母通过"或0x20"合并判断 */
+static inline simd_vec simd_is_ident(simd_vec v) {
+    simd_vec lower = simd_or(v, simd_splat(0x20));
+    return simd_or(simd_or(simd_in_range(lower, 'a', 25), simd_in_range(v, '0', 9)),
+                   simd_eq(v, '_'));
+}
+
+#endif /* SIMD_ENABLED */
+
+/**
+ * 跳过空白字符（' ' \t \n \v \f \r）
+ * @param source 源代码
+ * @param pos 起始位置
+ * @param end 结束位置
+ * @return 第一个非空白字符的位置
+ */
+size_t simd_skip_whitespace(const char *source, size_t pos, size_t end) {
+#ifdef SIMD_ENABLED
+    while (pos + SIMD_WIDTH <= end) {
+        simd_mask m = simd_invert(simd_movemask(simd_is_space(simd_load(source + pos))));
+        if (m) {
+            return pos + simd_first(m);
+        }
+        pos += SIMD_WIDTH;
+    }
+#endif
+    while (pos < end) {
+        unsigned char c = (unsigned char)source[pos];
+        if (c != ' ' && (c < 9 || c > 13)) break;
+        pos++;
+    }
+    return pos;
+}
+
+/**
+ * 跳过标识符字符（字母、数字、下划线）
+ * @param source 源代码
+ * @param pos 起始位置
+ * @param end 结束位置
+ * @return 第一个非标识符字符的位置
+ */
+size_t simd_identifier_end(const char *source, size_t pos, size_t end) {
+#ifdef SIMD_ENABLED
+    while (pos + SIMD_WIDTH <= end) {
+        simd_mask m = simd_invert(simd_movemask(simd_is_ident(simd_load(source + pos))));
+        if (m) {
+            return pos + simd_first(m);
+        }
+        pos += SIMD_WIDTH;
+    }
+#endif
+    while (pos < end) {
+        unsigned char c = (unsigned char)source[pos];
+        unsigned char lower = c | 0x20;
+        if (!(lower >= 'a' && lower <= 'z') && !(c >= '0' && c <= '9') && c != '_') break;
+        pos++;
+    }
+    return pos;
+}
+
+/**
+ * 查找单行注释的结束：第一个'\n'或'\0'
+ * @param source 源代码
+ * @param pos 起始位置
+ * @param end 结束位置
+ * @return 找到的位置，找不到时返回end
+ */
+size_t simd_find_line_end(const char *source, size_t pos, size_t end) {
+#ifdef SIMD_ENABLED
+    while (pos + SIMD_WIDTH <= end) {
+        simd_vec v = simd_load(source + pos);
+        simd_mask m = simd_movemask(simd_or(simd_eq(v, '\n'), simd_eq(v, 0)));
+        if (m) {
+            return pos + simd_first(m);
+        }
+        pos += SIMD_WIDTH;
+    }
+#endif
+    while (pos < end && source[pos] != '\n' && source[pos] != '\0') {
+        pos++;
+    }
+    return pos;
+}
+
+/**
+ * 查找多行注释的结束：第一个"*\/"中的'*'，或第一个'\0'
+ * 同时比较当前块和后移一个字节的块，判断'*'之后是否紧跟'/'
+ * @param source 源代码
+ * @param pos 起始位置
+ * @param end 结束位置
+ * @return 找到的位置，找不到时返回end
+ */
+size_t simd_find_comment_end(const char *source, size_t pos, size_t end) {
+#ifdef SIMD_ENABLED
+    while (pos + SIMD_WIDTH + 1 <= end) {
+        simd_vec v = simd_load(source + pos);
+        simd_vec next = simd_load(source + pos + 1);
+        simd_mask m = simd_movemask(simd_or(simd_and(simd_eq(v, '*'), simd_eq(next, '/')),
+                                            simd_eq(v, 0)));
+        if (m) {
+            return pos + simd_first(m);
+        }
+        pos += SIMD_WIDTH;
+    }
+#endif
+    while (pos < end) {
+        if (source[pos] == '\0' || (source[pos] == '*' && pos + 1 < end && source[pos + 1] == '/')) {
+            return pos;
+        }
+        pos++;
+    }
+    return end;
+}
+
+/**
+ * 查找字符串内容中需要特殊处理的字符：'"'、'\\'或'\0'
+ * @param source 源代码
+ * @param pos 起始位置
+ * @param end 结束位置
+ * @return 找到的位置，找不到时返回end
+ */
+size_t simd_find_string_special(const char *source, size_t pos, size_t end) {
+#ifdef SIMD_ENABLED
+    while (pos + SIMD_WIDTH <= end) {
+        simd_vec v = simd_load(source + pos);
+        simd_mask m = simd_movemask(simd_or(simd_or(simd_eq(v, '"'), simd_eq(v, '\\')),
+                                            simd_eq(v, 0)));
+        if (m) {
+            return pos + simd_first(m);
+        }
+        pos += SIMD_WIDTH;
+    }
+#endif
+    while (pos < end && source[pos] != '"' && source[pos] != '\\' && source[pos] != '\0') {
+        pos++;
+    }
+    return pos;
+}
+
+/**
+ * 查找下一个换行符
+ * @param source 源代码
+ * @param pos 起始位置
+ * @param end 结束位置
+ * @return 找到的位置，找不到时返回end
+ */
+size_t simd_find_newline(const char *source, size_t pos, size_t end) {
+#ifdef SIMD_ENABLED
+    while (pos + SIMD_WIDTH <= end) {
+        simd_mask m = simd_movemask(simd_eq(simd_load(source + pos), '\n'));
+        if (m) {
+            return pos + simd_first(m);
+        }
+        pos += SIMD_WIDTH;
+    }
+#endif
+    while (pos < end && source[pos] != '\n') {
+        pos++;
+    }
+    return pos;
+}
@@ -0,0 +1,25 @@
+/**
+ * simd_scan.h - 向量化扫描函数头文件
+ *
+ * 词法分析中最长的几类字节串（空白、注释、字符串内容、标识符）只需要
+ * 找到它们的结束位置，行号索引只需要找到换行符，这些函数每次比较16个字节：
+ *   x86-64 使用SSE2，ARM64 使用NEON，其余平台使用逐字节实现。
+ * 编译时定义 C0_NO_SIMD 可强制使用逐字节实现。
+ *
+ * 所有函数在源代码的 [pos, end) 范围内查找，返回找到的位置，找不到时返回end。
+ */
+
+#ifndef SIMD_SCAN_H
+#define SIMD_SCAN_H
+
+#include <stddef.h>
+
+/* 向量化扫描函数 */
+size_t simd_skip_whitespace(const char *source, size_t pos, size_t end);
+size_t simd_identifier_end(const char *source, size_t pos, size_t end);
+size_t simd_find_line_end(const char *source, size_t pos, size_t end);
+size_t simd_find_comment_end(const char *source, size_t pos, size_t end);
+size_t simd_find_string_special(const char *source, size_t pos, size_t end);
+size_t simd_find_newline(const char *source, size_t pos, size_t end);
+
+#endif /* SIMD_SCAN_H */
@@ -0,0 +1,186 @@
+/**
+ * source_file.c - 源文件读取实现
+ *
+ * 映射和读取使用POSIX接口，"-"表示标准输入。
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "source_file.h"
+
+#define READ_CHUNK_SIZE (64 * 1024)     // 逐块读取时的初始缓冲区大小
+
+/**
+ * 将文件描述符中的全部内容读入堆内存
+ * @param file 输出：源文件
+ * @param fd 文件描述符
+ * @param size_hint 预计大小（未知时为0）
+ * @return 是否成功（超过SOURCE_FILE_MAX_LENGTH时失败，errno为EFBIG）
+ */
+static bool read_whole_fd(SourceFile *file, int fd, size_t size_hint) {
+    size_t capacity = size_hint > 0 ? size_hint + 1 : READ_CHUNK_SIZE;
+    size_t length = 0;
+    char *buffer = (char *)malloc(capacity);
+    if (!buffer) {
+        fprintf(stderr, "内存分配失败: read_whole_fd\n");
+        exit(1);
+    }
+    
+    while (1) {
+        if (length == capacity) {
+            capacity *= 2;
+            buffer = (char *)realloc(buffer, capacity);
+            if (!buffer) {
+                fprintf(stderr, "内存分配失败: read_whole_fd\n");
+                exit(1);
+            }
+        }
+        
+        ssize_t n = read(fd, buffer + length, capacity - length);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            free(buffer);
+            return false;
+        }
+        if (n == 0) {
+            break;
+        }
+        length += (size_t)n;
+        if (length > SOURCE_FILE_MAX_LENGTH) {
+            free(buffer);
+            errno = EFBIG;
+            return false;
+        }
+    }
+    
+    file->data = buffer;
+    file->length = length;
+    file->mapped = false;
+    return true;
+}
+
+/**
+ * 打开并读入源文件
+ * 非空的普通文件只读映射并提示顺序访问，其余输入（或映射失败时）逐块读取；
+ * 超过SOURCE_FILE_MAX_LENGTH的输入拒绝读入
+ * @param file 输出：源文件（用source_file_close释放）
+ * @param filename 文件名，"-"表示标准输入
+ * @return 是否成功（失败时已输出错误信息）
+ */
+bool source_file_open(SourceFile *file, const char *filename) {
+    bool is_stdin = strcmp(filename, "-") == 0;
+    int fd = is_stdin ? STDIN_FILENO : open(filename, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "错误: 无法打开文件 '%s'\n", filename);
+        return false;
+    }
+    
+    struct stat st;
+    bool regular = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+    if (regular && (uint64_t)st.st_size > SOURCE_FILE_MAX_LENGTH) {
+        fprintf(stderr, "错误: 文件 '%s' 超过4GB，无法分析\n", filename);
+        if (!is_stdin) {
+            close(fd);
+        }
+        return false;
+    }
+    if (regular && st.st_size > 0) {
+        size_t size = (size_t)st.st_size;
+        void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            posix_madvise(data, size, POSIX_MADV_SEQUENTIAL);
+            if (!is_stdin) {
+                close(fd);
+            }
+            file->data = (const char *)data;
+            file->length = size;
+            file->mapped = true;
+            return true;
+        }
+    }
+    
+    bool ok = read_whole_fd(file, fd, regular ? (size_t)st.st_size : 0);
+    if (!is_stdin) {
+        close(fd);
+    }
+    if (!ok && errno == EFBIG) {
+        fprintf(stderr, "错误: 文件 '%s' 超过4GB，无法分析\n", filename);
+    } else if (!ok) {
+        fprintf(stderr, "错误: 无法读取文件 '%s'\n", filename);
+    }
+    return ok;
+}
+
+/**
+ * 释放源文件内容
+ * @param file 源文件
+ */
+void source_file_close(SourceFile *file) {
+    if (file->mapped) {
+        munmap((void *)file->data, file->length);
+    } else {
+        free((void *)file->data);
+    }
+    file->data = NULL;
+    file->length = 0;
+    file->mapped = false;
+}
+
+/**
+ * 打开流式输入
+ * @param filename 文件名，"-"表示标准输入
+ * @return 文件描述符，失败时返回-1（已输出错误信息）
+ */
+int source_file_open_stream(const char *filename) {
+    if (strcmp(filename, "-") == 0) {
+        return STDIN_FILENO;
+    }
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "错误: 无法打开文件 '%s'\n", filename);
+        return -1;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    return fd;
+}
+
+/**
+ * 关闭流式输入（标准输入不关闭）
+ * @param fd 文件描述符
+ */
+void source_file_close_stream(int fd) {
+    if (fd != STDIN_FILENO) {
+        close(fd);
+    }
+}
+
+/**
+ * 流式词法分析的输入回调：从文件描述符读取一块
+ * @param context 指向文件描述符的指针
+ * @param buffer 输出缓冲区
+ * @param capacity 缓冲区大小
+ * @return 读取的字节数，0表示输入结束（读取出错时同样结束并输出错误信息）
+ */
+size_t source_file_read_chunk(void *context, char *buffer, size_t capacity) {
+    int fd = *(const int *)context;
+    while (1) {
+        ssize_t n = read(fd, buffer, capacity);
+        if (n >= 0) {
+            return (size_t)n;
+        }
+        if (errno != EINTR) {
+            fprintf(stderr, "错误: 读取输入失败\n");
+            return 0;
+        }
+    }
+}
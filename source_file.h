@@ -0,0 +1,34 @@
+/**
+ * source_file.h - 源文件读取头文件
+ *
+ * 普通文件以只读方式整体映射到内存，词法分析器直接扫描映射区，不再复制；
+ * 管道、终端和标准输入等无法映射的输入退回到逐块读取到堆内存。
+ * 内容不以'\0'结尾，使用者必须按长度访问。
+ * Token只记录32位偏移，超过SOURCE_FILE_MAX_LENGTH的文件拒绝读入。
+ * 流式输入只打开文件描述符，由词法分析器经回调逐块读取。
+ */
+
+#ifndef SOURCE_FILE_H
+#define SOURCE_FILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SOURCE_FILE_MAX_LENGTH ((size_t)UINT32_MAX) // 源文件的最大长度（Token偏移为32位）
+
+/* 已读入的源文件 */
+typedef struct {
+    const char *data;       // 文件内容（不以'\0'结尾）
+    size_t length;          // 文件长度
+    bool mapped;            // 是否为内存映射（否则为堆内存）
+} SourceFile;
+
+/* 源文件函数 */
+bool source_file_open(SourceFile *file, const char *filename);
+void source_file_close(SourceFile *file);
+int source_file_open_stream(const char *filename);
+void source_file_close_stream(int fd);
+size_t source_file_read_chunk(void *context, char *buffer, size_t capacity);
+
+#endif /* SOURCE_FILE_H */
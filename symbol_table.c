@@ -0,0 +1,173 @@
+/**
+ * symbol_table.c - 符号表（字符串驻留）实现
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "symbol_table.h"
+
+/**
+ * 初始化空的符号表（首次驻留时才分配内存）
+ * @param table 符号表
+ */
+void symbol_table_init(SymbolTable *table) {
+    memset(table, 0, sizeof(SymbolTable));
+    arena_init(&table->arena);
+}
+
+/**
+ * 计算名字的散列值：每次并入8字节，乘法加移位混合（名字大多不超过16字节）
+ * @param name 名字
+ * @param length 名字长度
+ * @return 散列值
+ */
+uint32_t symbol_hash(const char *name, size_t length) {
+    uint64_t hash = (uint64_t)length * 0x9E3779B97F4A7C15ULL;
+    uint64_t word;
+    while (length >= 8) {
+        memcpy(&word, name, 8);
+        hash = (hash ^ word) * 0xBF58476D1CE4E5B9ULL;
+        hash ^= hash >> 31;
+        name += 8;
+        length -= 8;
+    }
+    if (length > 0) {
+        word = 0;
+        memcpy(&word, name, length);
+        hash = (hash ^ word) * 0x94D049BB133111EBULL;
+        hash ^= hash >> 29;
+    }
+    return (uint32_t)(hash ^ (hash >> 32));
+}
+
+/**
+ * 在散列槽中查找名字
+ * @param table 符号表（num_slots不为0）
+ * @param name 名字
+ * @param length 名字长度
+ * @param hash 名字的散列值
+ * @return 名字所在的槽，或应当插入的空槽
+ */
+static uint32_t find_slot(const SymbolTable *table, const char *name, size_t length,
+                          uint32_t hash) {
+    uint32_t mask = table->num_slots - 1;
+    uint32_t slot = hash & mask;
+    while (table->slots[slot] != 0) {
+        uint32_t id = table->slots[slot] - 1;
+        if (table->hashes[id] == hash && table->lengths[id] == length &&
+            memcmp(table->names[id], name, length) == 0) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/**
+ * 把散列槽扩大一倍，按保存的散列值重新放置所有符号
+ * @param table 符号表
+ */
+static void grow_slots(SymbolTable *table) {
+    uint32_t num_slots = table->num_slots ? table->num_slots * 2 : SYMBOL_TABLE_MIN_SLOTS;
+    uint32_t *slots = (uint32_t *)calloc(num_slots, sizeof(uint32_t));
+    if (!slots) {
+        fprintf(stderr, "内存分配失败: symbol_table_intern\n");
+        exit(1);
+    }
+    uint32_t mask = num_slots - 1;
+    for (int id = 0; id < table->count; id++) {
+        uint32_t slot = table->hashes[id] & mask;
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = (uint32_t)id + 1;
+    }
+    free(table->slots);
+    table->slots = slots;
+    table->num_slots = num_slots;
+}
+
+/**
+ * 驻留一个名字：已有相同的名字时返回其编号，否则复制名字并分配新编号
+ * @param table 符号表
+ * @param name 名字（无需以'\0'结尾）
+ * @param length 名字长度
+ * @return 符号编号
+ */
+uint32_t symbol_table_intern(SymbolTable *table, const char *name, size_t length) {
+    if ((uint32_t)(table->count + 1) * 2 > table->num_slots) {
+        grow_slots(table);
+    }
+    
+    uint32_t hash = symbol_hash(name, length);
+    uint32_t slot = find_slot(table, name, length, hash);
+    if (table->slots[slot] != 0) {
+        return table->slots[slot] - 1;
+    }
+    
+    if (table->count == table->capacity) {
+        table->capacity = table->capacity ? table->capacity * 2 : SYMBOL_TABLE_MIN_SLOTS / 2;
+        table->names = (const char **)realloc(table->names, table->capacity * sizeof(const char *));
+        table->lengths = (uint32_t *)realloc(table->lengths, table->capacity * sizeof(uint32_t));
+        table->hashes = (uint32_t *)realloc(table->hashes, table->capacity * sizeof(uint32_t));
+        if (!table->names || !table->lengths || !table->hashes) {
+            fprintf(stderr, "内存分配失败: symbol_table_intern\n");
+            exit(1);
+        }
+    }
+    
+    uint32_t id = (uint32_t)table->count++;
+    table->names[id] = arena_strndup(&table->arena, name, length);
+    table->lengths[id] = (uint32_t)length;
+    table->hashes[id] = hash;
+    table->slots[slot] = id + 1;
+    return id;
+}
+
+/**
+ * 查找名字，不驻留
+ * @param table 符号表
+ * @param name 名字
+ * @param length 名字长度
+ * @param id 输出：符号编号
+ * @return 名字是否已驻留
+ */
+bool symbol_table_find(const SymbolTable *table, const char *name, size_t length, uint32_t *id) {
+    if (table->num_slots == 0) {
+        return false;
+    }
+    uint32_t slot = find_slot(table, name, length, symbol_hash(name, length));
+    if (table->slots[slot] == 0) {
+        return false;
+    }
+    *id = table->slots[slot] - 1;
+    return true;
+}
+
+/**
+ * 取符号的名字
+ * @param table 符号表
+ * @param id 符号编号
+ * @param length 输出：名字长度（可为NULL）
+ * @return 名字（以'\0'结尾）
+ */
+const char *symbol_table_name(const SymbolTable *table, uint32_t id, size_t *length) {
+    if (length) {
+        *length = table->lengths[id];
+    }
+    return table->names[id];
+}
+
+/**
+ * 释放符号表
+ * @param table 符号表
+ */
+void symbol_table_free(SymbolTable *table) {
+    free(table->names);
+    free(table->lengths);
+    free(table->hashes);
+    free(table->slots);
+    arena_free(&table->arena);
+    memset(table, 0, sizeof(SymbolTable));
+}
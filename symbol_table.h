@@ -0,0 +1,42 @@
+/**
+ * symbol_table.h - 符号表（字符串驻留）头文件
+ *
+ * 词法分析时把每个标识符和字符串常量的词素驻留到符号表中，
+ * 相同的词素得到相同的32位符号编号（从0开始连续分配），名字只保存一份。
+ * 后续阶段比较和散列名字时只需比较编号。
+ *
+ * 散列表为开放寻址、线性探测，槽位数为2的幂，装填因子不超过1/2；
+ * 名字复制到符号表自己的区域分配器中，以'\0'结尾，不依赖源代码缓冲区。
+ */
+
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "arena.h"
+
+#define SYMBOL_TABLE_MIN_SLOTS 256      // 首次驻留时的槽位数
+
+/* 符号表 */
+typedef struct {
+    const char **names;     // 符号编号 -> 名字（以'\0'结尾）
+    uint32_t *lengths;      // 符号编号 -> 名字长度
+    uint32_t *hashes;       // 符号编号 -> 名字的散列值（扩容时不必重新计算）
+    int count;              // 符号数量
+    int capacity;           // 上面三个数组的容量
+    uint32_t *slots;        // 散列槽：符号编号加1，0表示空槽
+    uint32_t num_slots;     // 槽位数（2的幂，尚未驻留任何名字时为0）
+    Arena arena;            // 名字所在的区域分配器
+} SymbolTable;
+
+/* 符号表函数 */
+void symbol_table_init(SymbolTable *table);
+uint32_t symbol_hash(const char *name, size_t length);
+uint32_t symbol_table_intern(SymbolTable *table, const char *name, size_t length);
+bool symbol_table_find(const SymbolTable *table, const char *name, size_t length, uint32_t *id);
+const char *symbol_table_name(const SymbolTable *table, uint32_t id, size_t *length);
+void symbol_table_free(SymbolTable *table);
+
+#endif /* SYMBOL_TABLE_H */
@@ -0,0 +1,203 @@
+/**
+ * tablegen.c - 静态表生成器
+ *
+ * 构建时使用：
+ * 1. 由scanner.c中的规则表构造最简DFA，输出c0_tables.h
+ * 2. 用大整数运算求出10的各次幂的128位近似值，输出power_tables.h
+ *    （浮点常量的快速转换使用，见number_parse.c）
+ * 3. 由同一最简DFA输出直接编码（goto）的扫描函数c0_direct.h
+ * 生成器本身不链接c0_tables.o、c0_direct.o和number_parse.o，因此不依赖于它所生成的文件。
+ *
+ * 使用方法：
+ *   ./tablegen <output_file>
+ *   ./tablegen --powers <output_file>
+ *   ./tablegen --direct <output_file>
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "scanner.h"
+
+#define POWER_MIN_EXP10 (-342)  // 表中10的最小次幂
+#define POWER_MAX_EXP10 308     // 表中10的最大次幂
+#define BIG_LIMBS 64            // 大整数的32位字数（2048位，足够容纳2^1720）
+
+/* 无符号大整数：低位在前 */
+typedef struct {
+    uint32_t limb[BIG_LIMBS];
+} BigNum;
+
+static void big_set(BigNum *x, uint32_t value) {
+    memset(x, 0, sizeof(BigNum));
+    x->limb[0] = value;
+}
+
+static void big_mul_small(BigNum *x, uint32_t factor) {
+    uint64_t carry = 0;
+    for (int i = 0; i < BIG_LIMBS; i++) {
+        uint64_t product = (uint64_t)x->limb[i] * factor + carry;
+        x->limb[i] = (uint32_t)product;
+        carry = product >> 32;
+    }
+}
+
+static void big_add_small(BigNum *x, uint32_t addend) {
+    uint64_t carry = addend;
+    for (int i = 0; i < BIG_LIMBS && carry; i++) {
+        uint64_t sum = (uint64_t)x->limb[i] + carry;
+        x->limb[i] = (uint32_t)sum;
+        carry = sum >> 32;
+    }
+}
+
+static int big_bits(const BigNum *x) {
+    for (int i = BIG_LIMBS - 1; i >= 0; i--) {
+        if (x->limb[i]) {
+            int bits = 32;
+            while (!(x->limb[i] >> (bits - 1))) bits--;
+            return i * 32 + bits;
+        }
+    }
+    return 0;
+}
+
+static int big_bit(const BigNum *x, int bit) {
+    if (bit < 0 || bit >= BIG_LIMBS * 32) return 0;
+    return (x->limb[bit / 32] >> (bit % 32)) & 1;
+}
+
+static int big_compare(const BigNum *a, const BigNum *b) {
+    for (int i = BIG_LIMBS - 1; i >= 0; i--) {
+        if (a->limb[i] != b->limb[i]) {
+            return a->limb[i] < b->limb[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+static void big_sub(BigNum *a, const BigNum *b) {
+    int64_t borrow = 0;
+    for (int i = 0; i < BIG_LIMBS; i++) {
+        int64_t diff = (int64_t)a->limb[i] - b->limb[i] - borrow;
+        borrow = diff < 0;
+        a->limb[i] = (uint32_t)(diff + (borrow << 32));
+    }
+}
+
+/* 左移一位，最低位补bit */
+static void big_shift_in(BigNum *x, int bit) {
+    uint32_t carry = (uint32_t)bit;
+    for (int i = 0; i < BIG_LIMBS; i++) {
+        uint32_t next = x->limb[i] >> 31;
+        x->limb[i] = (x->limb[i] << 1) | carry;
+        carry = next;
+    }
+}
+
+/* 取从第low位起的64位（超出范围的位为0） */
+static uint64_t big_extract(const BigNum *x, int low) {
+    uint64_t value = 0;
+    for (int i = 63; i >= 0; i--) {
+        value = (value << 1) | (uint64_t)big_bit(x, low + i);
+    }
+    return value;
+}
+
+/**
+ * 求10^exp10的128位尾数（最高位为1）
+ * 非负次幂为5^q截断的最高128位；负次幂为2^b / 5^-q向下取整后加1，
+ * 再截断到128位（与Eisel-Lemire算法要求的舍入方向一致）
+ * @param exp10 10的次幂
+ * @param hi 输出：高64位
+ * @param lo 输出：低64位
+ */
+static void power_of_ten(int exp10, uint64_t *hi, uint64_t *lo) {
+    BigNum power;
+    big_set(&power, 1);
+    int q = exp10 < 0 ? -exp10 : exp10;
+    for (int i = 0; i < q; i++) {
+        big_mul_small(&power, 5);
+    }
+    
+    BigNum value;
+    if (exp10 >= 0) {
+        value = power;
+    } else {
+        // 2^b / 5^q：逐位长除法
+        int z = big_bits(&power);
+        int b = (exp10 >= -27) ? z + 127 : 2 * z + 128;
+        BigNum remainder;
+        big_set(&remainder, 0);
+        big_set(&value, 0);
+        for (int bit = b; bit >= 0; bit--) {
+            big_shift_in(&remainder, bit == b);
+            big_shift_in(&value, 0);
+            if (big_compare(&remainder, &power) >= 0) {
+                big_sub(&remainder, &power);
+                value.limb[0] |= 1;
+            }
+        }
+        big_add_small(&value, 1);
+    }
+    
+    int bits = big_bits(&value);
+    *hi = big_extract(&value, bits - 64);
+    *lo = big_extract(&value, bits - 128);
+}
+
+/**
+ * 输出10的各次幂的128位尾数表
+ * @param filename 输出文件名
+ * @return 是否成功
+ */
+static bool emit_power_table(const char *filename) {
+    FILE *out = fopen(filename, "w");
+    if (!out) {
+        fprintf(stderr, "错误: 无法创建文件 '%s'\n", filename);
+        return false;
+    }
+    
+    int count = POWER_MAX_EXP10 - POWER_MIN_EXP10 + 1;
+    fprintf(out, "/**\n");
+    fprintf(out, " * 预生成的10的幂表：10^%d到10^%d的128位尾数（最高位为1），共 %d 项\n",
+            POWER_MIN_EXP10, POWER_MAX_EXP10, count);
+    fprintf(out, " *\n");
+    fprintf(out, " * 由 tablegen --powers 自动生成，请勿手工修改\n");
+    fprintf(out, " */\n\n");
+    fprintf(out, "#ifndef POWER_TABLES_H\n#define POWER_TABLES_H\n\n");
+    fprintf(out, "#include <stdint.h>\n\n");
+    fprintf(out, "#define POWER_TABLE_MIN_EXP10 (%d)\n", POWER_MIN_EXP10);
+    fprintf(out, "#define POWER_TABLE_MAX_EXP10 %d\n\n", POWER_MAX_EXP10);
+    fprintf(out, "static const uint64_t power_table[%d][2] = {\n", count);
+    for (int exp10 = POWER_MIN_EXP10; exp10 <= POWER_MAX_EXP10; exp10++) {
+        uint64_t hi, lo;
+        power_of_ten(exp10, &hi, &lo);
+        fprintf(out, "    {0x%016llXULL, 0x%016llXULL}, // 1e%d\n",
+                (unsigned long long)hi, (unsigned long long)lo, exp10);
+    }
+    fprintf(out, "};\n\n");
+    fprintf(out, "#endif /* POWER_TABLES_H */\n");
+    
+    bool ok = !ferror(out);
+    if (fclose(out) != 0 || !ok) {
+        fprintf(stderr, "错误: 写入文件 '%s' 失败\n", filename);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc == 3 && strcmp(argv[1], "--powers") == 0) {
+        return emit_power_table(argv[2]) ? 0 : 1;
+    }
+    if (argc == 3 && strcmp(argv[1], "--direct") == 0) {
+        return emit_c0_direct_scanner(argv[2]) ? 0 : 1;
+    }
+    if (argc != 2) {
+        fprintf(stderr, "使用方法: %s [--powers | --direct] <output_file>\n", argv[0]);
+        return 1;
+    }
+    
+    return emit_c0_scan_table(argv[1]) ? 0 : 1;
+}
@@ -1,46 +1,61 @@
 /**
  * token.c - Token操作函数实现
  * 
- * 实现Token的创建、销毁和辅助函数
+ * 实现Token的创建和辅助函数
  */
 
-#define _POSIX_C_SOURCE 200809L
 #include "token.h"
 
 /**
  * 创建一个新的Token
+ * 词素不复制，Token只记录其地址和长度
+ * @param arena Token所在的区域分配器
  * @param type Token类型
- * @param lexeme Token的词素(原始字符串)
- * @param line 行号
- * @param column 列号
- * @return 新创建的Token指针
+ * @param lexeme 词素起始地址（源代码中的位置或静态字符串，无需以'\0'结尾）
+ * @param length 词素长度
+ * @param offset Token在源代码中的字节偏移
+ * @return 新创建的Token指针（随区域一起释放）
  */
-Token *create_token(TokenType type, const char *lexeme, int line, int column) {
-    Token *token = (Token *)malloc(sizeof(Token));
-    if (!token) {
-        fprintf(stderr, "内存分配失败: create_token\n");
-        exit(1);
-    }
+Token *create_token(Arena *arena, TokenType type, const char *lexeme, size_t length,
+                    size_t offset) {
+    Token *token = (Token *)arena_alloc(arena, sizeof(Token));
     
     token->type = type;
-    token->lexeme = strdup(lexeme);
-    token->line = line;
-    token->column = column;
+    token->offset = (uint32_t)offset;
+    token->lexeme = lexeme;
+    token->length = length;
     
     return token;
 }
 
 /**
- * 释放Token占用的内存
- * @param token 要释放的Token指针
+ * 创建一个词法错误Token，错误信息被复制到区域中
+ * @param arena Token所在的区域分配器
+ * @param message 错误信息
+ * @param offset 出错位置在源代码中的字节偏移
+ * @return 新创建的Token指针（随区域一起释放）
  */
-void free_token(Token *token) {
-    if (token) {
-        if (token->lexeme) {
-            free(token->lexeme);
-        }
-        free(token);
+Token *create_error_token(Arena *arena, const char *message, size_t offset) {
+    size_t length = strlen(message);
+    return create_token(arena, TOKEN_ERROR, arena_strndup(arena, message, length),
+                        length, offset);
+}
+
+/**
+ * 按需生成Token词素的独立字符串
+ * @param token Token指针
+ * @return 以'\0'结尾的词素副本（需要调用者释放）
+ */
+char *token_lexeme_string(const Token *token) {
+    char *text = (char *)malloc(token->length + 1);
+    if (!text) {
+        fprintf(stderr, "内存分配失败: token_lexeme_string\n");
+        exit(1);
     }
+    
+    memcpy(text, token->lexeme, token->length);
+    text[token->length] = '\0';
+    return text;
 }
 
 /**
@@ -97,16 +112,54 @@ const char *token_type_to_string(TokenType type) {
     }
 }
 
+/* 关键字完美散列表的槽 */
+typedef struct {
+    const char *keyword;
+    size_t length;
+    TokenType type;
+} KeywordSlot;
+
+/*
+ * 关键字完美散列表：散列函数 (长度 + 首字符 + 末字符) & 31 对token.h中
+ * keywords[]的13个关键字两两不同，每个关键字独占一个槽，空槽的keyword为NULL。
+ * 增删关键字时需要重新核对各关键字的散列值没有冲突。
+ */
+#define KEYWORD_HASH(str, length) \
+    (((length) + (unsigned char)(str)[0] + (unsigned char)(str)[(length) - 1]) & 31)
+#define KEYWORD_MIN_LENGTH 2
+#define KEYWORD_MAX_LENGTH 8
+
+static const KeywordSlot keyword_slots[32] = {
+    [0]  = {"int", 3, TOKEN_INT},
+    [1]  = {"while", 5, TOKEN_WHILE},
+    [6]  = {"return", 6, TOKEN_RETURN},
+    [13] = {"struct", 6, TOKEN_STRUCT},
+    [14] = {"else", 4, TOKEN_ELSE},
+    [15] = {"double", 6, TOKEN_DOUBLE},
+    [16] = {"continue", 8, TOKEN_CONTINUE},
+    [17] = {"if", 2, TOKEN_IF},
+    [18] = {"break", 5, TOKEN_BREAK},
+    [25] = {"char", 4, TOKEN_CHAR},
+    [27] = {"for", 3, TOKEN_FOR},
+    [28] = {"const", 5, TOKEN_CONST},
+    [30] = {"void", 4, TOKEN_VOID},
+};
+
 /**
  * 查找关键字
- * @param str 要查找的字符串
+ * 直接在源代码中的词素上计算完美散列，最多比较一个候选关键字
+ * @param str 要查找的字符串（无需以'\0'结尾）
+ * @param length 字符串长度
  * @return 如果是关键字，返回对应的TokenType，否则返回TOKEN_IDENTIFIER
  */
-TokenType lookup_keyword(const char *str) {
-    for (int i = 0; keywords[i].keyword != NULL; i++) {
-        if (strcmp(str, keywords[i].keyword) == 0) {
-            return keywords[i].type;
-        }
+TokenType lookup_keyword(const char *str, size_t length) {
+    if (length < KEYWORD_MIN_LENGTH || length > KEYWORD_MAX_LENGTH) {
+        return TOKEN_IDENTIFIER;
+    }
+    
+    const KeywordSlot *slot = &keyword_slots[KEYWORD_HASH(str, length)];
+    if (slot->length == length && memcmp(str, slot->keyword, length) == 0) {
+        return slot->type;
     }
     return TOKEN_IDENTIFIER;
 }
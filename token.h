@@ -11,6 +11,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdint.h>
+#include "arena.h"
 
 /* Token类型枚举 - 定义所有可能的Token类型 */
 typedef enum {
@@ -68,19 +70,27 @@ typedef enum {
     TOKEN_ERROR       // 词法错误
 } TokenType;
 
-/* Token结构 - 存储单个Token的信息 */
+/* 常量值 - 整型、浮点和字符常量的值，标识符和字符串常量的符号编号 */
+typedef union {
+    long long int_value;    // 整型常量值
+    double double_value;    // 浮点常量值
+    char char_value;        // 字符常量值
+    uint32_t symbol_id;     // 符号编号（标识符和字符串常量，见symbol_table.h）
+} TokenValue;
+
+/* Token结构 - 存储单个Token的信息
+ * 词素不复制：lexeme指向源代码缓冲区中的词素（运算符、关键字等固定词素
+ * 可指向静态字符串），不以'\0'结尾，长度由length给出。因此源代码缓冲区
+ * 必须比Token存活更久；需要独立字符串时调用token_lexeme_string。
+ * Token只记录词素在源代码中的字节偏移，行号和列号由行号索引按需计算。
+ * Token本身从区域分配器中分配，随区域一起释放。 */
 typedef struct {
     TokenType type;      // Token类型
-    char *lexeme;        // Token的词素(原始字符串)
-    int line;            // Token所在行号
-    int column;          // Token所在列号
+    uint32_t offset;     // Token在源代码中的字节偏移（source_file_open拒绝超过4GB的源文件）
+    const char *lexeme;  // Token的词素起始地址（不以'\0'结尾）
+    size_t length;       // 词素长度
     
-    /* 存储常量值的联合体 */
-    union {
-        long long int_value;    // 整型常量值
-        double double_value;    // 浮点常量值
-        char char_value;        // 字符常量值
-    } value;
+    TokenValue value;    // 常量值（常量Token）或符号编号（标识符和字符串常量）
 } Token;
 
 /* 关键字表 - 用于查找关键字 */
@@ -108,9 +118,11 @@ static const KeywordEntry keywords[] = {
 };
 
 /* Token操作函数声明 */
-Token *create_token(TokenType type, const char *lexeme, int line, int column);
-void free_token(Token *token);
+Token *create_token(Arena *arena, TokenType type, const char *lexeme, size_t length,
+                    size_t offset);
+Token *create_error_token(Arena *arena, const char *message, size_t offset);
+char *token_lexeme_string(const Token *token);
 const char *token_type_to_string(TokenType type);
-TokenType lookup_keyword(const char *str);
+TokenType lookup_keyword(const char *str, size_t length);
 
 #endif /* TOKEN_H */
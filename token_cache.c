@@ -0,0 +1,555 @@
+/**
+ * token_cache.c - Token流缓存实现
+ *
+ * 缓存文件为"<缓存目录>/<散列值的16位十六进制>.tok"，先写入临时文件再改名，
+ * 并发运行的进程不会读到写了一半的缓存。文件头中的任何一项不符都视为未命中。
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "token_cache.h"
+#include "scanner.h"
+
+#define CACHE_PATH_SIZE 4096    // 缓存文件路径的最大长度
+#define CACHE_SECTIONS 13       // 文件头之后的段数加1（最后一项为文件总大小）
+
+/* 散列函数使用的乘数（取自xxHash64的素数） */
+#define HASH_PRIME1 0x9E3779B185EBCA87ULL
+#define HASH_PRIME2 0xC2B2AE3D27D4EB4FULL
+#define HASH_PRIME3 0x165667B19E3779F9ULL
+#define HASH_PRIME4 0x85EBCA77C2B2AE63ULL
+#define HASH_PRIME5 0x27D4EB2F165667C5ULL
+
+/**
+ * 循环左移
+ */
+static uint64_t rotate_left(uint64_t x, int bits) {
+    return (x << bits) | (x >> (64 - bits));
+}
+
+/**
+ * 读取8字节（按本机字节序，不要求对齐）
+ */
+static uint64_t load64(const char *p) {
+    uint64_t x;
+    memcpy(&x, p, sizeof(x));
+    return x;
+}
+
+/**
+ * 将一个8字节字并入累加器
+ */
+static uint64_t hash_round(uint64_t acc, uint64_t input) {
+    acc += input * HASH_PRIME2;
+    acc = rotate_left(acc, 31);
+    return acc * HASH_PRIME1;
+}
+
+/**
+ * 计算源代码的64位散列值（xxHash64式的四路累加，每次处理32字节）
+ * 结果按本机字节序计算，仅用于本机缓存的键，不作为持久的内容标识
+ * @param data 数据
+ * @param length 数据长度
+ * @return 散列值
+ */
+uint64_t token_cache_hash(const char *data, size_t length) {
+    const char *p = data;
+    const char *end = data + length;
+    uint64_t h;
+    
+    if (length >= 32) {
+        uint64_t v1 = HASH_PRIME1 + HASH_PRIME2;
+        uint64_t v2 = HASH_PRIME2;
+        uint64_t v3 = 0;
+        uint64_t v4 = 0 - HASH_PRIME1;
+        while (end - p >= 32) {
+            v1 = hash_round(v1, load64(p));
+            v2 = hash_round(v2, load64(p + 8));
+            v3 = hash_round(v3, load64(p + 16));
+            v4 = hash_round(v4, load64(p + 24));
+            p += 32;
+        }
+        h = rotate_left(v1, 1) + rotate_left(v2, 7) + rotate_left(v3, 12) + rotate_left(v4, 18);
+        h = (h ^ hash_round(0, v1)) * HASH_PRIME1 + HASH_PRIME4;
+        h = (h ^ hash_round(0, v2)) * HASH_PRIME1 + HASH_PRIME4;
+        h = (h ^ hash_round(0, v3)) * HASH_PRIME1 + HASH_PRIME4;
+        h = (h ^ hash_round(0, v4)) * HASH_PRIME1 + HASH_PRIME4;
+    } else {
+        h = HASH_PRIME5;
+    }
+    h += (uint64_t)length;
+    
+    // 剩余不足32字节的部分
+    while (end - p >= 8) {
+        h ^= hash_round(0, load64(p));
+        h = rotate_left(h, 27) * HASH_PRIME1 + HASH_PRIME4;
+        p += 8;
+    }
+    while (p < end) {
+        h ^= (uint64_t)(unsigned char)*p * HASH_PRIME5;
+        h = rotate_left(h, 11) * HASH_PRIME1;
+        p++;
+    }
+    
+    // 最后的混合
+    h ^= h >> 33;
+    h *= HASH_PRIME2;
+    h ^= h >> 29;
+    h *= HASH_PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+/**
+ * 按8字节对齐
+ */
+static size_t align8(size_t size) {
+    return (size + 7) & ~(size_t)7;
+}
+
+/**
+ * 计算缓存文件中各段的位置
+ * @param header 文件头
+ * @param sections 输出：types、offsets、lengths、value_index、values、
+ *                 message_offsets、信息区、symbol_lengths、symbol_hashes、
+ *                 symbol_slots、symbol_offsets、名字区各段的起点，以及文件总大小
+ */
+static void cache_layout(const TokenCacheHeader *header, size_t sections[CACHE_SECTIONS]) {
+    size_t count = header->count;
+    size_t pos = align8(sizeof(TokenCacheHeader));
+    sections[0] = pos;
+    pos = align8(pos + count * sizeof(uint8_t));
+    sections[1] = pos;
+    pos = align8(pos + count * sizeof(uint32_t));
+    sections[2] = pos;
+    pos = align8(pos + count * sizeof(uint32_t));
+    sections[3] = pos;
+    pos = align8(pos + count * sizeof(int));
+    sections[4] = pos;
+    pos = align8(pos + (size_t)header->num_values * sizeof(TokenValue));
+    sections[5] = pos;
+    pos = align8(pos + (size_t)header->num_messages * sizeof(uint32_t));
+    sections[6] = pos;
+    pos = align8(pos + header->message_bytes);
+    sections[7] = pos;
+    pos = align8(pos + (size_t)header->num_symbols * sizeof(uint32_t));
+    sections[8] = pos;
+    pos = align8(pos + (size_t)header->num_symbols * sizeof(uint32_t));
+    sections[9] = pos;
+    pos = align8(pos + (size_t)header->num_slots * sizeof(uint32_t));
+    sections[10] = pos;
+    pos = align8(pos + (size_t)header->num_symbols * sizeof(uint32_t));
+    sections[11] = pos;
+    sections[12] = align8(pos + header->symbol_bytes);
+}
+
+/**
+ * 组成缓存文件路径
+ * @param path 输出：路径
+ * @param cache_dir 缓存目录
+ * @param hash 源代码散列值
+ * @return 路径是否未超长
+ */
+static bool cache_path(char path[CACHE_PATH_SIZE], const char *cache_dir, uint64_t hash) {
+    int n = snprintf(path, CACHE_PATH_SIZE, "%s/%016llx.tok", cache_dir, (unsigned long long)hash);
+    return n > 0 && n < CACHE_PATH_SIZE;
+}
+
+/**
+ * 把一段数据的散列值并入累加值
+ * @param h 累加值
+ * @param data 数据
+ * @param length 数据长度
+ * @return 新的累加值
+ */
+static uint64_t hash_combine(uint64_t h, const void *data, size_t length) {
+    h ^= token_cache_hash((const char *)data, length);
+    return rotate_left(h, 27) * HASH_PRIME1 + HASH_PRIME4;
+}
+
+/**
+ * 计算扫描表内容的散列值：等价类映射、转换表、终态和规则表
+ * 规则或自动机算法的任何改变都会改变生成的表，缓存随之失效
+ * @param table 扫描表
+ * @return 散列值
+ */
+static uint64_t scan_table_hash(const ScanTable *table) {
+    int header[4] = {table->num_classes, table->num_states, table->start_state, table->num_rules};
+    uint64_t h = hash_combine(0, header, sizeof(header));
+    h = hash_combine(h, table->class_map, sizeof(table->class_map));
+    h = hash_combine(h, table->next, (size_t)table->num_states * table->num_classes * sizeof(int));
+    h = hash_combine(h, table->accept, (size_t)table->num_states * sizeof(int));
+    for (int i = 0; i < table->num_rules; i++) {
+        const ScanRule *rule = &table->rules[i];
+        int fields[2] = {(int)rule->type, rule->skip};
+        h = hash_combine(h, fields, sizeof(fields));
+        h = hash_combine(h, rule->pattern, strlen(rule->pattern));
+        if (rule->lexeme) {
+            h = hash_combine(h, rule->lexeme, strlen(rule->lexeme) + 1);
+        }
+    }
+    return h;
+}
+
+/**
+ * 填写文件头中与源代码和扫描表有关的各项
+ */
+static void header_init(TokenCacheHeader *header, uint64_t hash, size_t length) {
+    const ScanTable *table = get_c0_scan_table();
+    memset(header, 0, sizeof(TokenCacheHeader));
+    memcpy(header->magic, TOKEN_CACHE_MAGIC, sizeof(header->magic));
+    header->version = TOKEN_CACHE_VERSION;
+    header->byte_order = TOKEN_CACHE_BYTE_ORDER;
+    header->source_hash = hash;
+    header->source_length = length;
+    header->table_states = (uint32_t)table->num_states;
+    header->table_classes = (uint32_t)table->num_classes;
+    header->table_hash = scan_table_hash(table);
+}
+
+/**
+ * 把以相对偏移保存的字符串换成指针表
+ * @param offsets 各字符串在字符串区中的偏移
+ * @param count 字符串数量
+ * @param text 字符串区（各字符串以'\0'结尾）
+ * @param text_bytes 字符串区字节数
+ * @return 指针表（count为0时为NULL），有偏移越界时返回NULL
+ */
+static const char **relocate_strings(const uint32_t *offsets, uint32_t count,
+                                     const char *text, uint32_t text_bytes) {
+    if (count == 0) {
+        return NULL;
+    }
+    const char **strings = (const char **)malloc(count * sizeof(const char *));
+    if (!strings) {
+        fprintf(stderr, "内存分配失败: token_cache_lookup\n");
+        exit(1);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (offsets[i] >= text_bytes) {
+            free(strings);
+            return NULL;
+        }
+        strings[i] = text + offsets[i];
+    }
+    return strings;
+}
+
+/**
+ * 检查缓存文件各段的内容，保证命中后按Token流访问不会越界：
+ * Token类型合法且以EOF结束，词素在参与分析的源代码之内，
+ * value_index按类型指向错误信息、符号或常量值，散列槽只含有效的符号编号，
+ * 符号名的长度与名字区中的'\0'一致
+ * @param header 文件头（各段大小已与文件大小核对）
+ * @param base 映射区
+ * @param sections 各段的起点（cache_layout）
+ * @return 内容是否有效
+ */
+static bool cache_body_valid(const TokenCacheHeader *header, const char *base,
+                             const size_t sections[CACHE_SECTIONS]) {
+    const uint8_t *types = (const uint8_t *)(base + sections[0]);
+    const uint32_t *offsets = (const uint32_t *)(base + sections[1]);
+    const uint32_t *lengths = (const uint32_t *)(base + sections[2]);
+    const int *value_index = (const int *)(base + sections[3]);
+    if (types[header->count - 1] != TOKEN_EOF) {
+        return false;
+    }
+    for (uint32_t i = 0; i < header->count; i++) {
+        int v = value_index[i];
+        if (types[i] > TOKEN_ERROR || offsets[i] > header->text_length ||
+            lengths[i] > header->text_length - offsets[i]) {
+            return false;
+        }
+        if (types[i] == TOKEN_ERROR) {
+            if (v < 0 || (uint32_t)v >= header->num_messages) {
+                return false;
+            }
+        } else if (types[i] == TOKEN_IDENTIFIER || types[i] == TOKEN_STRING_CONST) {
+            if (v < 0 || (uint32_t)v >= header->num_symbols) {
+                return false;
+            }
+        } else if (v < -1 || (v >= 0 && (uint32_t)v >= header->num_values)) {
+            return false;
+        }
+    }
+    
+    const uint32_t *slots = (const uint32_t *)(base + sections[9]);
+    for (uint32_t i = 0; i < header->num_slots; i++) {
+        if (slots[i] > header->num_symbols) {
+            return false;
+        }
+    }
+    
+    const uint32_t *symbol_lengths = (const uint32_t *)(base + sections[7]);
+    const uint32_t *symbol_offsets = (const uint32_t *)(base + sections[10]);
+    const char *symbol_text = base + sections[11];
+    for (uint32_t i = 0; i < header->num_symbols; i++) {
+        if (symbol_offsets[i] >= header->symbol_bytes ||
+            symbol_lengths[i] >= header->symbol_bytes - symbol_offsets[i] ||
+            symbol_text[symbol_offsets[i] + symbol_lengths[i]] != '\0') {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * 查找并映射源代码的Token流缓存
+ * 命中时Token流和符号表的各数组直接指向映射区，只有错误信息和符号名的指针表
+ * 以及换行索引另行分配
+ * @param cache_dir 缓存目录
+ * @param hash 源代码散列值（token_cache_hash）
+ * @param source 源代码（必须比缓存的Token流存活更久）
+ * @param length 源代码长度
+ * @param cached 输出：缓存的Token流（用token_cache_release释放）
+ * @return 是否命中
+ */
+bool token_cache_lookup(const char *cache_dir, uint64_t hash, const char *source, size_t length,
+                        CachedTokens *cached) {
+    char path[CACHE_PATH_SIZE];
+    if (!cache_path(path, cache_dir, hash)) {
+        return false;
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TokenCacheHeader)) {
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)st.st_size;
+    void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    
+    // 检查文件头：格式、源代码和扫描表都必须一致，文件大小必须与各段相符
+    const TokenCacheHeader *header = (const TokenCacheHeader *)data;
+    TokenCacheHeader expected;
+    header_init(&expected, hash, length);
+    size_t sections[CACHE_SECTIONS];
+    cache_layout(header, sections);
+    if (memcmp(header->magic, expected.magic, sizeof(header->magic)) != 0 ||
+        header->version != expected.version ||
+        header->byte_order != expected.byte_order ||
+        header->source_hash != expected.source_hash ||
+        header->source_length != expected.source_length ||
+        header->text_length > header->source_length ||
+        header->table_states != expected.table_states ||
+        header->table_classes != expected.table_classes ||
+        header->table_hash != expected.table_hash ||
+        header->count == 0 || header->count > INT32_MAX || header->num_values > INT32_MAX ||
+        header->num_messages > INT32_MAX || header->num_symbols > INT32_MAX ||
+        sections[CACHE_SECTIONS - 1] != size ||
+        (header->num_slots & (header->num_slots - 1)) != 0 ||
+        (uint64_t)header->num_symbols * 2 > header->num_slots) {
+        munmap(data, size);
+        return false;
+    }
+    
+    const char *base = (const char *)data;
+    const uint32_t *message_offsets = (const uint32_t *)(base + sections[5]);
+    const char *message_text = base + sections[6];
+    const uint32_t *symbol_offsets = (const uint32_t *)(base + sections[10]);
+    const char *symbol_text = base + sections[11];
+    if ((header->message_bytes > 0 && message_text[header->message_bytes - 1] != '\0') ||
+        (header->symbol_bytes > 0 && symbol_text[header->symbol_bytes - 1] != '\0') ||
+        !cache_body_valid(header, base, sections)) {
+        munmap(data, size);
+        return false;
+    }
+    
+    // 错误信息和符号名以相对偏移保存，换成指针表
+    const char **messages = relocate_strings(message_offsets, header->num_messages,
+                                             message_text, header->message_bytes);
+    const char **names = relocate_strings(symbol_offsets, header->num_symbols,
+                                          symbol_text, header->symbol_bytes);
+    if ((header->num_messages > 0 && !messages) || (header->num_symbols > 0 && !names)) {
+        free(messages);
+        free(names);
+        munmap(data, size);
+        return false;
+    }
+    
+    memset(cached, 0, sizeof(CachedTokens));
+    cached->data = data;
+    cached->size = size;
+    TokenStream *stream = &cached->stream;
+    stream->source = source;
+    stream->count = (int)header->count;
+    stream->capacity = stream->count;
+    stream->types = (uint8_t *)(base + sections[0]);
+    stream->offsets = (uint32_t *)(base + sections[1]);
+    stream->lengths = (uint32_t *)(base + sections[2]);
+    stream->value_index = (int *)(base + sections[3]);
+    stream->values = (TokenValue *)(base + sections[4]);
+    stream->num_values = (int)header->num_values;
+    stream->value_capacity = stream->num_values;
+    stream->messages = messages;
+    stream->num_messages = (int)header->num_messages;
+    stream->message_capacity = stream->num_messages;
+    arena_init(&stream->arena);
+    line_index_init(&stream->lines, source, (size_t)header->text_length);
+    
+    SymbolTable *symbols = &stream->symbols;
+    symbols->names = names;
+    symbols->lengths = (uint32_t *)(base + sections[7]);
+    symbols->hashes = (uint32_t *)(base + sections[8]);
+    symbols->count = (int)header->num_symbols;
+    symbols->capacity = symbols->count;
+    symbols->slots = (uint32_t *)(base + sections[9]);
+    symbols->num_slots = header->num_slots;
+    arena_init(&symbols->arena);
+    return true;
+}
+
+/**
+ * 写出一段数据并补齐到8字节对齐
+ * @return 是否写入成功
+ */
+static bool write_section(FILE *out, const void *data, size_t size) {
+    static const char padding[8] = {0};
+    if (size > 0 && fwrite(data, 1, size, out) != size) {
+        return false;
+    }
+    size_t pad = align8(size) - size;
+    return pad == 0 || fwrite(padding, 1, pad, out) == pad;
+}
+
+/**
+ * 计算字符串依次存放（每个以'\0'结尾）时各自的偏移
+ * @param strings 字符串
+ * @param count 字符串数量
+ * @param bytes 输出：总字节数
+ * @return 偏移数组（count为0时为NULL）
+ */
+static uint32_t *string_offsets(const char *const *strings, int count, uint32_t *bytes) {
+    uint32_t *offsets = NULL;
+    if (count > 0) {
+        offsets = (uint32_t *)malloc(count * sizeof(uint32_t));
+        if (!offsets) {
+            fprintf(stderr, "内存分配失败: token_cache_store\n");
+            exit(1);
+        }
+    }
+    size_t total = 0;
+    for (int i = 0; i < count; i++) {
+        offsets[i] = (uint32_t)total;
+        total += strlen(strings[i]) + 1;
+    }
+    *bytes = (uint32_t)total;
+    return offsets;
+}
+
+/**
+ * 依次写出字符串（每个以'\0'结尾），再补齐到8字节对齐
+ * @return 是否写入成功
+ */
+static bool write_strings(FILE *out, const char *const *strings, int count, uint32_t bytes) {
+    for (int i = 0; i < count; i++) {
+        size_t size = strlen(strings[i]) + 1;
+        if (fwrite(strings[i], 1, size, out) != size) {
+            return false;
+        }
+    }
+    static const char padding[8] = {0};
+    size_t pad = align8(bytes) - bytes;
+    return pad == 0 || fwrite(padding, 1, pad, out) == pad;
+}
+
+/**
+ * 将Token流写入缓存（缓存目录不存在时创建）
+ * 写入失败不影响分析结果，只是下次仍需重新分析
+ * @param cache_dir 缓存目录
+ * @param hash 源代码散列值（token_cache_hash）
+ * @param length 源代码长度
+ * @param stream 由lex_all得到的Token流（延迟转换数值常量的Token流不写入）
+ * @return 是否写入成功
+ */
+bool token_cache_store(const char *cache_dir, uint64_t hash, size_t length,
+                       const TokenStream *stream) {
+    if (stream->deferred_values) {
+        return false;       // 缓存中的数值常量一律带有值
+    }
+    char path[CACHE_PATH_SIZE];
+    char temp_path[CACHE_PATH_SIZE];
+    if (!cache_path(path, cache_dir, hash)) {
+        return false;
+    }
+    int n = snprintf(temp_path, CACHE_PATH_SIZE, "%s.%ld.tmp", path, (long)getpid());
+    if (n <= 0 || n >= CACHE_PATH_SIZE) {
+        return false;
+    }
+    if (mkdir(cache_dir, 0777) != 0 && errno != EEXIST) {
+        return false;
+    }
+    
+    // 错误信息和符号名分别依次存放，每个以'\0'结尾
+    const SymbolTable *symbols = &stream->symbols;
+    TokenCacheHeader header;
+    header_init(&header, hash, length);
+    header.text_length = stream->lines.length;
+    header.count = (uint32_t)stream->count;
+    header.num_values = (uint32_t)stream->num_values;
+    header.num_messages = (uint32_t)stream->num_messages;
+    header.num_symbols = (uint32_t)symbols->count;
+    header.num_slots = symbols->num_slots;
+    uint32_t *message_offsets = string_offsets(stream->messages, stream->num_messages,
+                                               &header.message_bytes);
+    uint32_t *symbol_offsets = string_offsets(symbols->names, symbols->count,
+                                              &header.symbol_bytes);
+    
+    FILE *out = fopen(temp_path, "wb");
+    bool ok = out != NULL;
+    size_t count = (size_t)stream->count;
+    size_t num_symbols = (size_t)symbols->count;
+    ok = ok && write_section(out, &header, sizeof(header)) &&
+         write_section(out, stream->types, count * sizeof(uint8_t)) &&
+         write_section(out, stream->offsets, count * sizeof(uint32_t)) &&
+         write_section(out, stream->lengths, count * sizeof(uint32_t)) &&
+         write_section(out, stream->value_index, count * sizeof(int)) &&
+         write_section(out, stream->values, (size_t)stream->num_values * sizeof(TokenValue)) &&
+         write_section(out, message_offsets, (size_t)stream->num_messages * sizeof(uint32_t)) &&
+         write_strings(out, stream->messages, stream->num_messages, header.message_bytes) &&
+         write_section(out, symbols->lengths, num_symbols * sizeof(uint32_t)) &&
+         write_section(out, symbols->hashes, num_symbols * sizeof(uint32_t)) &&
+         write_section(out, symbols->slots, (size_t)symbols->num_slots * sizeof(uint32_t)) &&
+         write_section(out, symbol_offsets, num_symbols * sizeof(uint32_t)) &&
+         write_strings(out, symbols->names, symbols->count, header.symbol_bytes);
+    free(message_offsets);
+    free(symbol_offsets);
+    
+    if (out && fclose(out) != 0) {
+        ok = false;
+    }
+    if (ok && rename(temp_path, path) != 0) {
+        ok = false;
+    }
+    if (!ok && out) {
+        remove(temp_path);
+    }
+    return ok;
+}
+
+/**
+ * 释放缓存的Token流：解除映射，释放错误信息和符号名的指针表以及换行索引
+ * @param cached 缓存的Token流
+ */
+void token_cache_release(CachedTokens *cached) {
+    free(cached->stream.messages);
+    free(cached->stream.symbols.names);
+    line_index_free(&cached->stream.lines);
+    munmap(cached->data, cached->size);
+    memset(cached, 0, sizeof(CachedTokens));
+}
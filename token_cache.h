@@ -0,0 +1,70 @@
+/**
+ * token_cache.h - Token流缓存头文件
+ *
+ * 把lex_all得到的Token流（按列存放的各数组）按原样写入缓存文件，
+ * 文件名由源代码内容的64位散列值决定。源文件未改变时直接映射缓存文件，
+ * Token流的各数组指向映射区，不再重新分析：一次散列加一次映射。
+ *
+ * 缓存文件格式（本机字节序，各段按8字节对齐）：
+ *   文件头 TokenCacheHeader
+ *   types[count]（u8）  offsets[count]（u32）  lengths[count]（u32）
+ *   value_index[count]（i32）  values[num_values]（TokenValue）
+ *   message_offsets[num_messages]（u32，相对于信息区）  信息区（以'\0'结尾的错误信息）
+ *   symbol_lengths[num_symbols]（u32）  symbol_hashes[num_symbols]（u32）
+ *   symbol_slots[num_slots]（u32）  symbol_offsets[num_symbols]（u32，相对于名字区）
+ *   名字区（以'\0'结尾的符号名）
+ * 符号表的散列槽原样保存，命中时只需重建名字指针表。
+ * 映射后先检查各段的内容（类型、下标、偏移都在范围之内），任何一项不符都视为未命中，
+ * 损坏或被改动的缓存文件不会导致越界访问。
+ */
+
+#ifndef TOKEN_CACHE_H
+#define TOKEN_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "lexer.h"
+
+#define TOKEN_CACHE_MAGIC "C0TKCACH"    // 文件头魔数
+#define TOKEN_CACHE_VERSION 3           // 格式或手写扫描改变时递增（扫描表的改变由table_hash检测）
+#define TOKEN_CACHE_BYTE_ORDER 0x01020304u // 按本机字节序写入，用于检测字节序不同的缓存
+
+/* 缓存文件头 */
+typedef struct {
+    char magic[8];          // TOKEN_CACHE_MAGIC
+    uint32_t version;       // TOKEN_CACHE_VERSION
+    uint32_t byte_order;    // TOKEN_CACHE_BYTE_ORDER
+    uint64_t source_hash;   // 源代码散列值
+    uint64_t source_length; // 源代码长度
+    uint64_t text_length;   // 参与分析的长度（源代码在第一个'\0'处结束）
+    uint64_t table_hash;    // 生成缓存时扫描表内容（转换、终态和规则表）的散列值
+    uint32_t table_states;  // 生成缓存时扫描表的状态数（扫描表改变则缓存失效）
+    uint32_t table_classes; // 生成缓存时扫描表的等价类数
+    uint32_t count;         // Token数量（包括EOF）
+    uint32_t num_values;    // 常量值数量
+    uint32_t num_messages;  // 错误信息数量
+    uint32_t message_bytes; // 信息区字节数
+    uint32_t num_symbols;   // 符号数量
+    uint32_t num_slots;     // 符号表散列槽数量
+    uint32_t symbol_bytes;  // 名字区字节数
+    uint32_t reserved;      // 保留（0），使文件头为8字节的倍数
+} TokenCacheHeader;
+
+/* 从缓存映射得到的Token流 */
+typedef struct {
+    void *data;             // 映射区
+    size_t size;            // 映射区大小
+    TokenStream stream;     // 各数组指向映射区的Token流（只读，不能用free_token_stream释放，
+                            // 其符号表只能查找，不能驻留新名字）
+} CachedTokens;
+
+/* Token流缓存函数 */
+uint64_t token_cache_hash(const char *data, size_t length);
+bool token_cache_lookup(const char *cache_dir, uint64_t hash, const char *source, size_t length,
+                        CachedTokens *cached);
+bool token_cache_store(const char *cache_dir, uint64_t hash, size_t length,
+                       const TokenStream *stream);
+void token_cache_release(CachedTokens *cached);
+
+#endif /* TOKEN_CACHE_H */
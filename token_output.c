@@ -0,0 +1,348 @@
+/**
+ * token_output.c - 机器可读的Token输出实现
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "token_output.h"
+
+/**
+ * 解析输出格式名
+ * @param name 格式名（text、tsv、jsonl、binary）
+ * @param format 输出：输出格式
+ * @return 是否为已知格式
+ */
+bool parse_output_format(const char *name, OutputFormat *format) {
+    if (strcmp(name, "text") == 0) {
+        *format = OUTPUT_TEXT;
+    } else if (strcmp(name, "tsv") == 0) {
+        *format = OUTPUT_TSV;
+    } else if (strcmp(name, "jsonl") == 0) {
+        *format = OUTPUT_JSONL;
+    } else if (strcmp(name, "binary") == 0) {
+        *format = OUTPUT_BINARY;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 初始化Token写出器，二进制格式先写出文件头，TSV格式先写出列名
+ * @param writer Token写出器
+ * @param out 输出流
+ * @param format 输出格式（不能为OUTPUT_TEXT）
+ */
+void token_writer_init(TokenWriter *writer, FILE *out, OutputFormat format) {
+    writer->out = out;
+    writer->format = format;
+    writer->used = 0;
+    writer->buffer = (char *)malloc(TOKEN_WRITER_BUFFER_SIZE);
+    if (!writer->buffer) {
+        fprintf(stderr, "内存分配失败: token_writer_init\n");
+        exit(1);
+    }
+    
+    if (format == OUTPUT_BINARY) {
+        memcpy(writer->buffer, "C0TOKEN\1", 8);
+        writer->used = 8;
+    } else if (format == OUTPUT_TSV) {
+        static const char header[] = "type\tline\tcolumn\toffset\tlength\tlexeme\tvalue\n";
+        memcpy(writer->buffer, header, sizeof(header) - 1);
+        writer->used = sizeof(header) - 1;
+    }
+}
+
+/**
+ * 写出缓冲区中的全部数据
+ * @param writer Token写出器
+ */
+void token_writer_flush(TokenWriter *writer) {
+    if (writer->used > 0) {
+        fwrite(writer->buffer, 1, writer->used, writer->out);
+        writer->used = 0;
+    }
+    fflush(writer->out);
+}
+
+/**
+ * 确保缓冲区中至少还有size字节空间（size不超过缓冲区大小）
+ * @param writer Token写出器
+ * @param size 所需字节数
+ */
+static void ensure_space(TokenWriter *writer, size_t size) {
+    if (writer->used + size > TOKEN_WRITER_BUFFER_SIZE) {
+        fwrite(writer->buffer, 1, writer->used, writer->out);
+        writer->used = 0;
+    }
+}
+
+/**
+ * 追加一段字节（可以比缓冲区大）
+ * @param writer Token写出器
+ * @param data 数据
+ * @param size 字节数
+ */
+static void put_bytes(TokenWriter *writer, const char *data, size_t size) {
+    if (size > TOKEN_WRITER_BUFFER_SIZE / 2) {
+        token_writer_flush(writer);
+        fwrite(data, 1, size, writer->out);
+        return;
+    }
+    ensure_space(writer, size);
+    memcpy(writer->buffer + writer->used, data, size);
+    writer->used += size;
+}
+
+/**
+ * 追加一个字节（调用者已确保空间）
+ * @param writer Token写出器
+ * @param c 字节
+ */
+static void put_char(TokenWriter *writer, char c) {
+    writer->buffer[writer->used++] = c;
+}
+
+/**
+ * 追加十进制整数，之后至少还留有一个字节的空间（用于分隔符）
+ * 从低位向高位写入临时区，再逆序复制
+ * @param writer Token写出器
+ * @param value 整数
+ */
+static void put_int(TokenWriter *writer, long long value) {
+    ensure_space(writer, 24);
+    char digits[20];
+    int n = 0;
+    unsigned long long v = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    do {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v > 0);
+    if (value < 0) {
+        put_char(writer, '-');
+    }
+    while (n > 0) {
+        put_char(writer, digits[--n]);
+    }
+}
+
+/**
+ * 追加常量值的文本形式（没有值的Token不输出任何内容）
+ * 浮点数使用%.17g以便精确还原；JSON没有无穷大，溢出的浮点常量写成null
+ * @param writer Token写出器
+ * @param token Token
+ * @param json 是否为JSON格式
+ */
+static void put_value(TokenWriter *writer, const Token *token, bool json) {
+    ensure_space(writer, 32);
+    if (token->type == TOKEN_INT_CONST) {
+        put_int(writer, token->value.int_value);
+    } else if (token->type == TOKEN_CHAR_CONST) {
+        put_int(writer, (unsigned char)token->value.char_value);
+    } else if (token->type == TOKEN_DOUBLE_CONST && json && !isfinite(token->value.double_value)) {
+        put_bytes(writer, "null", 4);
+    } else if (token->type == TOKEN_DOUBLE_CONST) {
+        writer->used += snprintf(writer->buffer + writer->used, 32, "%.17g",
+                                 token->value.double_value);
+    }
+}
+
+/**
+ * 求text起的合法UTF-8编码序列的长度
+ * 拒绝过长编码、代理区（U+D800到U+DFFF）和超过U+10FFFF的码点
+ * @param text 序列的首字节（不小于0x80）
+ * @param length text之后剩余的字节数
+ * @return 序列长度，不是合法序列时返回0
+ */
+static size_t utf8_sequence_length(const unsigned char *text, size_t length) {
+    unsigned char c = text[0];
+    size_t n;
+    unsigned char lo = 0x80, hi = 0xbf;     // 第二个字节的范围
+    if (c >= 0xc2 && c <= 0xdf) {
+        n = 2;
+    } else if (c >= 0xe0 && c <= 0xef) {
+        n = 3;
+        if (c == 0xe0) lo = 0xa0;
+        if (c == 0xed) hi = 0x9f;
+    } else if (c >= 0xf0 && c <= 0xf4) {
+        n = 4;
+        if (c == 0xf0) lo = 0x90;
+        if (c == 0xf4) hi = 0x8f;
+    } else {
+        return 0;
+    }
+    if (n > length || text[1] < lo || text[1] > hi) {
+        return 0;
+    }
+    for (size_t i = 2; i < n; i++) {
+        if ((text[i] & 0xc0) != 0x80) {
+            return 0;
+        }
+    }
+    return n;
+}
+
+/**
+ * 追加转义后的词素
+ * 连续的普通字节整段复制，只有需要转义的字节单独处理。
+ * JSON格式下合法的UTF-8序列原样复制，不属于合法序列的字节写成\u00XX，
+ * 每一行因而都是合法的UTF-8和JSON。
+ * @param writer Token写出器
+ * @param text 词素
+ * @param length 词素长度
+ * @param json 是否按JSON字符串转义（否则按TSV转义）
+ */
+static void put_escaped(TokenWriter *writer, const char *text, size_t length, bool json) {
+    static const char hex[] = "0123456789abcdef";
+    size_t run = 0;
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (json && c >= 0x80) {
+            size_t n = utf8_sequence_length((const unsigned char *)text + i, length - i);
+            if (n > 0) {
+                i += n - 1;
+                continue;
+            }
+        }
+        bool special = c < 0x20 || c == '\\' || c == 0x7f || (json && (c == '"' || c >= 0x80));
+        if (!special) {
+            continue;
+        }
+        put_bytes(writer, text + run, i - run);
+        run = i + 1;
+        
+        ensure_space(writer, 6);
+        put_char(writer, '\\');
+        switch (c) {
+            case '\\': put_char(writer, '\\'); break;
+            case '"':  put_char(writer, '"'); break;
+            case '\t': put_char(writer, 't'); break;
+            case '\n': put_char(writer, 'n'); break;
+            case '\r': put_char(writer, 'r'); break;
+            default:
+                // JSON的控制字符和非法的UTF-8字节写成\u00XX；TSV使用\xXX
+                if (json) {
+                    put_char(writer, 'u');
+                    put_char(writer, '0');
+                    put_char(writer, '0');
+                } else {
+                    put_char(writer, 'x');
+                }
+                put_char(writer, hex[c >> 4]);
+                put_char(writer, hex[c & 15]);
+                break;
+        }
+    }
+    put_bytes(writer, text + run, length - run);
+}
+
+/**
+ * 追加小端序的32位整数（调用者已确保空间）
+ * @param writer Token写出器
+ * @param value 整数
+ */
+static void put_u32(TokenWriter *writer, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        put_char(writer, (char)(value >> (8 * i)));
+    }
+}
+
+/**
+ * 写出一条二进制记录
+ * @param writer Token写出器
+ * @param token Token
+ * @param line 行号
+ * @param column 列号
+ */
+static void write_binary(TokenWriter *writer, const Token *token, int line, int column) {
+    uint64_t value = 0;
+    if (token->type == TOKEN_INT_CONST) {
+        value = (uint64_t)token->value.int_value;
+    } else if (token->type == TOKEN_DOUBLE_CONST) {
+        memcpy(&value, &token->value.double_value, sizeof(value));
+    } else if (token->type == TOKEN_CHAR_CONST) {
+        value = (unsigned char)token->value.char_value;
+    }
+    
+    ensure_space(writer, 32);
+    put_char(writer, (char)token->type);
+    put_char(writer, 0);
+    put_char(writer, 0);
+    put_char(writer, 0);
+    put_u32(writer, token->offset);
+    put_u32(writer, (uint32_t)token->length);
+    put_u32(writer, (uint32_t)line);
+    put_u32(writer, (uint32_t)column);
+    put_u32(writer, 0);
+    put_u32(writer, (uint32_t)value);
+    put_u32(writer, (uint32_t)(value >> 32));
+    
+    put_bytes(writer, token->lexeme, token->length);
+    static const char padding[8] = {0};
+    put_bytes(writer, padding, (8 - token->length % 8) % 8);
+}
+
+/**
+ * 写出一个Token（包括EOF）
+ * @param writer Token写出器
+ * @param token Token
+ * @param line 行号
+ * @param column 列号
+ */
+void token_writer_write(TokenWriter *writer, const Token *token, int line, int column) {
+    if (writer->format == OUTPUT_BINARY) {
+        write_binary(writer, token, line, column);
+        return;
+    }
+    
+    const char *type = token_type_to_string(token->type);
+    bool json = writer->format == OUTPUT_JSONL;
+    ensure_space(writer, 128);
+    if (json) {
+        put_bytes(writer, "{\"type\":\"", 9);
+        put_bytes(writer, type, strlen(type));
+        put_bytes(writer, "\",\"line\":", 9);
+        put_int(writer, line);
+        put_bytes(writer, ",\"column\":", 10);
+        put_int(writer, column);
+        put_bytes(writer, ",\"offset\":", 10);
+        put_int(writer, token->offset);
+        put_bytes(writer, ",\"length\":", 10);
+        put_int(writer, (long long)token->length);
+        put_bytes(writer, ",\"lexeme\":\"", 11);
+        put_escaped(writer, token->lexeme, token->length, true);
+        put_bytes(writer, "\"", 1);
+        if (token->type == TOKEN_INT_CONST || token->type == TOKEN_DOUBLE_CONST ||
+            token->type == TOKEN_CHAR_CONST) {
+            put_bytes(writer, ",\"value\":", 9);
+            put_value(writer, token, true);
+        }
+        put_bytes(writer, "}\n", 2);
+    } else {
+        put_bytes(writer, type, strlen(type));
+        put_char(writer, '\t');
+        put_int(writer, line);
+        put_char(writer, '\t');
+        put_int(writer, column);
+        put_char(writer, '\t');
+        put_int(writer, token->offset);
+        put_char(writer, '\t');
+        put_int(writer, (long long)token->length);
+        put_char(writer, '\t');
+        put_escaped(writer, token->lexeme, token->length, false);
+        put_bytes(writer, "\t", 1);
+        put_value(writer, token, false);
+        put_bytes(writer, "\n", 1);
+    }
+}
+
+/**
+ * 写出剩余数据并释放Token写出器
+ * @param writer Token写出器
+ */
+void token_writer_free(TokenWriter *writer) {
+    token_writer_flush(writer);
+    free(writer->buffer);
+    writer->buffer = NULL;
+}
@@ -0,0 +1,54 @@
+/**
+ * token_output.h - 机器可读的Token输出头文件
+ *
+ * 供下游工具读取的Token输出格式，全部经过一个大的输出缓冲区写出，
+ * 整数由专用函数转换，不经过printf：
+ *
+ *   tsv    首行为列名，此后每行一个Token：
+ *          type  line  column  offset  length  lexeme  value
+ *          词素中的反斜杠、制表符、换行和回车分别转义为 \\ \t \n \r
+ *   jsonl  每行一个JSON对象：
+ *          {"type":"IDENTIFIER","line":1,"column":5,"offset":4,"length":4,"lexeme":"main"}
+ *          常量另有"value"字段（超出double范围的浮点常量为null），错误Token的lexeme为错误信息。
+ *          合法的UTF-8序列原样输出，其余非ASCII字节写成\u00XX，每行都是合法的JSON
+ *   binary 8字节文件头"C0TOKEN\1"，此后每个Token一条记录，所有整数为小端序：
+ *          u8 type  u8[3] 保留（0）  u32 offset  u32 length  u32 line  u32 column  u32 保留（0）
+ *          u64 value（INT_CONST为int64，DOUBLE_CONST为IEEE 754双精度位模式，
+ *          CHAR_CONST为字符值，其余为0）
+ *          记录头共32字节，之后紧跟length字节的词素（错误Token为错误信息），
+ *          再以0填充到8字节对齐。type取TokenType的数值，以EOF记录结束。
+ */
+
+#ifndef TOKEN_OUTPUT_H
+#define TOKEN_OUTPUT_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "token.h"
+
+#define TOKEN_WRITER_BUFFER_SIZE (1024 * 1024)  // 输出缓冲区大小
+
+/* 输出格式 */
+typedef enum {
+    OUTPUT_TEXT,            // 供人阅读的二元组形式（print_token）
+    OUTPUT_TSV,             // 制表符分隔
+    OUTPUT_JSONL,           // 每行一个JSON对象
+    OUTPUT_BINARY           // 定长记录头加词素
+} OutputFormat;
+
+/* Token写出器 */
+typedef struct {
+    FILE *out;              // 输出流
+    OutputFormat format;    // 输出格式
+    char *buffer;           // 输出缓冲区
+    size_t used;            // 缓冲区中待写出的字节数
+} TokenWriter;
+
+/* Token输出函数 */
+bool parse_output_format(const char *name, OutputFormat *format);
+void token_writer_init(TokenWriter *writer, FILE *out, OutputFormat format);
+void token_writer_write(TokenWriter *writer, const Token *token, int line, int column);
+void token_writer_flush(TokenWriter *writer);
+void token_writer_free(TokenWriter *writer);
+
+#endif /* TOKEN_OUTPUT_H */